@@ -0,0 +1,43 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/a3parameter.cpp" "CMakeFiles/asap.dir/src/a3parameter.cpp.o" "gcc" "CMakeFiles/asap.dir/src/a3parameter.cpp.o.d"
+  "/root/repo/src/asap3client.cpp" "CMakeFiles/asap.dir/src/asap3client.cpp.o" "gcc" "CMakeFiles/asap.dir/src/asap3client.cpp.o.d"
+  "/root/repo/src/asap3def.cpp" "CMakeFiles/asap.dir/src/asap3def.cpp.o" "gcc" "CMakeFiles/asap.dir/src/asap3def.cpp.o.d"
+  "/root/repo/src/asap3factory.cpp" "CMakeFiles/asap.dir/src/asap3factory.cpp.o" "gcc" "CMakeFiles/asap.dir/src/asap3factory.cpp.o.d"
+  "/root/repo/src/asap3helper.cpp" "CMakeFiles/asap.dir/src/asap3helper.cpp.o" "gcc" "CMakeFiles/asap.dir/src/asap3helper.cpp.o.d"
+  "/root/repo/src/calibrationcache.cpp" "CMakeFiles/asap.dir/src/calibrationcache.cpp.o" "gcc" "CMakeFiles/asap.dir/src/calibrationcache.cpp.o.d"
+  "/root/repo/src/calibrationshadow.cpp" "CMakeFiles/asap.dir/src/calibrationshadow.cpp.o" "gcc" "CMakeFiles/asap.dir/src/calibrationshadow.cpp.o.d"
+  "/root/repo/src/characteristic.cpp" "CMakeFiles/asap.dir/src/characteristic.cpp.o" "gcc" "CMakeFiles/asap.dir/src/characteristic.cpp.o.d"
+  "/root/repo/src/clientmetrics.cpp" "CMakeFiles/asap.dir/src/clientmetrics.cpp.o" "gcc" "CMakeFiles/asap.dir/src/clientmetrics.cpp.o.d"
+  "/root/repo/src/ctasap3client.cpp" "CMakeFiles/asap.dir/src/ctasap3client.cpp.o" "gcc" "CMakeFiles/asap.dir/src/ctasap3client.cpp.o.d"
+  "/root/repo/src/iclient.cpp" "CMakeFiles/asap.dir/src/iclient.cpp.o" "gcc" "CMakeFiles/asap.dir/src/iclient.cpp.o.d"
+  "/root/repo/src/irequest.cpp" "CMakeFiles/asap.dir/src/irequest.cpp.o" "gcc" "CMakeFiles/asap.dir/src/irequest.cpp.o.d"
+  "/root/repo/src/iresponse.cpp" "CMakeFiles/asap.dir/src/iresponse.cpp.o" "gcc" "CMakeFiles/asap.dir/src/iresponse.cpp.o.d"
+  "/root/repo/src/itelegram.cpp" "CMakeFiles/asap.dir/src/itelegram.cpp.o" "gcc" "CMakeFiles/asap.dir/src/itelegram.cpp.o.d"
+  "/root/repo/src/latencyhistogram.cpp" "CMakeFiles/asap.dir/src/latencyhistogram.cpp.o" "gcc" "CMakeFiles/asap.dir/src/latencyhistogram.cpp.o.d"
+  "/root/repo/src/metadatacache.cpp" "CMakeFiles/asap.dir/src/metadatacache.cpp.o" "gcc" "CMakeFiles/asap.dir/src/metadatacache.cpp.o.d"
+  "/root/repo/src/metricsexporter.cpp" "CMakeFiles/asap.dir/src/metricsexporter.cpp.o" "gcc" "CMakeFiles/asap.dir/src/metricsexporter.cpp.o.d"
+  "/root/repo/src/nameindex.cpp" "CMakeFiles/asap.dir/src/nameindex.cpp.o" "gcc" "CMakeFiles/asap.dir/src/nameindex.cpp.o.d"
+  "/root/repo/src/parametercatalog.cpp" "CMakeFiles/asap.dir/src/parametercatalog.cpp.o" "gcc" "CMakeFiles/asap.dir/src/parametercatalog.cpp.o.d"
+  "/root/repo/src/queryparameters.cpp" "CMakeFiles/asap.dir/src/queryparameters.cpp.o" "gcc" "CMakeFiles/asap.dir/src/queryparameters.cpp.o.d"
+  "/root/repo/src/searchindex.cpp" "CMakeFiles/asap.dir/src/searchindex.cpp.o" "gcc" "CMakeFiles/asap.dir/src/searchindex.cpp.o.d"
+  "/root/repo/src/sharedvalues.cpp" "CMakeFiles/asap.dir/src/sharedvalues.cpp.o" "gcc" "CMakeFiles/asap.dir/src/sharedvalues.cpp.o.d"
+  "/root/repo/src/tracering.cpp" "CMakeFiles/asap.dir/src/tracering.cpp.o" "gcc" "CMakeFiles/asap.dir/src/tracering.cpp.o.d"
+  "/root/repo/src/transport.cpp" "CMakeFiles/asap.dir/src/transport.cpp.o" "gcc" "CMakeFiles/asap.dir/src/transport.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/CMakeFiles/asapreader.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,57 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/asap.dir/src/a3parameter.cpp.o"
+  "CMakeFiles/asap.dir/src/a3parameter.cpp.o.d"
+  "CMakeFiles/asap.dir/src/asap3client.cpp.o"
+  "CMakeFiles/asap.dir/src/asap3client.cpp.o.d"
+  "CMakeFiles/asap.dir/src/asap3def.cpp.o"
+  "CMakeFiles/asap.dir/src/asap3def.cpp.o.d"
+  "CMakeFiles/asap.dir/src/asap3factory.cpp.o"
+  "CMakeFiles/asap.dir/src/asap3factory.cpp.o.d"
+  "CMakeFiles/asap.dir/src/asap3helper.cpp.o"
+  "CMakeFiles/asap.dir/src/asap3helper.cpp.o.d"
+  "CMakeFiles/asap.dir/src/calibrationcache.cpp.o"
+  "CMakeFiles/asap.dir/src/calibrationcache.cpp.o.d"
+  "CMakeFiles/asap.dir/src/calibrationshadow.cpp.o"
+  "CMakeFiles/asap.dir/src/calibrationshadow.cpp.o.d"
+  "CMakeFiles/asap.dir/src/characteristic.cpp.o"
+  "CMakeFiles/asap.dir/src/characteristic.cpp.o.d"
+  "CMakeFiles/asap.dir/src/clientmetrics.cpp.o"
+  "CMakeFiles/asap.dir/src/clientmetrics.cpp.o.d"
+  "CMakeFiles/asap.dir/src/ctasap3client.cpp.o"
+  "CMakeFiles/asap.dir/src/ctasap3client.cpp.o.d"
+  "CMakeFiles/asap.dir/src/iclient.cpp.o"
+  "CMakeFiles/asap.dir/src/iclient.cpp.o.d"
+  "CMakeFiles/asap.dir/src/irequest.cpp.o"
+  "CMakeFiles/asap.dir/src/irequest.cpp.o.d"
+  "CMakeFiles/asap.dir/src/iresponse.cpp.o"
+  "CMakeFiles/asap.dir/src/iresponse.cpp.o.d"
+  "CMakeFiles/asap.dir/src/itelegram.cpp.o"
+  "CMakeFiles/asap.dir/src/itelegram.cpp.o.d"
+  "CMakeFiles/asap.dir/src/latencyhistogram.cpp.o"
+  "CMakeFiles/asap.dir/src/latencyhistogram.cpp.o.d"
+  "CMakeFiles/asap.dir/src/metadatacache.cpp.o"
+  "CMakeFiles/asap.dir/src/metadatacache.cpp.o.d"
+  "CMakeFiles/asap.dir/src/metricsexporter.cpp.o"
+  "CMakeFiles/asap.dir/src/metricsexporter.cpp.o.d"
+  "CMakeFiles/asap.dir/src/nameindex.cpp.o"
+  "CMakeFiles/asap.dir/src/nameindex.cpp.o.d"
+  "CMakeFiles/asap.dir/src/parametercatalog.cpp.o"
+  "CMakeFiles/asap.dir/src/parametercatalog.cpp.o.d"
+  "CMakeFiles/asap.dir/src/queryparameters.cpp.o"
+  "CMakeFiles/asap.dir/src/queryparameters.cpp.o.d"
+  "CMakeFiles/asap.dir/src/searchindex.cpp.o"
+  "CMakeFiles/asap.dir/src/searchindex.cpp.o.d"
+  "CMakeFiles/asap.dir/src/sharedvalues.cpp.o"
+  "CMakeFiles/asap.dir/src/sharedvalues.cpp.o.d"
+  "CMakeFiles/asap.dir/src/tracering.cpp.o"
+  "CMakeFiles/asap.dir/src/tracering.cpp.o.d"
+  "CMakeFiles/asap.dir/src/transport.cpp.o"
+  "CMakeFiles/asap.dir/src/transport.cpp.o.d"
+  "libasap.a"
+  "libasap.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/asap.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/asapreader.dir/src/onlinetable.cpp.o"
+  "CMakeFiles/asapreader.dir/src/onlinetable.cpp.o.d"
+  "CMakeFiles/asapreader.dir/src/sharedregion.cpp.o"
+  "CMakeFiles/asapreader.dir/src/sharedregion.cpp.o.d"
+  "libasapreader.a"
+  "libasapreader.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/asapreader.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/util.dir/src/util.cpp.o"
+  "CMakeFiles/util.dir/src/util.cpp.o.d"
+  "libutil.a"
+  "libutil.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/util.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
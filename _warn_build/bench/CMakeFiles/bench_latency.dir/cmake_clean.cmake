@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_latency.dir/benchhelper.cpp.o"
+  "CMakeFiles/bench_latency.dir/benchhelper.cpp.o.d"
+  "CMakeFiles/bench_latency.dir/benchlatency.cpp.o"
+  "CMakeFiles/bench_latency.dir/benchlatency.cpp.o.d"
+  "bench_latency"
+  "bench_latency.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_latency.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_load.dir/benchhelper.cpp.o"
+  "CMakeFiles/bench_load.dir/benchhelper.cpp.o.d"
+  "CMakeFiles/bench_load.dir/benchload.cpp.o"
+  "CMakeFiles/bench_load.dir/benchload.cpp.o.d"
+  "bench_load"
+  "bench_load.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_load.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/proxy/proxymain.cpp" "proxy/CMakeFiles/asap3_proxy.dir/proxymain.cpp.o" "gcc" "proxy/CMakeFiles/asap3_proxy.dir/proxymain.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/proxy/CMakeFiles/asap_proxy.dir/DependInfo.cmake"
+  "/root/repo/_warn_build/CMakeFiles/asap.dir/DependInfo.cmake"
+  "/root/repo/_warn_build/CMakeFiles/asapreader.dir/DependInfo.cmake"
+  "/root/repo/_warn_build/_deps/utillib-build/CMakeFiles/util.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/asap3_proxy.dir/proxymain.cpp.o"
+  "CMakeFiles/asap3_proxy.dir/proxymain.cpp.o.d"
+  "asap3_proxy"
+  "asap3_proxy.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/asap3_proxy.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
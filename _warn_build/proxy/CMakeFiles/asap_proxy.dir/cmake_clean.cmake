@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/asap_proxy.dir/asap3proxy.cpp.o"
+  "CMakeFiles/asap_proxy.dir/asap3proxy.cpp.o.d"
+  "libasap_proxy.a"
+  "libasap_proxy.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/asap_proxy.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
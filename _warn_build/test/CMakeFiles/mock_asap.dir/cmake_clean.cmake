@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mock_asap.dir/mockserver.cpp.o"
+  "CMakeFiles/mock_asap.dir/mockserver.cpp.o.d"
+  "libmock_asap.a"
+  "libmock_asap.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mock_asap.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libmock_asap.a"
+)
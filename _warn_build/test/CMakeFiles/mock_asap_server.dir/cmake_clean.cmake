@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mock_asap_server.dir/mockservermain.cpp.o"
+  "CMakeFiles/mock_asap_server.dir/mockservermain.cpp.o.d"
+  "mock_asap_server"
+  "mock_asap_server.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mock_asap_server.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_asap.dir/test_client.cpp.o"
+  "CMakeFiles/test_asap.dir/test_client.cpp.o.d"
+  "test_asap"
+  "test_asap.pdb"
+  "test_asap[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_asap.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_warn_build/test/test_asap[1]_tests.cmake")
+  include("/root/repo/_warn_build/test/test_asap[1]_tests.cmake")
+else()
+  add_test(test_asap_NOT_BUILT test_asap_NOT_BUILT)
+endif()
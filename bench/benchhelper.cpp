@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "benchhelper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace asap3::bench {
+
+int64_t Percentile(std::vector<int64_t>& sample_list, double percentile) {
+  if (sample_list.empty()) {
+    return 0;
+  }
+  std::ranges::sort(sample_list);
+  const auto rank = static_cast<size_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(sample_list.size())));
+  const auto index = rank == 0 ? 0 : rank - 1;
+  return sample_list[std::min(index, sample_list.size() - 1)];
+}
+
+uint64_t ResidentSetSize() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters = {};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.WorkingSetSize;
+  }
+  return 0;
+#else
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  if (statm >> size >> resident) {
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+  return 0;
+#endif
+}
+
+double ProcessCpuTime() {
+#if defined(_WIN32)
+  FILETIME create_time;
+  FILETIME exit_time;
+  FILETIME kernel_time;
+  FILETIME user_time;
+  if (!GetProcessTimes(GetCurrentProcess(), &create_time, &exit_time,
+                       &kernel_time, &user_time)) {
+    return 0.0;
+  }
+  auto to_seconds = [](const FILETIME& time) {
+    ULARGE_INTEGER temp;
+    temp.LowPart = time.dwLowDateTime;
+    temp.HighPart = time.dwHighDateTime;
+    return static_cast<double>(temp.QuadPart) / 1.0E7;
+  };
+  return to_seconds(kernel_time) + to_seconds(user_time);
+#else
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  auto to_seconds = [](const timeval& time) {
+    return static_cast<double>(time.tv_sec) +
+           static_cast<double>(time.tv_usec) / 1.0E6;
+  };
+  return to_seconds(usage.ru_utime) + to_seconds(usage.ru_stime);
+#endif
+}
+
+}  // namespace asap3::bench
@@ -0,0 +1,21 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace asap3::bench {
+
+/// Returns the value at the percentile (0..100). Sorts the sample list.
+int64_t Percentile(std::vector<int64_t>& sample_list, double percentile);
+
+/// Current resident set size in bytes. Returns 0 if not supported.
+uint64_t ResidentSetSize();
+
+/// Process CPU time (user + system) in seconds.
+double ProcessCpuTime();
+
+}  // namespace asap3::bench
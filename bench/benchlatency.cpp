@@ -0,0 +1,195 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Round-trip latency with different TCP socket options. One client polls the
+ * online values in a closed loop against a loopback mock server, once for
+ * each option set. The same server is used for all option sets.
+ */
+
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asap/asap3factory.h"
+#include "benchhelper.h"
+#include "mockserver.h"
+
+using namespace boost::program_options;
+using namespace std::chrono;
+using namespace asap3;
+using namespace asap3::bench;
+
+namespace {
+
+const DataValueList kEmptyList;
+
+struct OptionSet {
+  std::string name;
+  SocketOptions options;
+};
+
+struct LatencyResult {
+  std::vector<int64_t> latency_list;  ///< Round-trip times in ns
+  double wall_time = 0.0;
+  uint64_t nof_failed = 0;
+};
+
+LatencyResult RunOptionSet(const OptionSet& option_set, uint16_t port,
+                           const A3ParameterList& parameter_list,
+                           size_t nof_warmup, size_t nof_polls) {
+  LatencyResult result;
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Name("LATENCY");
+  client->Port(port);
+  client->TcpOptions(option_set.options);
+  client->ParameterList(parameter_list);
+  client->Start();
+  client->WaitOnIdle();
+  client->StartSubscription(0);
+  client->WaitOnIdle();
+
+  result.latency_list.reserve(nof_polls);
+  const auto wall_start = steady_clock::now();
+  for (size_t poll = 0; poll < nof_warmup + nof_polls; ++poll) {
+    std::promise<bool> done;
+    auto future = done.get_future();
+    const auto start = steady_clock::now();
+    client->SendTelegram(
+        CommandCode::GET_ONLINE_VALUE, kEmptyList,
+        [&done](bool success, const ITelegram&) { done.set_value(success); });
+    const bool success = future.get();
+    const auto round_trip =
+        duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    if (poll < nof_warmup) {
+      continue;
+    }
+    if (success) {
+      result.latency_list.push_back(round_trip);
+    } else {
+      ++result.nof_failed;
+    }
+  }
+  result.wall_time = duration<double>(steady_clock::now() - wall_start).count();
+  client->Stop();
+  return result;
+}
+
+}  // namespace
+
+int main(int nof_arg, char* arg_list[]) {
+  options_description desc("ASAP3 socket option latency");
+  desc.add_options()("help,h", "Produce help message")(
+      "polls,n", value<size_t>()->default_value(10000),
+      "Number of polls per option set")(
+      "warmup", value<size_t>()->default_value(500),
+      "Polls before the measurement starts")(
+      "channels,m", value<size_t>()->default_value(10),
+      "Number of channels")(
+      "latency", value<int64_t>()->default_value(0),
+      "Mock server latency (us)")(
+      "busy-poll", value<int64_t>()->default_value(50),
+      "SO_BUSY_POLL time (us) in the busy poll set. 0 = skip the set")(
+      "csv", "Print one CSV result line per option set");
+
+  variables_map vm;
+  try {
+    store(parse_command_line(nof_arg, arg_list, desc), vm);
+    notify(vm);
+  } catch (const std::exception& err) {
+    std::cerr << err.what() << std::endl << desc << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (vm.count("help") > 0) {
+    std::cout << desc << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  const auto nof_polls = vm["polls"].as<size_t>();
+  const auto nof_warmup = vm["warmup"].as<size_t>();
+  const auto nof_channels = vm["channels"].as<size_t>();
+  const auto busy_poll = microseconds(vm["busy-poll"].as<int64_t>());
+  const bool csv = vm.count("csv") > 0;
+
+  std::vector<OptionSet> option_list;
+  {
+    OptionSet nagle;
+    nagle.name = "nagle";
+    nagle.options.no_delay = false;
+    option_list.push_back(nagle);
+
+    OptionSet no_delay;
+    no_delay.name = "nodelay";
+    option_list.push_back(no_delay);
+
+    OptionSet quick_ack;
+    quick_ack.name = "nodelay+quickack";
+    quick_ack.options.quick_ack = true;
+    option_list.push_back(quick_ack);
+
+    if (busy_poll.count() > 0) {
+      OptionSet busy = quick_ack;
+      busy.name = "nodelay+quickack+busypoll";
+      busy.options.busy_poll = busy_poll;
+      option_list.push_back(busy);
+    }
+  }
+
+  test::MockServer server;
+  server.CreateParameters(nof_channels);
+  server.Latency(microseconds(vm["latency"].as<int64_t>()));
+  if (!server.Start()) {
+    std::cerr << "Failed to start the mock server" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  A3ParameterList parameter_list;
+  for (size_t channel = 0; channel < nof_channels; ++channel) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(channel + 1));
+    parameter_list.push_back(parameter);
+  }
+
+  if (!csv) {
+    std::cout << std::left << std::setw(28) << "Options" << std::right
+              << std::setw(10) << "Polls/s" << std::setw(8) << "p50"
+              << std::setw(8) << "p99" << std::setw(8) << "p999"
+              << std::setw(8) << "Max" << std::setw(8) << "Failed"
+              << "  (us)" << std::endl;
+  }
+  for (const auto& option_set : option_list) {
+    auto result = RunOptionSet(option_set, server.Port(), parameter_list,
+                               nof_warmup, nof_polls);
+    const auto polls_s =
+        result.wall_time > 0.0
+            ? static_cast<double>(nof_warmup + nof_polls) / result.wall_time
+            : 0.0;
+    const auto p50 = Percentile(result.latency_list, 50.0) / 1000;
+    const auto p99 = Percentile(result.latency_list, 99.0) / 1000;
+    const auto p999 = Percentile(result.latency_list, 99.9) / 1000;
+    const auto max = Percentile(result.latency_list, 100.0) / 1000;
+    if (csv) {
+      std::cout << option_set.name << "," << std::fixed
+                << std::setprecision(1) << polls_s << "," << p50 << ","
+                << p99 << "," << p999 << "," << max << ","
+                << result.nof_failed << std::endl;
+    } else {
+      std::cout << std::left << std::setw(28) << option_set.name
+                << std::right << std::fixed << std::setprecision(0)
+                << std::setw(10) << polls_s << std::setw(8) << p50
+                << std::setw(8) << p99 << std::setw(8) << p999
+                << std::setw(8) << max << std::setw(8) << result.nof_failed
+                << std::endl;
+    }
+  }
+  server.Stop();
+  return EXIT_SUCCESS;
+}
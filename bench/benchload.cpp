@@ -0,0 +1,283 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Load generator. Starts N clients against a server, subscribes M channels
+ * on each client and polls the online values at a fixed rate. A local mock
+ * server is started in-process if no port is given. The local server can
+ * also be reached over a Unix domain socket or an in-process memory pipe.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "asap/asap3factory.h"
+#include "asap/latencyhistogram.h"
+#include "benchhelper.h"
+#include "mockserver.h"
+
+using namespace boost::program_options;
+using namespace std::chrono;
+using namespace asap3;
+using namespace asap3::bench;
+
+namespace {
+
+const DataValueList kEmptyList;
+
+struct BenchClient {
+  std::unique_ptr<IClient> client;
+  std::thread poll_thread;
+
+  std::mutex locker;
+  std::vector<int64_t> latency_list;  ///< Round-trip times in ns
+
+  std::atomic<uint64_t> nof_polls = 0;
+  std::atomic<uint64_t> nof_failed = 0;
+  std::atomic<uint64_t> in_flight = 0;
+};
+
+void PollThread(BenchClient& bench, double rate,
+                const std::atomic<bool>& stop) {
+  const bool closed_loop = rate <= 0.0;
+  const auto period = closed_loop
+                          ? nanoseconds(0)
+                          : duration_cast<nanoseconds>(duration<double>(1.0 / rate));
+  auto next = steady_clock::now();
+
+  while (!stop) {
+    if (closed_loop) {
+      // Send next poll when the previous is done.
+      const auto flight = bench.in_flight.load();
+      if (flight > 0) {
+        bench.in_flight.wait(flight);
+        continue;
+      }
+    } else {
+      next += period;
+      std::this_thread::sleep_until(next);
+    }
+
+    const auto start = steady_clock::now();
+    ++bench.in_flight;
+    bench.client->SendTelegram(
+        CommandCode::GET_ONLINE_VALUE, kEmptyList,
+        [&bench, start](bool success, const ITelegram&) {
+          const auto round_trip =
+              duration_cast<nanoseconds>(steady_clock::now() - start).count();
+          if (success) {
+            ++bench.nof_polls;
+            std::scoped_lock lock(bench.locker);
+            bench.latency_list.push_back(round_trip);
+          } else {
+            ++bench.nof_failed;
+          }
+          --bench.in_flight;
+          bench.in_flight.notify_all();
+        });
+  }
+}
+
+}  // namespace
+
+int main(int nof_arg, char* arg_list[]) {
+  options_description desc("ASAP3 load generator");
+  desc.add_options()("help,h", "Produce help message")(
+      "clients,c", value<size_t>()->default_value(4), "Number of clients")(
+      "channels,m", value<size_t>()->default_value(100),
+      "Number of channels per client")(
+      "rate,r", value<double>()->default_value(100.0),
+      "Poll rate per client (Hz). 0 = as fast as possible")(
+      "duration,d", value<double>()->default_value(5.0),
+      "Measurement time (s)")(
+      "host", value<std::string>()->default_value("127.0.0.1"),
+      "Server host")(
+      "port,p", value<uint16_t>()->default_value(0),
+      "Server port. 0 = start a local mock server")(
+      "transport,t", value<std::string>()->default_value("tcp"),
+      "Transport: tcp, unix or memory. Memory needs a local mock server")(
+      "address", value<std::string>()->default_value("asap3_bench"),
+      "Unix socket path or memory pipe name")(
+      "latency", value<int64_t>()->default_value(0),
+      "Mock server latency (us)")(
+      "jitter", value<int64_t>()->default_value(0),
+      "Mock server jitter (us)")("csv", "Print a single CSV result line");
+
+  variables_map vm;
+  try {
+    store(parse_command_line(nof_arg, arg_list, desc), vm);
+    notify(vm);
+  } catch (const std::exception& err) {
+    std::cerr << err.what() << std::endl << desc << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (vm.count("help") > 0) {
+    std::cout << desc << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  const auto nof_clients = vm["clients"].as<size_t>();
+  const auto nof_channels = vm["channels"].as<size_t>();
+  const auto rate = vm["rate"].as<double>();
+  const auto measure_time = vm["duration"].as<double>();
+  const bool csv = vm.count("csv") > 0;
+
+  const auto& transport = vm["transport"].as<std::string>();
+  TransportType transport_type = TransportType::Tcp;
+  if (transport == "unix") {
+    transport_type = TransportType::UnixSocket;
+  } else if (transport == "memory") {
+    transport_type = TransportType::MemoryPipe;
+  } else if (transport != "tcp") {
+    std::cerr << "Unknown transport: " << transport << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto& address = vm["address"].as<std::string>();
+
+  test::MockServer server;
+  uint16_t port = vm["port"].as<uint16_t>();
+  const bool local_server =
+      port == 0 || transport_type == TransportType::MemoryPipe;
+  if (local_server) {
+    server.Transport(transport_type);
+    server.Address(address);
+    server.CreateParameters(nof_channels);
+    server.Latency(microseconds(vm["latency"].as<int64_t>()));
+    server.Jitter(microseconds(vm["jitter"].as<int64_t>()));
+    if (!server.Start()) {
+      std::cerr << "Failed to start the mock server" << std::endl;
+      return EXIT_FAILURE;
+    }
+    port = server.Port();
+  }
+
+  A3ParameterList parameter_list;
+  for (size_t channel = 0; channel < nof_channels; ++channel) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(channel + 1));
+    parameter_list.push_back(parameter);
+  }
+
+  std::vector<std::unique_ptr<BenchClient>> bench_list;
+  for (size_t index = 0; index < nof_clients; ++index) {
+    auto bench = std::make_unique<BenchClient>();
+    bench->client =
+        Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+    bench->client->Name("BENCH" + std::to_string(index + 1));
+    bench->client->Host(vm["host"].as<std::string>());
+    bench->client->Port(port);
+    bench->client->Transport(transport_type);
+    bench->client->Address(address);
+    bench->client->ParameterList(parameter_list);
+    bench->client->Start();
+    bench_list.push_back(std::move(bench));
+  }
+
+  for (auto& bench : bench_list) {
+    bench->client->WaitOnIdle();
+    bench->client->StartSubscription(0);
+  }
+  for (auto& bench : bench_list) {
+    bench->client->WaitOnIdle();
+  }
+
+  std::atomic<bool> stop = false;
+  const auto rss_before = ResidentSetSize();
+  const auto cpu_start = ProcessCpuTime();
+  const auto wall_start = steady_clock::now();
+  for (auto& bench : bench_list) {
+    bench->poll_thread =
+        std::thread(PollThread, std::ref(*bench), rate, std::cref(stop));
+  }
+
+  std::this_thread::sleep_for(duration<double>(measure_time));
+  stop = true;
+  for (auto& bench : bench_list) {
+    bench->in_flight.notify_all();
+    if (bench->poll_thread.joinable()) {
+      bench->poll_thread.join();
+    }
+  }
+  for (auto& bench : bench_list) {
+    bench->client->WaitOnIdle();
+  }
+  const auto wall_time =
+      duration<double>(steady_clock::now() - wall_start).count();
+  const auto cpu_time = ProcessCpuTime() - cpu_start;
+  const auto rss_after = ResidentSetSize();
+
+  uint64_t nof_polls = 0;
+  uint64_t nof_failed = 0;
+  std::vector<int64_t> latency_list;
+  size_t nof_values = 0;
+  std::array<uint64_t, kNofLatencyStages> stage_p99 = {};
+  for (auto& bench : bench_list) {
+    nof_polls += bench->nof_polls;
+    nof_failed += bench->nof_failed;
+    latency_list.insert(latency_list.end(), bench->latency_list.begin(),
+                        bench->latency_list.end());
+    nof_values += bench->client->OnlineValues().size();
+    for (const auto& latency : bench->client->LatencySnapshot()) {
+      if (latency.cmd != CommandCode::GET_ONLINE_VALUE) {
+        continue;
+      }
+      for (size_t stage = 0; stage < kNofLatencyStages; ++stage) {
+        const auto& snapshot = latency.stage_list[stage];
+        stage_p99[stage] = std::max(stage_p99[stage], snapshot.Percentile(99));
+      }
+    }
+    bench->client->Stop();
+  }
+  server.Stop();
+
+  const auto telegrams_s = static_cast<double>(nof_polls) / wall_time;
+  const auto values_s =
+      static_cast<double>(nof_polls * nof_channels) / wall_time;
+  const auto cpu_client =
+      nof_clients > 0 ? 100.0 * cpu_time / wall_time / nof_clients : 0.0;
+  const auto p50 = Percentile(latency_list, 50.0) / 1000;
+  const auto p99 = Percentile(latency_list, 99.0) / 1000;
+  const auto p999 = Percentile(latency_list, 99.9) / 1000;
+
+  if (csv) {
+    std::cout << nof_clients << "," << nof_channels << "," << rate << ","
+              << std::fixed << std::setprecision(1) << telegrams_s << ","
+              << values_s << "," << cpu_client << "," << rss_after << ","
+              << p50 << "," << p99 << "," << p999 << "," << nof_failed
+              << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "Clients: " << nof_clients << ", Channels: " << nof_channels
+            << ", Rate: " << rate << " Hz, Time: " << wall_time << " s"
+            << std::endl;
+  std::cout << "Telegrams/s: " << telegrams_s << std::endl;
+  std::cout << "Values/s: " << values_s << " (Defined values: " << nof_values
+            << ")" << std::endl;
+  std::cout << "Failed Polls: " << nof_failed << std::endl;
+  std::cout << "CPU/Client: " << cpu_client << " %"
+            << (local_server ? " (including mock server)" : "")
+            << std::endl;
+  std::cout << "RSS: " << rss_after / 1024 << " kB (Before Polling: "
+            << rss_before / 1024 << " kB)" << std::endl;
+  std::cout << "Latency p50/p99/p999: " << p50 << "/" << p99 << "/" << p999
+            << " us" << std::endl;
+  std::cout << "Worst client p99 Queue/Server/Handle/Callback: "
+            << stage_p99[0] / 1000 << "/" << stage_p99[1] / 1000 << "/"
+            << stage_p99[2] / 1000 << "/" << stage_p99[3] / 1000 << " us"
+            << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -14,6 +14,7 @@ namespace asap3 {
 enum class Asap3ClientType : uint8_t {
   BasicAsap3Client = 0,
   QueryCtParameters = 1,
+  CtAsap3Client = 2,  ///< Enables the ComTest services
 };
 
 class Asap3Factory {
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asap/characteristic.h"
+
+namespace asap3 {
+
+struct CalPage {
+  uint16_t index = 0;
+  std::string name;
+  uint16_t properties = 0;
+};
+
+using CalPageList = std::vector<CalPage>;
+
+/** \brief Calibration pages, characteristic info and values per LUN.
+ *
+ * Each LUN (device) has its own page list, current page, info and values.
+ * The values are stored per calibration page. Values are removed when they
+ * are written, when the current page of the LUN changes and when the server
+ * reports STATUS_MEASURING_DATA_CHANGED. The generation is stepped on each
+ * invalidation, so a read that was sent before a write cannot store
+ * old values.
+ */
+class CalibrationCache {
+ public:
+  static constexpr uint16_t kUnknownPage = 0xFFFF;
+
+  void PageList(uint16_t lun, CalPageList page_list);
+  [[nodiscard]] CalPageList PageList(uint16_t lun) const;
+
+  /// Sets the current page. Returns true if the page was switched.
+  bool CurrentPage(uint16_t lun, uint16_t page);
+  [[nodiscard]] uint16_t CurrentPage(uint16_t lun) const;
+
+  void Info(uint16_t lun, const std::string& name,
+            const CharacteristicInfo& info);
+  [[nodiscard]] bool FindInfo(uint16_t lun, std::string_view name,
+                              CharacteristicInfo& info) const;
+
+  /// Stores the values for the current page. Ignored if anything has been
+  /// invalidated since the generation was fetched.
+  void Value(uint16_t lun,
+             std::shared_ptr<const Characteristic> characteristic,
+             uint64_t generation);
+  [[nodiscard]] std::shared_ptr<const Characteristic> Value(
+      uint16_t lun, std::string_view name) const;
+
+  [[nodiscard]] uint64_t Generation() const { return generation_; }
+
+  /// Removes the characteristic values on all pages of the LUN.
+  void Invalidate(uint16_t lun, std::string_view name);
+  /// Removes all values but keeps the info and page lists.
+  void InvalidateValues();
+  void Clear();
+
+  [[nodiscard]] uint64_t Hits() const { return hits_; }
+  [[nodiscard]] uint64_t Misses() const { return misses_; }
+
+ private:
+  using ValueList =
+      std::map<std::string, std::shared_ptr<const Characteristic>, std::less<>>;
+  struct LunCache {
+    CalPageList page_list;
+    uint16_t current_page = kUnknownPage;
+    std::map<std::string, CharacteristicInfo, std::less<>> info_list;
+    std::map<uint16_t, ValueList> page_value_list;
+  };
+
+  mutable std::mutex locker_;
+  std::map<uint16_t, LunCache> lun_list_;
+  std::atomic<uint64_t> generation_ = 0;
+  mutable std::atomic<uint64_t> hits_ = 0;
+  mutable std::atomic<uint64_t> misses_ = 0;
+};
+
+}  // namespace asap3
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asap/asap3def.h"
+#include "asap/characteristic.h"
+
+namespace asap3 {
+
+/// Changed cells [first, first + count) in the flat value array.
+struct CellRun {
+  size_t first = 0;
+  size_t count = 0;
+};
+
+using CellRunList = std::vector<CellRun>;
+
+/** \brief Client-side copy of the characteristic values in the server.
+ *
+ * The shadow is used to find the cells that actually changed, so only
+ * those are sent with WRITE_CELL_VALUES. The copies are updated on reads
+ * and writes. A characteristic is removed if a write fails, which forces a
+ * full write next time. Each LUN (device) has its own copies.
+ */
+class CalibrationShadow {
+ public:
+  /// Stores a copy of the values.
+  void Store(uint16_t lun, const Characteristic& characteristic);
+  void Store(uint16_t lun, const std::string& name, Mc3CharType type,
+             std::span<const uint16_t> dimension_list,
+             std::span<const float> value_list);
+
+  /// Compares the values with the shadow copy and then stores them. Returns
+  /// false if there is no copy to compare with, i.e. a full write is needed.
+  bool Update(uint16_t lun, const std::string& name, Mc3CharType type,
+              std::span<const uint16_t> dimension_list,
+              std::span<const float> value_list, size_t max_gap,
+              CellRunList& run_list);
+
+  [[nodiscard]] bool Contains(uint16_t lun, std::string_view name) const;
+  void Erase(uint16_t lun, std::string_view name);
+  /// Removes the copies of one LUN.
+  void Clear(uint16_t lun);
+  void Clear();
+  /// Number of copies on all LUNs.
+  [[nodiscard]] size_t Size() const;
+
+  /// Finds the changed cells. Runs with at most max_gap unchanged cells
+  /// between them are merged. Runs are split at each row of row_size cells.
+  [[nodiscard]] static CellRunList Diff(std::span<const float> previous,
+                                        std::span<const float> current,
+                                        size_t row_size, size_t max_gap);
+
+  /// Encoded size of a WRITE_CHARACTERISTIC frame.
+  [[nodiscard]] static size_t CharacteristicFrameSize(std::string_view name,
+                                                      size_t nof_dimensions,
+                                                      size_t nof_values);
+  /// Encoded size of a WRITE_CELL_VALUES frame.
+  [[nodiscard]] static size_t CellFrameSize(std::string_view name,
+                                            size_t nof_dimensions,
+                                            size_t nof_values);
+
+ private:
+  using ShadowList = std::map<std::string, Characteristic, std::less<>>;
+
+  mutable std::mutex locker_;
+  std::map<uint16_t, ShadowList> lun_list_;
+};
+
+}  // namespace asap3
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "asap/asap3def.h"
+#include "asap/tensorview.h"
+
+namespace asap3 {
+
+/** \brief Result of GET_CHARACTERISTIC_INFO. */
+struct CharacteristicInfo {
+  Mc3CharType type = Mc3CharType::VALUE;
+  float min = 0.0F;
+  float max = 0.0F;
+  float increment = 0.0F;  ///< Smallest step
+  std::vector<uint16_t> dimension_list;  ///< Empty for a VALUE
+};
+
+/** \brief Calibration object with contiguous values and axis vectors.
+ *
+ * The values are stored with the X index changing fastest, i.e. the index of
+ * a map value is x + y * x_dim. Curves, maps and cubes have one axis per
+ * dimension. Value blocks and single values have no axes. Use Tensor() for
+ * cubes and value blocks with more than 2 dimensions.
+ */
+class Characteristic {
+ public:
+  Characteristic() = default;
+  Characteristic(std::string name, Mc3CharType type,
+                 std::vector<uint16_t> dimension_list);
+
+  void Name(const std::string& name) { name_ = name; }
+  [[nodiscard]] const std::string& Name() const { return name_; }
+
+  [[nodiscard]] Mc3CharType Type() const { return type_; }
+
+  /// Changes type and size. Values and axes are reset to zero.
+  void Resize(Mc3CharType type, std::vector<uint16_t> dimension_list);
+  [[nodiscard]] const std::vector<uint16_t>& DimensionList() const {
+    return dimension_list_;
+  }
+  [[nodiscard]] size_t NofDimensions() const { return dimension_list_.size(); }
+  [[nodiscard]] size_t Dimension(size_t dimension) const {
+    return dimension < dimension_list_.size() ? dimension_list_[dimension] : 1;
+  }
+
+  [[nodiscard]] std::span<const float> Axis(size_t dimension) const;
+  [[nodiscard]] std::span<float> Axis(size_t dimension);
+  [[nodiscard]] size_t NofAxes() const { return axis_list_.size(); }
+
+  [[nodiscard]] std::span<const float> Values() const { return value_list_; }
+  [[nodiscard]] std::span<float> Values() { return value_list_; }
+  /// Copies the values. The size must match NofValues().
+  bool Values(std::span<const float> value_list);
+  [[nodiscard]] size_t NofValues() const { return value_list_.size(); }
+
+  [[nodiscard]] TensorView<float> Tensor() {
+    return {value_list_.data(), dimension_list_};
+  }
+  [[nodiscard]] TensorView<const float> Tensor() const {
+    return {value_list_.data(), dimension_list_};
+  }
+
+  [[nodiscard]] float& At(size_t x, size_t y = 0) {
+    return value_list_[x + y * Dimension(0)];
+  }
+  [[nodiscard]] float At(size_t x, size_t y = 0) const {
+    return value_list_[x + y * Dimension(0)];
+  }
+
+  /// Number of values for a type and its dimensions.
+  [[nodiscard]] static size_t NofValues(
+      std::span<const uint16_t> dimension_list);
+  /// True if the type has axis points, i.e. curves, maps and cubes.
+  [[nodiscard]] static bool HasAxes(Mc3CharType type);
+
+ private:
+  std::string name_;
+  Mc3CharType type_ = Mc3CharType::VALUE;
+  std::vector<uint16_t> dimension_list_;
+  std::vector<std::vector<float>> axis_list_;
+  std::vector<float> value_list_ = {0.0F};
+};
+
+}  // namespace asap3
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace asap3 {
+
+/** \brief Copy of the client transport and protocol counters. */
+struct MetricsSnapshot {
+  uint64_t frames_in = 0;          ///< Received response frames
+  uint64_t frames_out = 0;         ///< Transmitted request frames
+  uint64_t bytes_in = 0;           ///< Received bytes including length word
+  uint64_t bytes_out = 0;          ///< Transmitted bytes
+  uint64_t checksum_failures = 0;  ///< Responses with invalid checksum
+  uint64_t repeats = 0;            ///< STATUS_REPEAT_CMD resends
+  uint64_t not_processed = 0;      ///< STATUS_NOT_PROCESSED restarts
+  uint64_t error_responses = 0;    ///< STATUS_ERROR responses
+  uint64_t connects = 0;           ///< Successful connects
+  uint64_t reconnects = 0;         ///< Disconnect and retry
+  uint64_t deadlock_timeouts = 0;  ///< Body read timer expiries
+  uint64_t message_timeouts = 0;   ///< Requests without any response
+  uint64_t queue_depth = 0;        ///< Current number of queued telegrams
+  uint64_t queue_high_water = 0;   ///< Max number of queued telegrams
+  uint64_t setpoints_sent = 0;     ///< Set-point values sent
+  uint64_t setpoints_coalesced = 0;  ///< Set-points replaced before sent
+  uint64_t async_errors = 0;  ///< Errors on unacknowledged commands
+
+  /// Returns the counters in the Prometheus text exposition format.
+  [[nodiscard]] std::string ToPrometheus(const std::string& client) const;
+};
+
+/** \brief Per client counters.
+ *
+ * All counters are lock-free atomics and may be updated from any thread.
+ */
+struct ClientMetrics {
+  std::atomic<uint64_t> frames_in = 0;
+  std::atomic<uint64_t> frames_out = 0;
+  std::atomic<uint64_t> bytes_in = 0;
+  std::atomic<uint64_t> bytes_out = 0;
+  std::atomic<uint64_t> checksum_failures = 0;
+  std::atomic<uint64_t> repeats = 0;
+  std::atomic<uint64_t> not_processed = 0;
+  std::atomic<uint64_t> error_responses = 0;
+  std::atomic<uint64_t> connects = 0;
+  std::atomic<uint64_t> reconnects = 0;
+  std::atomic<uint64_t> deadlock_timeouts = 0;
+  std::atomic<uint64_t> message_timeouts = 0;
+  std::atomic<uint64_t> queue_depth = 0;
+  std::atomic<uint64_t> queue_high_water = 0;
+  std::atomic<uint64_t> setpoints_sent = 0;
+  std::atomic<uint64_t> setpoints_coalesced = 0;
+  std::atomic<uint64_t> async_errors = 0;
+
+  void QueuePut();
+  void QueueGet();
+  void QueueClear() { queue_depth = 0; }
+
+  [[nodiscard]] MetricsSnapshot Snapshot() const;
+};
+
+}  // namespace asap3
@@ -7,19 +7,69 @@
 #include <util/ilisten.h>
 #include <util/threadsafequeue.h>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "asap/a3parameter.h"
 #include "asap/asap3def.h"
+#include "asap/calibrationcache.h"
+#include "asap/calibrationshadow.h"
+#include "asap/characteristic.h"
+#include "asap/clientmetrics.h"
 #include "asap/itelegram.h"
+#include "asap/latencyhistogram.h"
+#include "asap/lookuptable.h"
+#include "asap/nameindex.h"
+#include "asap/parametercatalog.h"
+#include "asap/searchindex.h"
+#include "asap/onlinetable.h"
+#include "asap/sharedvalues.h"
+#include "asap/socketoptions.h"
+#include "asap/tracering.h"
 
 namespace asap3 {
 
+/// Connection used by the client. TCP uses the host and port, a Unix domain
+/// socket the path in Address() and a memory pipe the name in Address().
+/// Memory pipes only reach servers in the same process.
+enum class TransportType : uint8_t {
+  Tcp = 0,
+  UnixSocket = 1,
+  MemoryPipe = 2,
+};
+
 class IClient {
  public:
+  /// Called for each chunk of parameters as soon as it has been parsed.
+  using ParameterFunction =
+      std::function<void(const A3ParameterList& chunk, size_t nof_received,
+                         size_t nof_parameters)>;
+  using CharacteristicFunction =
+      std::function<void(bool success, const Characteristic& characteristic)>;
+  using CellValueFunction =
+      std::function<void(bool success, std::span<const float> value_list)>;
+  using CharacteristicInfoFunction =
+      std::function<void(bool success, const CharacteristicInfo& info)>;
+  using WriteFunction = std::function<void(bool success)>;
+  using CalPageFunction =
+      std::function<void(bool success, const CalPageList& page_list)>;
+  using CurrentPageFunction = std::function<void(bool success, uint16_t page)>;
+  using LookupTableFunction =
+      std::function<void(bool success, const LookupTableList& table_list)>;
+  using AsyncErrorFunction =
+      std::function<void(CommandCode cmd, uint16_t error_code,
+                         const std::string& error_text)>;
+
   IClient();
   virtual ~IClient();
 
@@ -35,6 +85,19 @@ class IClient {
   void Port(uint16_t port) { port_ = port; }
   [[nodiscard]] uint16_t Port() const { return port_; }
 
+  void Transport(TransportType type) { transport_type_ = type; }
+  [[nodiscard]] TransportType Transport() const { return transport_type_; }
+
+  /// Socket path or pipe name. Not used by TCP.
+  void Address(const std::string& address) { address_ = address; }
+  [[nodiscard]] const std::string& Address() const { return address_; }
+
+  /// Set before start. Used on each connect.
+  void TcpOptions(const SocketOptions& options) { tcp_options_ = options; }
+  [[nodiscard]] const SocketOptions& TcpOptions() const {
+    return tcp_options_;
+  }
+
   void Version(uint16_t version) { version_ = version; }
   [[nodiscard]] uint16_t Version() const { return version_; }
 
@@ -42,13 +105,66 @@ class IClient {
   [[nodiscard]] uint16_t RemoteVersion() const { return remote_version_; }
 
   [[nodiscard]] ServiceList AvailableServices() const;
-  [[nodiscard]] bool HasService(const std::string& service) const;
+  [[nodiscard]] bool HasService(std::string_view service) const;
+  /// Services matching a wildcard pattern ('*' and '?').
+  [[nodiscard]] ServiceList SearchServices(std::string_view pattern) const;
 
+  /// Sets the parameters to acquire. Doesn't change the Catalog().
   void ParameterList(const A3ParameterList& parameter_list);
   [[nodiscard]] const A3ParameterList& ParameterList() {
     return parameter_list_;
   }
-  void ClearParameterList() { parameter_list_.clear(); }
+  void ClearParameterList() {
+    std::scoped_lock lock(value_locker_);
+    parameter_list_.clear();
+  }
+
+  /// Immutable copy of the discovered parameters. It can be shared between
+  /// clients that are connected to the same server.
+  [[nodiscard]] ParameterCatalogPtr Catalog() const;
+  void Catalog(ParameterCatalogPtr catalog);
+
+  void OnParameters(ParameterFunction function) {
+    parameter_function_ = std::move(function);
+  }
+
+  /// Also discover the ComTest signals. Default is parameters only.
+  void DiscoverSignals(bool discover) { discover_signals_ = discover; }
+  [[nodiscard]] bool DiscoverSignals() const { return discover_signals_; }
+  [[nodiscard]] const A3ParameterList& SignalList() const {
+    return signal_list_;
+  }
+  [[nodiscard]] ParameterCatalogPtr SignalCatalog() const;
+  void OnSignals(ParameterFunction function) {
+    signal_function_ = std::move(function);
+  }
+  /// If false, Start() returns before the parameter discovery is done.
+  void BlockingStart(bool blocking) { blocking_start_ = blocking; }
+  [[nodiscard]] bool BlockingStart() const { return blocking_start_; }
+
+  /// Number of parameters in each configuration request.
+  void DiscoveryChunkSize(size_t size) { discovery_chunk_size_ = size; }
+  [[nodiscard]] size_t DiscoveryChunkSize() const {
+    return discovery_chunk_size_;
+  }
+
+  /// Max number of configuration requests in the send queue.
+  void DiscoveryWindow(size_t window) { discovery_window_ = window; }
+  [[nodiscard]] size_t DiscoveryWindow() const { return discovery_window_; }
+
+  /// True when all parameter configurations have been received.
+  [[nodiscard]] bool IsDiscovered() const { return discovered_; }
+
+  /// Stores the discovered services and parameters in this file. The file is
+  /// used instead of a new discovery if the server configuration is unchanged.
+  void MetadataCacheFile(const std::string& filename) {
+    metadata_cache_file_ = filename;
+  }
+  [[nodiscard]] const std::string& MetadataCacheFile() const {
+    return metadata_cache_file_;
+  }
+  /// True if the last discovery was loaded from the cache file.
+  [[nodiscard]] bool IsMetadataCached() const { return metadata_cached_; }
 
   virtual bool Start() = 0;
   virtual bool Stop() = 0;
@@ -60,21 +176,194 @@ class IClient {
   void SendTelegram(CommandCode cmd, const std::vector<DataValue>& data_list);
   void SendTelegram(CommandCode cmd, const std::vector<DataValue>& data_list,
                     ITelegram::OnCompleteFunction on_complete_function);
+  /// Returns false if the request doesn't fit in one frame.
+  bool SendTelegram(std::unique_ptr<IRequest> request,
+                    ITelegram::OnCompleteFunction on_complete_function);
+
+  void GetCharacteristicInfo(uint16_t lun, const std::string& name,
+                             CharacteristicInfoFunction on_info);
+  void ReadCharacteristic(uint16_t lun, const std::string& name,
+                          CharacteristicFunction on_read);
+  /// Writes all values in one frame. The axes are not written.
+  bool WriteCharacteristic(uint16_t lun, const Characteristic& characteristic,
+                           ITelegram::OnCompleteFunction on_complete = {});
+  bool WriteCharacteristic(uint16_t lun, const std::string& name,
+                           Mc3CharType type,
+                           std::span<const uint16_t> dimension_list,
+                           std::span<const float> value_list,
+                           ITelegram::OnCompleteFunction on_complete = {});
+  /// Reads a block of cells. The start and count lists have one item per
+  /// dimension. Returns false if the lists don't match or the request
+  /// couldn't be sent. The function is then not called.
+  bool ReadCellValues(uint16_t lun, const std::string& name,
+                      std::span<const uint16_t> start_list,
+                      std::span<const uint16_t> count_list,
+                      CellValueFunction on_read);
+  bool WriteCellValues(uint16_t lun, const std::string& name,
+                       std::span<const uint16_t> start_list,
+                       std::span<const uint16_t> count_list,
+                       std::span<const float> value_list,
+                       ITelegram::OnCompleteFunction on_complete = {});
+  /// Reads the cells of a view, e.g. a row of a map or a plane of a cube.
+  /// The values are copied into the view, so its storage must be kept until
+  /// the function is called.
+  bool ReadCellValues(uint16_t lun, const std::string& name,
+                      TensorView<float> view, WriteFunction on_read);
+  bool WriteCellValues(uint16_t lun, const std::string& name,
+                       TensorView<const float> view,
+                       ITelegram::OnCompleteFunction on_complete = {});
+
+  /// Writes only the cells that differ from the shadow copy. One
+  /// WRITE_CHARACTERISTIC or a few WRITE_CELL_VALUES are sent, whichever
+  /// is smaller. The function is called when all frames are done.
+  bool UpdateCharacteristic(uint16_t lun, const Characteristic& characteristic,
+                            WriteFunction on_write = {});
+  bool UpdateCharacteristic(uint16_t lun, const std::string& name,
+                            Mc3CharType type,
+                            std::span<const uint16_t> dimension_list,
+                            std::span<const float> value_list,
+                            WriteFunction on_write = {});
+  [[nodiscard]] CalibrationShadow& Shadow() { return shadow_; }
+
+  void GetCalPageInfo(uint16_t lun, CalPageFunction on_info);
+  /// A new page invalidates the cached values and the shadow copies.
+  void GetCurrentCalPage(uint16_t lun, CurrentPageFunction on_page);
+
+  /// Serves repeated info and characteristic reads from the calibration
+  /// cache. The function is then called directly. Default is on.
+  void CacheCalibration(bool cache) { cache_calibration_ = cache; }
+  [[nodiscard]] bool CacheCalibration() const { return cache_calibration_; }
+  [[nodiscard]] CalibrationCache& CalCache() { return cal_cache_; }
+
+  /// EV2 lookup tables. A batch first resolves unknown names with
+  /// SELECT_LOOKUP_TABLE_EV2 and then queues all its requests at once. The
+  /// function is called once, when the whole batch is done.
+  void SelectLookupTables(uint16_t lun,
+                          const std::vector<std::string>& name_list,
+                          LookupTableFunction on_done);
+  void GetLookupTables(uint16_t lun, const std::vector<std::string>& name_list,
+                       LookupTableFunction on_done);
+  /// The value lists must match the table sizes.
+  void PutLookupTables(uint16_t lun, LookupTableList table_list,
+                       LookupTableFunction on_done = {});
+  void IncreaseLookupTables(uint16_t lun,
+                            const LookupTableIncreaseList& increase_list,
+                            LookupTableFunction on_done = {});
+  /// Forgets the selected table addresses.
+  void ClearLookupTables();
+  /// Forgets the selected table addresses of one LUN.
+  void ClearLookupTables(uint16_t lun);
 
   virtual bool StartSubscription(uint16_t scan_rate);
   virtual bool StopSubscription();
   [[nodiscard]] bool IsScanning() const;
+  [[nodiscard]] DataValueList OnlineValues() const;
+
+  /// Set-points. A value that hasn't been sent yet is replaced by the new
+  /// value, so only the latest value per parameter is sent. The set-point
+  /// list is defined by StartSubscription(). Returns false if the name isn't
+  /// a set-point.
+  bool SetPointValue(std::string_view name, float value);
+  /// The index is the A3Parameter::ValueIndex() of the set-point.
+  bool SetPointValue(size_t index, float value);
+  [[nodiscard]] DataValueList OutputValues() const;
+  /// Sends the changed set-points, grouped by LUN. Nothing is sent while the
+  /// previous flush is outstanding. Values in a failed frame are sent again
+  /// by the next flush. Returns the number of values sent.
+  size_t FlushSetPoints();
+  /// Sends the set-points in SET_PARAMETER_EV2 frames instead of one
+  /// SET_PARAMETER per value. Default is on.
+  void BatchSetPoints(bool batch) { batch_setpoints_ = batch; }
+  [[nodiscard]] bool BatchSetPoints() const { return batch_setpoints_; }
+  /// Flushes the set-points with this period while connected. Zero (default)
+  /// means that the application calls FlushSetPoints().
+  void SetPointPeriod(std::chrono::microseconds period) {
+    setpoint_period_ = period;
+  }
+  [[nodiscard]] std::chrono::microseconds SetPointPeriod() const {
+    return setpoint_period_;
+  }
+
+  /// Reads the online values from the shared memory that the server names
+  /// in the ComTest "Get Share Memory Name" service. TCP is still used for
+  /// everything else. Default is off.
+  void UseSharedMemory(bool use) { use_shared_memory_ = use; }
+  [[nodiscard]] bool UseSharedMemory() const { return use_shared_memory_; }
+  /// Maps a shared memory value table. Normally called by the client.
+  bool OpenSharedValues(const std::string& name);
+  void CloseSharedValues();
+  [[nodiscard]] bool IsSharedMemory() const;
+  /// Updates the online values from shared memory without any request.
+  /// Returns false if no table is mapped or if it doesn't match the
+  /// subscription. Poll with GET_ONLINE_VALUE instead in that case.
+  bool ReadSharedValues();
+
+  /// Publishes the online values and their parameters in a shared memory
+  /// table with this name. Other processes read it with OnlineTableReader.
+  /// Empty (default) means no export. Set it before the subscription starts.
+  void ExportName(const std::string& name);
+  [[nodiscard]] std::string ExportName() const;
+  /// Max number of exported parameters. Default is 4096.
+  void ExportCapacity(size_t capacity) { export_capacity_ = capacity; }
+  [[nodiscard]] size_t ExportCapacity() const { return export_capacity_; }
+
+  /// Commands that the server doesn't answer, e.g. SET_PARAMETER when the
+  /// ComTest "Disable SetValue Ack" service is active. They are sent without
+  /// waiting on a response. The list is cleared on each connect.
+  void Unacknowledged(CommandCode cmd, bool unacknowledged);
+  [[nodiscard]] bool Unacknowledged(CommandCode cmd) const;
+  void ClearUnacknowledged();
+  /// Called for error responses on unacknowledged commands.
+  void OnAsyncError(AsyncErrorFunction function) {
+    async_error_function_ = std::move(function);
+  }
 
   void SetOnlineData(const std::vector<uint8_t>& body, size_t offset);
   void DefineUserDefinedData(const std::vector<uint8_t>& body, size_t offset);
   void SetUserDefinedData(const std::vector<uint8_t>& body, size_t offset);
 
+  /// Returns the latency histograms for all commands that have been sent.
+  [[nodiscard]] CommandLatencyList LatencySnapshot() const;
+  void ResetLatency();
+
+  [[nodiscard]] MetricsSnapshot Metrics() const { return metrics_.Snapshot(); }
+
+  /// Periodically writes the metrics (Prometheus format) to this file.
+  void MetricsFile(const std::string& filename) { metrics_file_ = filename; }
+  [[nodiscard]] const std::string& MetricsFile() const {
+    return metrics_file_;
+  }
+
+  /// Serves the metrics (Prometheus format) on this local socket.
+  void MetricsSocket(const std::string& name) { metrics_socket_ = name; }
+  [[nodiscard]] const std::string& MetricsSocket() const {
+    return metrics_socket_;
+  }
+
+  void MetricsPeriod(std::chrono::milliseconds period) {
+    metrics_period_ = period;
+  }
+  [[nodiscard]] std::chrono::milliseconds MetricsPeriod() const {
+    return metrics_period_;
+  }
+
+  /// Stores all raw frames in the trace ring. Listen level 3 always traces.
+  void Trace(bool trace) { trace_ = trace; }
+  [[nodiscard]] bool Trace() const { return trace_; }
+  void TraceCapacity(size_t capacity) { trace_ring_.Capacity(capacity); }
+  [[nodiscard]] std::vector<TraceRecord> TraceSnapshot() const {
+    return trace_ring_.Snapshot();
+  }
+
  protected:
   using TelegramQueue = util::log::ThreadSafeQueue<ITelegram>;
   TelegramQueue telegram_queue_;
 
   std::string host_ = "127.0.0.1";
   uint16_t port_ = 22222;
+  TransportType transport_type_ = TransportType::Tcp;
+  std::string address_;
+  SocketOptions tcp_options_;
 
   std::string name_;
   uint16_t version_ = 3 * 256 + 0;  ///< Version is 3.0
@@ -88,18 +377,117 @@ class IClient {
   mutable std::mutex value_locker_;
   DataValueList user_defined_list_;  ///< User defined list (Name, type, value)
   ServiceList service_list_;  ///< List of available services in the server
+  NameIndex service_index_;   ///< Index into the service list
+  SearchIndex service_search_;
   A3ParameterList parameter_list_;   ///< Requested parameter list
+  ParameterCatalogPtr catalog_;      ///< Shared and immutable parameter list
+  ParameterFunction parameter_function_;
+  A3ParameterList signal_list_;  ///< ComTest signals
+  ParameterCatalogPtr signal_catalog_;
+  ParameterFunction signal_function_;
+  bool discover_signals_ = false;
+  bool blocking_start_ = true;
+  size_t discovery_chunk_size_ = 50;
+  size_t discovery_window_ = 4;
+  std::atomic<bool> discovered_ = false;
+  std::string metadata_cache_file_;
+  std::atomic<bool> metadata_cached_ = false;
   DataValueList online_value_list_;  ///< Current subscription (read) values
   DataValueList output_value_list_;  ///< Set-point value list
+  NameIndex setpoint_index_;         ///< Index into the set-point list
+  std::vector<float> setpoint_value_list_;  ///< Latest set-point values
+  std::vector<uint16_t> setpoint_lun_list_;  ///< LUN of each set-point
+  std::vector<uint8_t> setpoint_dirty_list_;  ///< 1 if not sent yet
+  std::vector<size_t> setpoint_pending_list_;  ///< Changed, in write order
+  std::vector<uint8_t> setpoint_sent_list_;  ///< 1 while a frame is in flight
+  /// Changed with value_locker_ held.
+  std::atomic<size_t> setpoint_in_flight_ = 0;
+  /// Stepped when queued frames are dropped. Protected by value_locker_.
+  uint64_t setpoint_epoch_ = 0;
+  std::atomic<bool> batch_setpoints_ = true;
+  std::chrono::microseconds setpoint_period_ = {};
+  std::array<std::atomic<bool>, 256> unacknowledged_list_ = {};
+  AsyncErrorFunction async_error_function_;
+  std::atomic<bool> use_shared_memory_ = false;
+  /// Mapped value table. Protected by value_locker_.
+  std::shared_ptr<SharedValueReader> shared_reader_;
+  /// Exported online table. Protected by value_locker_.
+  std::string export_name_;
+  std::atomic<size_t> export_capacity_ = 4096;
+  std::unique_ptr<OnlineTableWriter> export_table_;
+  std::vector<double> export_value_list_;
+
+  ClientMetrics metrics_;
+  std::string metrics_file_;
+  std::string metrics_socket_;
+  std::chrono::milliseconds metrics_period_ = std::chrono::seconds(10);
+
+  std::atomic<bool> trace_ = false;
+  TraceRing trace_ring_;
+
+  CalibrationShadow shadow_;
+  CalibrationCache cal_cache_;
+  std::atomic<bool> cache_calibration_ = true;
+  /// Selected lookup tables without values, per LUN. Protected by
+  /// value_locker_.
+  std::map<uint16_t, std::map<std::string, LookupTable, std::less<>>>
+      lookup_table_list_;
 
   virtual bool HandleTelegram(ITelegram& telegram);
   [[nodiscard]] bool IsSubscriptionInitialized() const;
+  void DefineValueLists();
+  /// Drops the cached calibration values, the shadow and the lookup table
+  /// addresses when the server reports STATUS_MEASURING_DATA_CHANGED.
+  void InvalidateCalibration();
+  /// Completes a set-point frame. A failed frame is marked as not sent.
+  void OnSetPointsSent(uint64_t epoch, const std::vector<size_t>& index_list,
+                       bool success);
+  /// Marks the set-points of dropped frames as not sent. Called when the
+  /// telegram queue is cleared, as the dropped frames never complete.
+  void ResetSetPoints();
+  void BuildCatalog();
 
   void SetServiceList(const DataValueList& data_list);
+  void SetServiceList(ServiceList service_list);
   void SetServiceInfo(const std::string& service, const std::string& info);
 
   void ListenRequest(const IRequest& request);
   void ListenResponse(const IResponse& response);
+  [[nodiscard]] bool IsTracing() const;
+  void ListenTrace();
+
+  void RecordLatency(const ITelegram& telegram);
+
+ private:
+  struct LookupBatch;
+
+  bool SendCharacteristic(uint16_t lun, const std::string& name,
+                          Mc3CharType type,
+                          std::span<const uint16_t> dimension_list,
+                          std::span<const float> value_list,
+                          ITelegram::OnCompleteFunction on_complete);
+  bool SendCellValues(uint16_t lun, const std::string& name,
+                      std::span<const uint16_t> start_list,
+                      std::span<const uint16_t> count_list,
+                      std::span<const float> value_list,
+                      ITelegram::OnCompleteFunction on_complete);
+  void SendLookupBatch(uint16_t lun, std::shared_ptr<LookupBatch> batch);
+  void SendLookupRequests(uint16_t lun, std::shared_ptr<LookupBatch> batch);
+  static void LookupDone(LookupBatch& batch);
+
+  /// Called with value_locker_ held.
+  void ExportParameters();
+  void ExportValues();
+
+  struct LatencySet {
+    std::array<LatencyHistogram, kNofLatencyStages> stage_list;
+  };
+  /// Indexed by command code. Created on first use and never removed.
+  std::array<std::atomic<LatencySet*>, 256> latency_list_ = {};
+  mutable std::mutex latency_locker_;
+  std::vector<std::unique_ptr<LatencySet>> latency_owner_list_;
+
+  LatencySet& GetLatencySet(CommandCode cmd);
 };
 
 }  // namespace asap3
@@ -5,6 +5,7 @@
 
 #pragma once
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "asap/asap3def.h"
@@ -24,11 +25,23 @@ class IRequest {
   template <typename T>
   T GetData(size_t index) const;
 
+  /// Raw bytes after the data list, e.g. bulk value arrays.
+  void Payload(std::vector<uint8_t> payload) { payload_ = std::move(payload); }
+  [[nodiscard]] const std::vector<uint8_t>& Payload() const {
+    return payload_;
+  }
+
+  /// The response keeps its undecoded frame, e.g. when a proxy forwards it.
+  void KeepRawResponse(bool keep) { keep_raw_response_ = keep; }
+  [[nodiscard]] bool KeepRawResponse() const { return keep_raw_response_; }
+
   void CreateBody(std::vector<uint8_t>& body) const;
 
  protected:
   uint16_t cmd_ = 0;
   DataValueList data_list_;
+  std::vector<uint8_t> payload_;
+  bool keep_raw_response_ = false;
 };
 
 template <typename T>
@@ -6,10 +6,12 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "asap/asap3def.h"
+#include "asap/characteristic.h"
 
 namespace asap3 {
 
@@ -38,12 +40,36 @@ class IResponse {
   void Sum(uint16_t sum) { sum_ = sum; }
   [[nodiscard]] uint16_t Sum() const { return sum_; }
 
+  [[nodiscard]] bool InvalidChecksum() const { return invalid_checksum_; }
+
   void CreateBody(std::vector<uint8_t>& body);
 
+  void DataList(const DataValueList& data_list) { data_list_ = data_list; }
   [[nodiscard]] const DataValueList& DataList() const { return data_list_; }
   template <typename T>
   T GetData(size_t index) const;
 
+  /// Raw bytes after the data list, e.g. bulk value arrays.
+  void Payload(std::vector<uint8_t> payload) { payload_ = std::move(payload); }
+  [[nodiscard]] const std::vector<uint8_t>& Payload() const {
+    return payload_;
+  }
+
+  /// Frame without the length bytes. Only kept if the request asked for it.
+  void RawBody(std::vector<uint8_t> body) { raw_body_ = std::move(body); }
+  [[nodiscard]] const std::vector<uint8_t>& RawBody() const {
+    return raw_body_;
+  }
+
+  /// Decoded READ_CHARACTERISTIC response. The name is not included.
+  [[nodiscard]] std::shared_ptr<Characteristic> CharacteristicValue() const {
+    return characteristic_;
+  }
+  /// Decoded READ_CELL_VALUES and GET_LOOKUP_TABLE_EV2 values.
+  [[nodiscard]] const std::vector<float>& ValueArray() const {
+    return value_array_;
+  }
+
  protected:
   IClient* client_ = nullptr;
   uint16_t length_ = 0;
@@ -51,6 +77,10 @@ class IResponse {
   uint16_t status_ = 0;
   uint16_t sum_ = 0;
   DataValueList data_list_;
+  std::vector<uint8_t> payload_;
+  std::shared_ptr<Characteristic> characteristic_;
+  std::vector<float> value_array_;
+  std::vector<uint8_t> raw_body_;
   bool invalid_checksum_ =
       false;  ///< Used as invalid response message indicator
 
@@ -61,6 +91,12 @@ class IResponse {
                                    size_t offset);
   void QueryAvailableServicesToDataList(const std::vector<uint8_t>& body,
                                         size_t offset);
+  void ReadCharacteristicToDataList(const std::vector<uint8_t>& body,
+                                    size_t offset);
+  void ReadCellValuesToDataList(const std::vector<uint8_t>& body,
+                                size_t offset);
+  void GetLookupTableToDataList(const std::vector<uint8_t>& body,
+                                size_t offset);
 };
 
 template <typename T>
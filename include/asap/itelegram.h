@@ -4,6 +4,7 @@
  */
 
 #pragma once
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -16,11 +17,13 @@ class ITelegram {
  public:
   using OnCompleteFunction =
       std::function<void(bool success, const ITelegram& telegram)>;
+  using TimePoint = std::chrono::steady_clock::time_point;
 
   ITelegram() = default;
   ITelegram(CommandCode cmd, const DataValueList& data_list);
   ITelegram(CommandCode cmd, const DataValueList& data_list,
             OnCompleteFunction on_complete);
+  ITelegram(std::unique_ptr<IRequest> request, OnCompleteFunction on_complete);
 
   [[nodiscard]] const IRequest* Request() const { return request_.get(); }
   [[nodiscard]] const IResponse* Response() const { return response_.get(); }
@@ -31,10 +34,38 @@ class ITelegram {
 
   void OnComplete(bool success);
 
+  void EnqueueTime(TimePoint time) { enqueue_time_ = time; }
+  [[nodiscard]] TimePoint EnqueueTime() const { return enqueue_time_; }
+
+  void SendTime(TimePoint time) { send_time_ = time; }
+  [[nodiscard]] TimePoint SendTime() const { return send_time_; }
+
+  void FirstByteTime(TimePoint time) { first_byte_time_ = time; }
+  [[nodiscard]] TimePoint FirstByteTime() const { return first_byte_time_; }
+
+  void ReceiveTime(TimePoint time) { receive_time_ = time; }
+  [[nodiscard]] TimePoint ReceiveTime() const { return receive_time_; }
+
+  /// Time when the telegram was handled, i.e. just before the callback.
+  [[nodiscard]] TimePoint CompleteTime() const { return complete_time_; }
+  [[nodiscard]] std::chrono::nanoseconds CallbackTime() const {
+    return callback_time_;
+  }
+  [[nodiscard]] bool HasCallback() const {
+    return static_cast<bool>(on_complete_);
+  }
+
  protected:
   std::unique_ptr<IRequest> request_;
   std::unique_ptr<IResponse> response_;
   OnCompleteFunction on_complete_;
+
+  TimePoint enqueue_time_ = {};
+  TimePoint send_time_ = {};
+  TimePoint first_byte_time_ = {};
+  TimePoint receive_time_ = {};
+  TimePoint complete_time_ = {};
+  std::chrono::nanoseconds callback_time_ = {};
 };
 
 }  // namespace asap3
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "asap/asap3def.h"
+
+namespace asap3 {
+
+enum class LatencyStage : uint8_t {
+  QueueTime = 0,     ///< Telegram enqueued to request sent
+  ServerTime = 1,    ///< Request sent to first response byte
+  HandleTime = 2,    ///< Response received to telegram handled
+  CallbackTime = 3,  ///< Duration of the completion callback
+};
+
+constexpr size_t kNofLatencyStages = 4;
+
+/** \brief Copy of a latency histogram.
+ *
+ * Values are stored in nanoseconds in log-linear buckets with 16 sub-buckets
+ * per power of two, i.e. a resolution of about 6 %.
+ */
+class HistogramSnapshot {
+ public:
+  [[nodiscard]] uint64_t Count() const { return count_; }
+  [[nodiscard]] uint64_t Min() const { return count_ > 0 ? min_ : 0; }
+  [[nodiscard]] uint64_t Max() const { return max_; }
+  [[nodiscard]] uint64_t Mean() const {
+    return count_ > 0 ? sum_ / count_ : 0;
+  }
+  /// Returns the value (ns) at the percentile (0..100).
+  [[nodiscard]] uint64_t Percentile(double percentile) const;
+  [[nodiscard]] const std::vector<uint64_t>& Buckets() const {
+    return bucket_list_;
+  }
+
+ private:
+  friend class LatencyHistogram;
+  uint64_t count_ = 0;
+  uint64_t min_ = 0;
+  uint64_t max_ = 0;
+  uint64_t sum_ = 0;
+  std::vector<uint64_t> bucket_list_;
+};
+
+/** \brief Lock-free latency histogram.
+ *
+ * Record() may be called from any thread. It only updates relaxed atomic
+ * counters.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr size_t kNofBuckets = 45 * kSubBuckets;
+
+  LatencyHistogram();
+
+  void Record(int64_t ns);
+  void Reset();
+  [[nodiscard]] HistogramSnapshot Snapshot() const;
+
+  [[nodiscard]] static size_t BucketIndex(uint64_t value);
+  [[nodiscard]] static uint64_t BucketLowValue(size_t index);
+  [[nodiscard]] static uint64_t BucketHighValue(size_t index);
+
+ private:
+  std::atomic<uint64_t> count_ = 0;
+  std::atomic<uint64_t> min_ = UINT64_MAX;
+  std::atomic<uint64_t> max_ = 0;
+  std::atomic<uint64_t> sum_ = 0;
+  std::array<std::atomic<uint64_t>, kNofBuckets> bucket_list_;
+};
+
+struct CommandLatency {
+  CommandCode cmd = CommandCode::REPEAT_REQUEST;
+  std::array<HistogramSnapshot, kNofLatencyStages> stage_list;
+};
+
+using CommandLatencyList = std::vector<CommandLatency>;
+
+}  // namespace asap3
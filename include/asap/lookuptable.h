@@ -0,0 +1,45 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "asap/asap3def.h"
+
+namespace asap3 {
+
+/** \brief Lookup table (map or curve) used by the EV2 lookup commands.
+ *
+ * The address and size are returned by SELECT_LOOKUP_TABLE_EV2. The values
+ * are stored with X changing fastest.
+ */
+struct LookupTable {
+  std::string name;
+  uint32_t address = 0;
+  uint16_t x_dim = 0;
+  uint16_t y_dim = 0;
+  std::vector<float> value_list;
+  bool valid = false;  ///< True if the last request on the table succeeded
+};
+
+using LookupTableList = std::vector<LookupTable>;
+
+/// INCREASE_LOOKUP_TABLE_EV2 on a block of cells. The mode is VALUE or
+/// CONSTANT (set), OFFSET (add) or FACTOR (multiply).
+struct LookupTableIncrease {
+  std::string name;
+  Mc3ValueType mode = Mc3ValueType::OFFSET;
+  uint16_t x_start = 0;
+  uint16_t y_start = 0;
+  uint16_t x_count = 1;
+  uint16_t y_count = 1;
+  float value = 0.0F;
+};
+
+using LookupTableIncreaseList = std::vector<LookupTableIncrease>;
+
+}  // namespace asap3
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "asap/a3parameter.h"
+#include "asap/asap3def.h"
+
+namespace asap3 {
+
+/** \brief Server metadata that is stored in the cache file. */
+struct ServerMetadata {
+  std::string remote_name;     ///< Name from IDENTIFY
+  uint16_t remote_version = 0; ///< Version from IDENTIFY
+  uint64_t fingerprint = 0;    ///< Hash of the server configuration
+  bool has_signals = false;    ///< True if the signals were discovered
+  ServiceList service_list;
+  A3ParameterList parameter_list;
+  A3ParameterList signal_list;
+};
+
+/** \brief Compact binary file with the server metadata.
+ *
+ * The file is memory mapped when loaded. A cached list should only be used
+ * if the remote name, version and fingerprint match the connected server.
+ */
+class MetadataCache {
+ public:
+  /// 64-bit FNV-1a hash of the text.
+  [[nodiscard]] static uint64_t Fingerprint(std::string_view text);
+
+  static bool Save(const std::string& filename,
+                   const ServerMetadata& metadata);
+  static bool Load(const std::string& filename, ServerMetadata& metadata);
+};
+
+}  // namespace asap3
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace asap3 {
+
+/// Case-insensitive (ASCII) compare without any copies.
+[[nodiscard]] bool IEqualsName(std::string_view name1, std::string_view name2);
+
+/// Case-insensitive (ASCII) 64-bit FNV-1a hash.
+[[nodiscard]] uint64_t HashName(std::string_view name);
+
+/** \brief Case-insensitive name to index map.
+ *
+ * The names are folded while hashing, so a lookup doesn't create any
+ * temporary strings. If a name is added twice, the first index is kept.
+ */
+class NameIndex {
+ public:
+  void Clear() { index_map_.clear(); }
+  void Reserve(size_t size) { index_map_.reserve(size); }
+  void Add(std::string_view name, size_t index);
+
+  [[nodiscard]] std::optional<size_t> Find(std::string_view name) const;
+  [[nodiscard]] bool Contains(std::string_view name) const {
+    return index_map_.find(name) != index_map_.cend();
+  }
+  [[nodiscard]] size_t Size() const { return index_map_.size(); }
+
+ private:
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+      return static_cast<size_t>(HashName(name));
+    }
+  };
+  struct NameEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view name1, std::string_view name2) const {
+      return IEqualsName(name1, name2);
+    }
+  };
+  std::unordered_map<std::string, size_t, NameHash, NameEqual> index_map_;
+};
+
+}  // namespace asap3
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace asap3 {
+
+class SharedRegion;
+
+/** \brief Parameter metadata in a shared online table. */
+struct SharedParameter {
+  char name[64] = {};  ///< Null-terminated. Max 63 characters.
+  char unit[24] = {};
+  uint16_t type = 0;  ///< Mc3DataType
+  uint8_t nof_decimals = 0;
+  uint8_t reserved1 = 0;
+  uint32_t index = 0;  ///< Index in the value list
+  double min = 0.0;
+  double max = 0.0;
+  uint8_t reserved2[16] = {};
+};
+static_assert(sizeof(SharedParameter) == 128);
+
+/** \brief Header of a shared online table.
+ *
+ * The header is followed by the parameter list and two value buffers. The
+ * writer fills the buffer that readers don't use and then flips to it by
+ * stepping the end count, so a reader can use the latest values in place
+ * until the writer begins the write after next. The parameter list is
+ * protected by its own sequence (seqlock) and the generation is stepped
+ * each time it changes.
+ */
+struct OnlineTableHeader {
+  static constexpr uint32_t kMagic = 0x544F3341;  ///< "A3OT"
+  static constexpr uint16_t kVersion = 1;
+
+  uint32_t magic = kMagic;
+  uint16_t version = kVersion;
+  uint16_t header_size = 128;
+  uint32_t capacity = 0;    ///< Max number of parameters
+  uint32_t nof_values = 0;  ///< Current number of parameters
+  uint64_t generation = 0;  ///< Stepped when the parameter list changes
+  uint64_t meta_sequence = 0;  ///< Odd while the parameter list is written
+  uint64_t begin_count = 0;    ///< Started value writes
+  uint64_t end_count = 0;  ///< Finished value writes. Buffer is end % 2
+  uint64_t time = 0;       ///< Last write (ns since 1970)
+  uint64_t parameter_offset = 0;
+  uint64_t value_offset[2] = {};
+  uint8_t reserved[48] = {};
+};
+static_assert(sizeof(OnlineTableHeader) == 128);
+
+/** \brief Creates and updates a shared online table. */
+class OnlineTableWriter {
+ public:
+  OnlineTableWriter();
+  ~OnlineTableWriter();
+
+  OnlineTableWriter(const OnlineTableWriter&) = delete;
+  OnlineTableWriter& operator=(const OnlineTableWriter&) = delete;
+
+  /// Creates or replaces the table. It's removed when the writer is closed.
+  bool Create(const std::string& name, size_t capacity);
+  void Close();
+  [[nodiscard]] bool IsOpen() const;
+  [[nodiscard]] const std::string& Name() const;
+  [[nodiscard]] size_t Capacity() const;
+  [[nodiscard]] uint64_t Generation() const;
+
+  /// Replaces the parameter list and steps the generation. The values are
+  /// NaN until the next WriteValues().
+  bool WriteParameters(std::span<const SharedParameter> parameter_list);
+  /// The list must have one value per parameter.
+  bool WriteValues(std::span<const double> value_list);
+
+ private:
+  std::unique_ptr<SharedRegion> region_;
+};
+
+/** \brief Reads a shared online table without locks or server access.
+ *
+ * Latest() gives the values in place. Use IsValid() after the values have
+ * been used, to know that the writer didn't overwrite them meanwhile.
+ */
+class OnlineTableReader {
+ public:
+  struct View {
+    std::span<const double> value_list;
+    uint64_t count = 0;       ///< Write count
+    uint64_t generation = 0;  ///< Parameter list generation
+    uint64_t time = 0;        ///< Write time (ns since 1970)
+  };
+
+  OnlineTableReader();
+  ~OnlineTableReader();
+
+  OnlineTableReader(const OnlineTableReader&) = delete;
+  OnlineTableReader& operator=(const OnlineTableReader&) = delete;
+
+  /// Fails if the region doesn't exist or isn't an online table.
+  bool Open(const std::string& name);
+  void Close();
+  [[nodiscard]] bool IsOpen() const;
+  [[nodiscard]] const std::string& Name() const;
+  [[nodiscard]] uint64_t Generation() const;
+
+  /// Copies the parameter list. Only needed when the generation changes.
+  bool ReadParameters(std::vector<SharedParameter>& parameter_list,
+                      uint64_t* generation = nullptr) const;
+
+  /// Zero-copy view of the latest values. Empty if the parameter list is
+  /// being written. The writer stores each value atomically, so use
+  /// std::atomic_ref to load values that may be overwritten.
+  [[nodiscard]] View Latest() const;
+  [[nodiscard]] bool IsValid(const View& view) const;
+  /// Copies a consistent snapshot of the latest values.
+  bool Read(std::vector<double>& value_list,
+            uint64_t* generation = nullptr) const;
+
+ private:
+  std::unique_ptr<SharedRegion> region_;
+};
+
+}  // namespace asap3
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asap/a3parameter.h"
+#include "asap/asap3def.h"
+#include "asap/nameindex.h"
+#include "asap/searchindex.h"
+
+namespace asap3 {
+
+class ParameterCatalog;
+
+/** \brief Read-only view of one parameter in a catalog.
+ *
+ * The accessors have the same names as in A3Parameter but text is returned
+ * as string views into the catalog.
+ */
+class ParameterView {
+ public:
+  ParameterView(const ParameterCatalog& catalog, size_t index)
+      : catalog_(&catalog), index_(index) {}
+
+  [[nodiscard]] size_t Index() const { return index_; }
+
+  [[nodiscard]] std::string_view Name() const;
+  [[nodiscard]] std::string_view DisplayName() const;
+  [[nodiscard]] std::string_view Description() const;
+  [[nodiscard]] std::string_view Unit() const;
+  [[nodiscard]] std::string_view Device() const;
+  [[nodiscard]] std::string_view Identity() const;
+  [[nodiscard]] std::string_view Signal() const;
+  [[nodiscard]] Mc3DataType Type() const;
+  [[nodiscard]] double Max() const;
+  [[nodiscard]] double Min() const;
+  [[nodiscard]] bool SetPoint() const;
+  [[nodiscard]] uint8_t NofDecimals() const;
+  [[nodiscard]] int CycleTime() const;
+  [[nodiscard]] uint16_t LunNo() const;
+
+  /// Returns a stand-alone copy of the parameter.
+  [[nodiscard]] A3Parameter ToParameter() const;
+
+ private:
+  const ParameterCatalog* catalog_;
+  size_t index_;
+};
+
+/** \brief Immutable parameter list with interned strings.
+ *
+ * All unique strings are stored once in an arena and the parameters only
+ * hold string indexes. Scalars are stored column-wise. The catalog is
+ * created once and shared between clients through a shared pointer.
+ */
+class ParameterCatalog {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ParameterView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = ParameterView;
+
+    Iterator() = default;
+    Iterator(const ParameterCatalog* catalog, size_t index)
+        : catalog_(catalog), index_(index) {}
+    ParameterView operator*() const { return {*catalog_, index_}; }
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto temp = *this;
+      ++index_;
+      return temp;
+    }
+    bool operator==(const Iterator& other) const {
+      return index_ == other.index_;
+    }
+
+   private:
+    const ParameterCatalog* catalog_ = nullptr;
+    size_t index_ = 0;
+  };
+
+  static std::shared_ptr<const ParameterCatalog> Create(
+      const A3ParameterList& parameter_list);
+
+  [[nodiscard]] size_t Size() const { return name_list_.size(); }
+  [[nodiscard]] bool Empty() const { return name_list_.empty(); }
+  [[nodiscard]] ParameterView operator[](size_t index) const {
+    return {*this, index};
+  }
+  [[nodiscard]] Iterator begin() const { return {this, 0}; }
+  [[nodiscard]] Iterator end() const { return {this, Size()}; }
+
+  [[nodiscard]] A3ParameterList ToParameterList() const;
+
+  /// Case-insensitive lookups. Returns the parameter index.
+  [[nodiscard]] std::optional<size_t> FindName(std::string_view name) const {
+    return name_index_.Find(name);
+  }
+  [[nodiscard]] std::optional<size_t> FindDisplayName(
+      std::string_view display_name) const {
+    return display_name_index_.Find(display_name);
+  }
+  [[nodiscard]] std::optional<size_t> FindIdentity(
+      std::string_view identity) const {
+    return identity_index_.Find(identity);
+  }
+
+  /// Search index over the names. It is created on first use.
+  [[nodiscard]] const SearchIndex& NameSearch() const;
+  /// Wildcard search if the pattern has '*' or '?', else substring search.
+  [[nodiscard]] std::vector<ParameterView> Search(
+      std::string_view pattern, size_t limit = SearchIndex::kNoLimit) const;
+
+  [[nodiscard]] size_t NofStrings() const { return text_list_.size(); }
+  [[nodiscard]] size_t ArenaSize() const { return arena_.size(); }
+
+ private:
+  friend class ParameterView;
+  struct TextRef {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+
+  std::string arena_;              ///< All unique strings
+  std::vector<TextRef> text_list_;  ///< Index 0 is the empty string
+
+  std::vector<uint32_t> name_list_;
+  std::vector<uint32_t> display_name_list_;
+  std::vector<uint32_t> description_list_;
+  std::vector<uint32_t> unit_list_;
+  std::vector<uint32_t> device_list_;
+  std::vector<uint32_t> identity_list_;
+  std::vector<uint32_t> signal_list_;
+  std::vector<Mc3DataType> type_list_;
+  std::vector<double> max_list_;
+  std::vector<double> min_list_;
+  std::vector<uint8_t> set_point_list_;
+  std::vector<uint8_t> nof_decimals_list_;
+  std::vector<int32_t> cycle_time_list_;
+  std::vector<uint16_t> lun_list_;
+
+  NameIndex name_index_;
+  NameIndex display_name_index_;
+  NameIndex identity_index_;
+
+  mutable std::once_flag search_flag_;
+  mutable std::unique_ptr<SearchIndex> search_index_;
+
+  ParameterCatalog() = default;
+  [[nodiscard]] std::string_view Text(uint32_t text_index) const;
+};
+
+using ParameterCatalogPtr = std::shared_ptr<const ParameterCatalog>;
+
+}  // namespace asap3
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace asap3 {
+
+/** \brief Case-insensitive prefix, substring and wildcard search.
+ *
+ * The index holds a lower-case copy of the names, a sorted name array for
+ * prefix queries and trigram lists for substring queries. Wildcard queries
+ * use one of these to find candidates before the pattern is matched.
+ * All queries return list indexes in ascending order.
+ */
+class SearchIndex {
+ public:
+  static constexpr size_t kNoLimit = std::numeric_limits<size_t>::max();
+
+  SearchIndex() = default;
+  explicit SearchIndex(const std::vector<std::string_view>& name_list);
+
+  [[nodiscard]] size_t Size() const { return sorted_list_.size(); }
+
+  [[nodiscard]] std::vector<size_t> Prefix(std::string_view prefix,
+                                           size_t limit = kNoLimit) const;
+  [[nodiscard]] std::vector<size_t> Substring(std::string_view text,
+                                              size_t limit = kNoLimit) const;
+  /// '*' matches any number of characters and '?' matches one character.
+  [[nodiscard]] std::vector<size_t> Glob(std::string_view pattern,
+                                         size_t limit = kNoLimit) const;
+
+  /// Case-insensitive wildcard match of the whole text.
+  [[nodiscard]] static bool GlobMatch(std::string_view pattern,
+                                      std::string_view text);
+
+ private:
+  std::string arena_;                 ///< Lower-case names
+  std::vector<uint32_t> offset_list_;  ///< Name start. Last is arena size.
+  std::vector<uint32_t> sorted_list_;  ///< Indexes sorted by name
+  std::unordered_map<uint32_t, std::vector<uint32_t>> trigram_map_;
+
+  [[nodiscard]] std::string_view Name(size_t index) const;
+  [[nodiscard]] std::pair<size_t, size_t> PrefixRange(
+      std::string_view prefix) const;
+  [[nodiscard]] const std::vector<uint32_t>* Candidates(
+      std::string_view text) const;
+};
+
+}  // namespace asap3
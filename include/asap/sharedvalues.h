@@ -0,0 +1,88 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace asap3 {
+
+class SharedRegion;
+
+/** \brief Header of a shared memory value table.
+ *
+ * The header is followed by capacity 8-byte values. The writer makes the
+ * sequence odd while it updates the table, so a reader retries until it
+ * gets the same even sequence before and after its copy (seqlock). Neither
+ * side takes a lock. The number of values and the time are covered by the
+ * sequence.
+ */
+struct SharedValueHeader {
+  static constexpr uint32_t kMagic = 0x56533341;  ///< "A3SV"
+  static constexpr uint16_t kVersion = 1;
+
+  uint32_t magic = kMagic;
+  uint16_t version = kVersion;
+  uint16_t header_size = 64;
+  uint32_t capacity = 0;    ///< Max number of values
+  uint32_t nof_values = 0;  ///< Current number of values
+  uint64_t sequence = 0;
+  uint64_t time = 0;  ///< Update time (ns since 1970)
+  uint8_t reserved[32] = {};
+};
+static_assert(sizeof(SharedValueHeader) == 64);
+
+/** \brief Publishes values into a shared memory value table. */
+class SharedValueWriter {
+ public:
+  SharedValueWriter();
+  ~SharedValueWriter();
+
+  SharedValueWriter(const SharedValueWriter&) = delete;
+  SharedValueWriter& operator=(const SharedValueWriter&) = delete;
+
+  /// Creates or replaces the table. It's removed when the writer is closed.
+  bool Create(const std::string& name, size_t capacity);
+  void Close();
+  [[nodiscard]] bool IsOpen() const;
+  [[nodiscard]] const std::string& Name() const;
+  [[nodiscard]] size_t Capacity() const;
+
+  /// Returns false if the values don't fit.
+  bool Write(std::span<const double> value_list);
+
+ private:
+  std::unique_ptr<SharedRegion> region_;
+};
+
+/** \brief Reads a shared memory value table without any locks. */
+class SharedValueReader {
+ public:
+  SharedValueReader();
+  ~SharedValueReader();
+
+  SharedValueReader(const SharedValueReader&) = delete;
+  SharedValueReader& operator=(const SharedValueReader&) = delete;
+
+  /// Fails if the region doesn't exist or isn't a value table.
+  bool Open(const std::string& name);
+  void Close();
+  [[nodiscard]] bool IsOpen() const;
+  [[nodiscard]] const std::string& Name() const;
+
+  /// Copies a consistent snapshot. The list is resized to the number of
+  /// values. Returns false if the writer never finished in time.
+  bool Read(std::vector<double>& value_list,
+            uint64_t* sequence = nullptr) const;
+  [[nodiscard]] uint64_t Sequence() const;
+
+ private:
+  std::unique_ptr<SharedRegion> region_;
+};
+
+}  // namespace asap3
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace asap3 {
+
+/** \brief TCP options that the client sets on each connect.
+ *
+ * Zero means the system default. The keepalive times, the user timeout,
+ * busy polling and quick ACK are Linux options. They are ignored on other
+ * platforms and by the Unix socket and memory pipe transports.
+ */
+struct SocketOptions {
+  bool no_delay = true;     ///< TCP_NODELAY. Disables the Nagle algorithm.
+  int receive_buffer = 0;   ///< SO_RCVBUF (bytes)
+  int send_buffer = 0;      ///< SO_SNDBUF (bytes)
+
+  bool keep_alive = false;  ///< SO_KEEPALIVE
+  std::chrono::seconds keep_alive_idle = {};      ///< TCP_KEEPIDLE
+  std::chrono::seconds keep_alive_interval = {};  ///< TCP_KEEPINTVL
+  int keep_alive_count = 0;                       ///< TCP_KEEPCNT
+  /// TCP_USER_TIMEOUT. Max time that sent data may stay unacknowledged
+  /// before the connection is dropped.
+  std::chrono::milliseconds user_timeout = {};
+
+  /// SO_BUSY_POLL. Time that a blocking receive busy waits on the device
+  /// queue. Trades CPU for latency.
+  std::chrono::microseconds busy_poll = {};
+  /// TCP_QUICKACK. The kernel clears it by itself, so it is set again
+  /// before each read.
+  bool quick_ack = false;
+};
+
+}  // namespace asap3
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace asap3 {
+
+/** \brief Strided view of N-dimensional characteristic values.
+ *
+ * The view doesn't own any values. The X index changes fastest. A slice or
+ * range keeps all dimensions, a fixed dimension just gets the size 1, so a
+ * view always maps to one READ_CELL_VALUES or WRITE_CELL_VALUES block. The
+ * origin is the position of the view in the full characteristic.
+ */
+template <typename T>
+class TensorView {
+ public:
+  static constexpr size_t kMaxRank = 5;
+  using Index = std::array<size_t, kMaxRank>;
+
+  TensorView() = default;
+  /// Dense view of all values.
+  TensorView(T* data, std::span<const uint16_t> dimension_list);
+
+  /// A mutable view converts to a const view.
+  template <typename U>
+    requires std::is_convertible_v<U*, T*>
+  TensorView(const TensorView<U>& view)  // NOLINT
+      : data_(view.data_),
+        rank_(view.rank_),
+        shape_(view.shape_),
+        stride_(view.stride_),
+        origin_(view.origin_) {}
+
+  [[nodiscard]] size_t Rank() const { return rank_; }
+  [[nodiscard]] size_t Shape(size_t dim) const {
+    return dim < rank_ ? shape_[dim] : 1;
+  }
+  [[nodiscard]] size_t Stride(size_t dim) const {
+    return dim < rank_ ? stride_[dim] : 0;
+  }
+  [[nodiscard]] size_t Origin(size_t dim) const {
+    return dim < rank_ ? origin_[dim] : 0;
+  }
+  [[nodiscard]] size_t Size() const;
+  [[nodiscard]] bool Empty() const { return data_ == nullptr || Size() == 0; }
+  [[nodiscard]] T* Data() const { return data_; }
+
+  [[nodiscard]] T& At(const Index& index) const;
+  template <typename... I>
+  [[nodiscard]] T& operator()(I... index) const {
+    return At(Index{static_cast<size_t>(index)...});
+  }
+
+  /// Sub-block [start, start + count) in one dimension.
+  [[nodiscard]] TensorView Range(size_t dim, size_t start,
+                                 size_t count) const;
+  /// Fixes one dimension, e.g. Slice(1, y) is a row of a map and
+  /// Slice(2, z) is a plane of a cube.
+  [[nodiscard]] TensorView Slice(size_t dim, size_t index) const {
+    return Range(dim, index, 1);
+  }
+
+  /// True if the values are stored without gaps.
+  [[nodiscard]] bool IsContiguous() const;
+  /// The values as a span. Empty if the view isn't contiguous.
+  [[nodiscard]] std::span<T> Contiguous() const;
+
+  /// Start and count lists for the cell value commands.
+  void CellRange(std::vector<uint16_t>& start_list,
+                 std::vector<uint16_t>& count_list) const;
+
+  /// Calls function(value) for each value, X fastest.
+  template <typename F>
+  void ForEach(F&& function) const;
+
+  /// Copies the values, X fastest, to dest which must have Size() values.
+  void CopyTo(std::span<std::remove_const_t<T>> dest) const;
+  /// Copies Size() values into the view.
+  void CopyFrom(std::span<const std::remove_const_t<T>> source) const
+    requires(!std::is_const_v<T>);
+
+ private:
+  template <typename U>
+  friend class TensorView;
+
+  T* data_ = nullptr;
+  size_t rank_ = 0;
+  Index shape_ = {};
+  Index stride_ = {};
+  Index origin_ = {};
+};
+
+template <typename T>
+TensorView<T>::TensorView(T* data, std::span<const uint16_t> dimension_list)
+    : data_(data) {
+  rank_ = std::min(dimension_list.size(), kMaxRank);
+  size_t stride = 1;
+  for (size_t dim = 0; dim < rank_; ++dim) {
+    shape_[dim] = dimension_list[dim];
+    stride_[dim] = stride;
+    stride *= dimension_list[dim];
+  }
+}
+
+template <typename T>
+size_t TensorView<T>::Size() const {
+  size_t size = 1;
+  for (size_t dim = 0; dim < rank_; ++dim) {
+    size *= shape_[dim];
+  }
+  return size;
+}
+
+template <typename T>
+T& TensorView<T>::At(const Index& index) const {
+  size_t offset = 0;
+  for (size_t dim = 0; dim < rank_; ++dim) {
+    offset += index[dim] * stride_[dim];
+  }
+  return data_[offset];
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::Range(size_t dim, size_t start,
+                                   size_t count) const {
+  if (dim >= rank_ || start >= shape_[dim]) {
+    return {};
+  }
+  TensorView view = *this;
+  view.data_ += start * stride_[dim];
+  view.shape_[dim] = std::min(count, shape_[dim] - start);
+  view.origin_[dim] += start;
+  return view;
+}
+
+template <typename T>
+bool TensorView<T>::IsContiguous() const {
+  // Each used dimension must follow directly after the previous one
+  size_t stride = 1;
+  for (size_t dim = 0; dim < rank_; ++dim) {
+    if (shape_[dim] == 1) {
+      continue;
+    }
+    if (stride_[dim] != stride) {
+      return false;
+    }
+    stride *= shape_[dim];
+  }
+  return true;
+}
+
+template <typename T>
+std::span<T> TensorView<T>::Contiguous() const {
+  if (data_ == nullptr || !IsContiguous()) {
+    return {};
+  }
+  return {data_, Size()};
+}
+
+template <typename T>
+void TensorView<T>::CellRange(std::vector<uint16_t>& start_list,
+                              std::vector<uint16_t>& count_list) const {
+  start_list.resize(rank_);
+  count_list.resize(rank_);
+  for (size_t dim = 0; dim < rank_; ++dim) {
+    start_list[dim] = static_cast<uint16_t>(origin_[dim]);
+    count_list[dim] = static_cast<uint16_t>(shape_[dim]);
+  }
+}
+
+template <typename T>
+template <typename F>
+void TensorView<T>::ForEach(F&& function) const {
+  if (Empty()) {
+    return;
+  }
+  // The inner X loop is a plain strided loop
+  const size_t inner = rank_ > 0 ? shape_[0] : 1;
+  const size_t inner_stride = rank_ > 0 ? stride_[0] : 1;
+  Index index = {};
+  for (bool more = true; more;) {
+    T* row = &At(index);
+    for (size_t x = 0; x < inner; ++x) {
+      function(row[x * inner_stride]);
+    }
+    more = false;
+    for (size_t dim = 1; dim < rank_ && !more; ++dim) {
+      if (++index[dim] < shape_[dim]) {
+        more = true;
+      } else {
+        index[dim] = 0;
+      }
+    }
+  }
+}
+
+template <typename T>
+void TensorView<T>::CopyTo(std::span<std::remove_const_t<T>> dest) const {
+  if (const auto values = Contiguous(); !values.empty()) {
+    std::copy(values.begin(), values.end(), dest.begin());
+    return;
+  }
+  auto itr = dest.begin();
+  ForEach([&](const T& value) { *itr++ = value; });
+}
+
+template <typename T>
+void TensorView<T>::CopyFrom(
+    std::span<const std::remove_const_t<T>> source) const
+  requires(!std::is_const_v<T>)
+{
+  if (const auto values = Contiguous(); !values.empty()) {
+    std::copy(source.begin(), source.begin() + values.size(), values.begin());
+    return;
+  }
+  auto itr = source.begin();
+  ForEach([&](T& value) { value = *itr++; });
+}
+
+}  // namespace asap3
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace asap3 {
+
+enum class TraceDirection : uint8_t {
+  Transmit = 0,  ///< Request sent to server
+  Receive = 1,   ///< Response from server
+};
+
+struct TraceRecord {
+  uint64_t time = 0;  ///< Nanoseconds since 1970
+  TraceDirection direction = TraceDirection::Transmit;
+  std::vector<uint8_t> frame;  ///< Raw frame including the length word
+};
+
+/** \brief Fixed-size ring of raw telegram frames.
+ *
+ * The I/O path only copies the frame bytes into the ring. Formatting is done
+ * later by a consumer (Read()) or on demand (Snapshot()). When the ring is
+ * full, the oldest frames are overwritten. The buffer is allocated by the
+ * first write, so an unused ring costs no memory.
+ */
+class TraceRing {
+ public:
+  explicit TraceRing(size_t capacity = 1'048'576);
+
+  /// Changes the size of the ring. All stored frames are removed and the
+  /// buffer is freed until the next write.
+  void Capacity(size_t capacity);
+  [[nodiscard]] size_t Capacity() const;
+
+  void Write(TraceDirection direction, uint64_t time,
+             const std::vector<uint8_t>& frame);
+  /// Writes a frame that is stored in two buffers, e.g. length and body.
+  void Write(TraceDirection direction, uint64_t time,
+             const std::vector<uint8_t>& first,
+             const std::vector<uint8_t>& second);
+
+  /// Returns the next unread frame. Returns false if no frame is available.
+  bool Read(TraceRecord& record);
+
+  /// Returns a copy of all frames in the ring. Doesn't affect Read().
+  [[nodiscard]] std::vector<TraceRecord> Snapshot() const;
+
+  void Clear();
+  [[nodiscard]] bool Empty() const;
+  /// Number of frames overwritten before they were read.
+  [[nodiscard]] uint64_t Dropped() const;
+
+ private:
+  static constexpr size_t kHeaderSize = 16;
+
+  mutable std::mutex locker_;
+  size_t capacity_ = 0;
+  std::vector<uint8_t> buffer_;
+  uint64_t head_ = 0;  ///< Write position. Positions are never wrapped.
+  uint64_t tail_ = 0;  ///< Oldest stored frame
+  uint64_t read_ = 0;  ///< Next frame for Read()
+  uint64_t dropped_ = 0;
+
+  void CopyIn(uint64_t position, const uint8_t* data, size_t size);
+  void CopyOut(uint64_t position, uint8_t* data, size_t size) const;
+  [[nodiscard]] size_t RecordSize(uint64_t position) const;
+  void ReadRecord(uint64_t position, TraceRecord& record) const;
+};
+
+}  // namespace asap3
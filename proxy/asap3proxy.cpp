@@ -0,0 +1,661 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap3proxy.h"
+
+#include <util/stringutil.h>
+
+#include <algorithm>
+
+#include "asap/irequest.h"
+#include "asap/iresponse.h"
+#include "asap/itelegram.h"
+#include "asap3helper.h"
+
+using namespace boost::asio;
+using namespace boost::system;
+using namespace util::string;
+
+namespace {
+// Per connection services that can't be shared through the proxy
+constexpr std::string_view kDisableSetValueAck = "Disable SetValue Ack";
+constexpr std::string_view kGetShareName = "Get Share Memory Name";
+
+const asap3::DataValueList kResetList = {
+    {"Emulator LUN", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+    {"Sample Rate", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+    {"Measurements", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+};
+
+bool IsHiddenService(const std::string& service) {
+  return IEquals(service, std::string(kDisableSetValueAck)) ||
+         IEquals(service, std::string(kGetShareName));
+}
+
+void ErrorFrame(asap3::CommandCode cmd, const std::string& text,
+                std::vector<uint8_t>& frame) {
+  asap3::IResponse response;
+  response.Cmd(cmd);
+  response.Status(asap3::StatusCode::STATUS_ERROR);
+  response.DataList({
+      {"Error Code", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(1)},
+      {"Error Text", asap3::Mc3DataType::MC3_STRING, text},
+  });
+  response.CreateBody(frame);
+}
+
+template <typename T>
+float AnyToFloat(const std::any& value) {
+  const auto* typed = std::any_cast<T>(&value);
+  return typed != nullptr ? static_cast<float>(*typed)
+                          : asap3::Asap3Helper::InvalidFloat();
+}
+
+// The values of a plain PARAMETER_FOR_VALUE_ACQUISITION are floats
+float ToFloat(const asap3::DataValue& data) {
+  switch (data.type) {
+    case asap3::Mc3DataType::A_FLOAT32:
+      return AnyToFloat<float>(data.value);
+    case asap3::Mc3DataType::A_FLOAT64:
+      return AnyToFloat<double>(data.value);
+    case asap3::Mc3DataType::A_INT16:
+      return AnyToFloat<int16_t>(data.value);
+    case asap3::Mc3DataType::A_UINT16:
+      return AnyToFloat<uint16_t>(data.value);
+    case asap3::Mc3DataType::A_INT32:
+      return AnyToFloat<int32_t>(data.value);
+    case asap3::Mc3DataType::A_UINT32:
+      return AnyToFloat<uint32_t>(data.value);
+    case asap3::Mc3DataType::A_INT64:
+      return AnyToFloat<int64_t>(data.value);
+    case asap3::Mc3DataType::A_UINT64:
+      return AnyToFloat<uint64_t>(data.value);
+    default:
+      break;
+  }
+  return asap3::Asap3Helper::InvalidFloat();
+}
+
+void ServiceListFrame(const asap3::ServiceList& service_list,
+                      std::vector<uint8_t>& frame) {
+  asap3::DataValueList data_list;
+  data_list.push_back({"Services", asap3::Mc3DataType::A_UINT16,
+                       static_cast<uint16_t>(0)});
+  for (const auto& service : service_list) {
+    if (!IsHiddenService(service.name)) {
+      data_list.push_back(
+          {"Service", asap3::Mc3DataType::MC3_STRING, service.name});
+    }
+  }
+  data_list[0].value = static_cast<uint16_t>(data_list.size() - 1);
+
+  asap3::IResponse response;
+  response.Cmd(asap3::CommandCode::QUERY_AVAILABLE_SERVICE);
+  response.Status(asap3::StatusCode::STATUS_OK);
+  response.DataList(data_list);
+  response.CreateBody(frame);
+}
+
+}  // namespace
+
+namespace asap3 {
+
+class ProxySession : public std::enable_shared_from_this<ProxySession> {
+ public:
+  ProxySession(Asap3Proxy& proxy, ip::tcp::socket socket)
+      : proxy_(proxy), socket_(std::move(socket)) {
+    short_data_.resize(2, 0);
+  }
+
+  void Start() { DoReadLength(); }
+
+  void Close() {
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    error_code dummy;
+    socket_.shutdown(ip::tcp::socket::shutdown_both, dummy);
+    socket_.close(dummy);
+    if (!name_list_.empty()) {
+      name_list_.clear();
+      proxy_.UpdateSubscription();
+    }
+  }
+
+  /// Sends the response and then reads the next request.
+  void Respond(std::vector<uint8_t> frame) {
+    if (closed_) {
+      return;
+    }
+    transmit_data_ = std::move(frame);
+    DoWrite();
+  }
+
+  std::vector<std::string> name_list_;  ///< Subscribed names in order
+  std::vector<size_t> index_list_;  ///< Index into the merged acquisition
+  uint64_t generation_ = 0;         ///< Zero if the index list is stale
+  /// Subscribed with PARAMETER_FOR_VALUE_ACQUISITION_EV2, i.e. typed values.
+  bool ev2_ = true;
+
+ private:
+  Asap3Proxy& proxy_;
+  ip::tcp::socket socket_;
+  bool closed_ = false;
+  std::vector<uint8_t> short_data_;
+  std::vector<uint8_t> body_data_;
+  std::vector<uint8_t> transmit_data_;
+
+  void DoReadLength() {
+    auto self = shared_from_this();
+    async_read(socket_, buffer(short_data_),
+               [self](const error_code& error, size_t bytes) {
+                 if (error || bytes != self->short_data_.size()) {
+                   self->Close();
+                   return;
+                 }
+                 uint16_t length = 0;
+                 Asap3Helper::ToMc3Value(self->short_data_, 0, length);
+                 if (length < 6) {
+                   self->Close();
+                   return;
+                 }
+                 self->body_data_.clear();
+                 self->body_data_.resize(length - 2, 0);
+                 self->DoReadBody();
+               });
+  }
+
+  void DoReadBody() {
+    auto self = shared_from_this();
+    async_read(socket_, buffer(body_data_),
+               [self](const error_code& error, size_t bytes) {
+                 if (error || bytes != self->body_data_.size()) {
+                   self->Close();
+                   return;
+                 }
+                 self->transmit_data_.clear();
+                 if (self->proxy_.HandleRequest(*self, self->body_data_,
+                                                self->transmit_data_)) {
+                   self->DoWrite();
+                 }
+               });
+  }
+
+  void DoWrite() {
+    auto self = shared_from_this();
+    async_write(socket_, buffer(transmit_data_),
+                [self](const error_code& error, size_t) {
+                  if (error) {
+                    self->Close();
+                  } else {
+                    self->DoReadLength();
+                  }
+                });
+  }
+};
+
+Asap3Proxy::Asap3Proxy() : poll_timer_(context_) {
+  for (const auto* service :
+       {"Get Number of Parameters", "Get Parameter Configuration",
+        "Get Number of Signals", "Get Signal Configuration",
+        "Get Config File"}) {
+    cached_service_list_.emplace(service);
+  }
+}
+
+Asap3Proxy::~Asap3Proxy() { Asap3Proxy::Stop(); }
+
+void Asap3Proxy::CacheService(const std::string& service, bool cache) {
+  std::scoped_lock lock(locker_);
+  if (cache) {
+    cached_service_list_.insert(service);
+  } else {
+    cached_service_list_.erase(service);
+  }
+}
+
+bool Asap3Proxy::CacheService(const std::string& service) const {
+  std::scoped_lock lock(locker_);
+  return cached_service_list_.contains(service);
+}
+
+std::vector<std::string> Asap3Proxy::Subscription() const {
+  std::scoped_lock lock(locker_);
+  std::vector<std::string> name_list;
+  name_list.reserve(parameter_list_.size());
+  for (const auto& parameter : parameter_list_) {
+    name_list.push_back(parameter.Name());
+  }
+  return name_list;
+}
+
+bool Asap3Proxy::Start() {
+  if (started_) {
+    return true;
+  }
+  try {
+    context_.restart();
+    acceptor_ = std::make_unique<ip::tcp::acceptor>(
+        context_, ip::tcp::endpoint(ip::address_v4::loopback(), port_));
+    port_ = acceptor_->local_endpoint().port();
+  } catch (const std::exception&) {
+    acceptor_.reset();
+    return false;
+  }
+  {
+    std::scoped_lock lock(locker_);
+    response_cache_.clear();
+    parameter_list_.clear();
+    parameter_index_.Clear();
+    ++generation_;
+    subscription_changed_ = false;
+    snapshot_.reset();
+  }
+  upstream_connected_ = false;
+  upstream_subscribed_ = false;
+  poll_in_flight_ = false;
+
+  client_ = Asap3Factory::CreateAsap3Client(client_type_);
+  client_->Name("A3Proxy-" + std::to_string(port_));
+  client_->Host(host_);
+  client_->Port(upstream_port_);
+  client_->BlockingStart(false);
+  if (!client_->Start()) {
+    client_.reset();
+    acceptor_.reset();
+    return false;
+  }
+
+  DoAccept();
+  DoPollTimer();
+  started_ = true;
+  worker_thread_ = std::thread(&Asap3Proxy::WorkerThread, this);
+  return true;
+}
+
+void Asap3Proxy::Stop() {
+  if (!started_) {
+    return;
+  }
+  // The upstream client is stopped first so no forwarded responses are
+  // posted to the sessions while they are closed.
+  client_->Stop();
+  post(context_, [&] {
+    error_code dummy;
+    if (acceptor_) {
+      acceptor_->close(dummy);
+    }
+    poll_timer_.cancel();
+    for (auto& weak : session_list_) {
+      if (auto session = weak.lock(); session) {
+        session->Close();
+      }
+    }
+    session_list_.clear();
+  });
+  if (worker_thread_.joinable()) {
+    worker_thread_.join();
+  }
+  acceptor_.reset();
+  client_.reset();
+  started_ = false;
+}
+
+void Asap3Proxy::WorkerThread() {
+  try {
+    context_.run();
+  } catch (const std::exception&) {
+  }
+}
+
+void Asap3Proxy::DoAccept() {
+  acceptor_->async_accept([&](const error_code& error, ip::tcp::socket socket) {
+    if (error) {
+      return;
+    }
+    ip::tcp::no_delay no_delay(true);
+    error_code dummy;
+    socket.set_option(no_delay, dummy);
+
+    auto session = std::make_shared<ProxySession>(*this, std::move(socket));
+    std::erase_if(session_list_, [](const auto& weak) { return weak.expired(); });
+    session_list_.push_back(session);
+    session->Start();
+    DoAccept();
+  });
+}
+
+void Asap3Proxy::DoPollTimer() {
+  poll_timer_.expires_after(poll_period_);
+  poll_timer_.async_wait([&](const error_code& error) {
+    if (error) {
+      return;
+    }
+    Poll();
+    DoPollTimer();
+  });
+}
+
+void Asap3Proxy::Poll() {
+  if (!client_->IsConnected()) {
+    upstream_connected_ = false;
+    return;
+  }
+  if (!upstream_connected_) {
+    // The server doesn't remember anything from the last connection
+    upstream_connected_ = true;
+    upstream_subscribed_ = false;
+    poll_in_flight_ = false;
+    std::scoped_lock lock(locker_);
+    response_cache_.clear();
+    subscription_changed_ = !parameter_list_.empty();
+  }
+  if (poll_in_flight_) {
+    return;
+  }
+
+  A3ParameterList parameter_list;
+  bool changed = false;
+  {
+    std::scoped_lock lock(locker_);
+    changed = subscription_changed_;
+    subscription_changed_ = false;
+    if (changed) {
+      parameter_list = parameter_list_;
+      upstream_generation_ = generation_;
+    }
+  }
+  if (changed) {
+    // The acquisition is only changed between polls, so a poll response
+    // always matches the value list.
+    if (parameter_list.empty()) {
+      client_->ClearParameterList();
+      client_->SendTelegram(CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2,
+                            kResetList);
+      upstream_subscribed_ = false;
+    } else {
+      client_->ParameterList(parameter_list);
+      upstream_subscribed_ = client_->StartSubscription(scan_rate_);
+    }
+  }
+  if (!upstream_subscribed_) {
+    return;
+  }
+
+  poll_in_flight_ = true;
+  ++nof_upstream_polls_;
+  const auto generation = upstream_generation_;
+  client_->SendTelegram(
+      CommandCode::GET_ONLINE_VALUE, {},
+      [this, generation](bool success, const ITelegram&) {
+        if (success) {
+          auto snapshot =
+              std::make_shared<const DataValueList>(client_->OnlineValues());
+          std::scoped_lock lock(locker_);
+          snapshot_ = std::move(snapshot);
+          snapshot_generation_ = generation;
+        }
+        poll_in_flight_ = false;
+      });
+}
+
+void Asap3Proxy::UpdateSubscription() {
+  const bool any = std::ranges::any_of(session_list_, [](const auto& weak) {
+    const auto session = weak.lock();
+    return session && !session->name_list_.empty();
+  });
+
+  std::scoped_lock lock(locker_);
+  if (!any) {
+    if (!parameter_list_.empty()) {
+      parameter_list_.clear();
+      parameter_index_.Clear();
+      ++generation_;
+      subscription_changed_ = true;
+    }
+    return;
+  }
+  const auto catalog = client_->Catalog();
+  for (const auto& weak : session_list_) {
+    const auto session = weak.lock();
+    if (!session) {
+      continue;
+    }
+    for (const auto& name : session->name_list_) {
+      if (parameter_index_.Contains(name)) {
+        continue;
+      }
+      // Use the server type if the parameters have been discovered
+      A3Parameter parameter;
+      parameter.Name(name);
+      if (const auto index = catalog ? catalog->FindName(name) : std::nullopt;
+          index) {
+        parameter = (*catalog)[*index].ToParameter();
+        parameter.SetPoint(false);
+      }
+      parameter_index_.Add(name, parameter_list_.size());
+      parameter_list_.push_back(parameter);
+      subscription_changed_ = true;
+    }
+  }
+}
+
+void Asap3Proxy::OnlineValues(ProxySession& session, bool typed,
+                              DataValueList& value_list) {
+  std::scoped_lock lock(locker_);
+  if (session.generation_ != generation_) {
+    session.index_list_.clear();
+    for (const auto& name : session.name_list_) {
+      session.index_list_.push_back(
+          parameter_index_.Find(name).value_or(parameter_list_.size()));
+    }
+    session.generation_ = generation_;
+  }
+  // The snapshot may be shorter than the list if parameters were added
+  const auto* snapshot =
+      snapshot_ && snapshot_generation_ == generation_ ? snapshot_.get()
+                                                       : nullptr;
+  // Values that the server hasn't reported yet are invalid
+  value_list.reserve(session.index_list_.size());
+  for (const auto index : session.index_list_) {
+    if (snapshot != nullptr && index < snapshot->size()) {
+      const auto& value = (*snapshot)[index];
+      if (typed) {
+        value_list.push_back(value);
+      } else {
+        value_list.push_back(
+            {value.name, Mc3DataType::A_FLOAT32, ToFloat(value)});
+      }
+    } else if (typed && index < parameter_list_.size()) {
+      const auto& parameter = parameter_list_[index];
+      value_list.push_back({parameter.Name(), parameter.Type(),
+                            Asap3Helper::InvalidValue(parameter.Type())});
+    } else {
+      value_list.push_back(
+          {"", Mc3DataType::A_FLOAT32, Asap3Helper::InvalidFloat()});
+    }
+  }
+}
+
+bool Asap3Proxy::IsCacheable(CommandCode command,
+                             const std::vector<uint8_t>& body,
+                             size_t offset) const {
+  switch (command) {
+    case CommandCode::GET_SERVICE_INFORMATION:
+      return true;
+
+    case CommandCode::EXECUTE_SERVICE: {
+      std::string service;
+      Asap3Helper::ToMc3Value(body, offset, service);
+      std::scoped_lock lock(locker_);
+      return cached_service_list_.contains(service);
+    }
+
+    default:
+      break;
+  }
+  return false;
+}
+
+bool Asap3Proxy::HandleRequest(ProxySession& session,
+                               const std::vector<uint8_t>& body,
+                               std::vector<uint8_t>& response_frame) {
+  ++nof_requests_;
+  uint16_t cmd = 0;
+  size_t offset = Asap3Helper::ToMc3Value(body, 0, cmd);
+  const auto command = static_cast<CommandCode>(cmd);
+
+  IResponse response;
+  response.Cmd(command);
+  response.Status(StatusCode::STATUS_OK);
+  DataValueList data_list;
+
+  switch (command) {
+    case CommandCode::INIT:
+    case CommandCode::EXIT:
+      // The upstream connection is shared and kept
+      break;
+
+    case CommandCode::IDENTIFY:
+      if (client_->RemoteName().empty()) {
+        Forward(session, body, false);
+        return false;
+      }
+      ++nof_cache_hits_;
+      data_list.push_back(
+          {"Version", Mc3DataType::A_UINT16, client_->RemoteVersion()});
+      data_list.push_back(
+          {"Name", Mc3DataType::MC3_STRING, client_->RemoteName()});
+      break;
+
+    case CommandCode::QUERY_AVAILABLE_SERVICE: {
+      const auto service_list = client_->AvailableServices();
+      if (service_list.empty()) {
+        Forward(session, body, false);
+        return false;
+      }
+      ++nof_cache_hits_;
+      ServiceListFrame(service_list, response_frame);
+      return true;
+    }
+
+    case CommandCode::PARAMETER_FOR_VALUE_ACQUISITION:
+    case CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2: {
+      uint16_t lun = 0;
+      uint16_t sample_rate = 0;
+      uint16_t nof_meas = 0;
+      offset += Asap3Helper::ToMc3Value(body, offset, lun);
+      offset += Asap3Helper::ToMc3Value(body, offset, sample_rate);
+      offset += Asap3Helper::ToMc3Value(body, offset, nof_meas);
+      if (nof_meas == 0) {
+        session.name_list_.clear();
+      }
+      for (uint16_t meas = 0; meas < nof_meas; ++meas) {
+        std::string name;
+        offset += Asap3Helper::ToMc3Value(body, offset, name);
+        session.name_list_.push_back(name);
+      }
+      session.generation_ = 0;
+      session.ev2_ =
+          command == CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2;
+      UpdateSubscription();
+      break;
+    }
+
+    case CommandCode::GET_ONLINE_VALUE:
+    case CommandCode::GET_ONLINE_VALUE_EV2:
+      // The EV2 response has typed values. The plain one follows the
+      // acquisition command.
+      ++nof_cache_hits_;
+      OnlineValues(session,
+                   command == CommandCode::GET_ONLINE_VALUE_EV2 ||
+                       session.ev2_,
+                   data_list);
+      break;
+
+    case CommandCode::EXECUTE_SERVICE: {
+      std::string service;
+      Asap3Helper::ToMc3Value(body, offset, service);
+      if (IsHiddenService(service)) {
+        ErrorFrame(command, "Not available through the proxy: " + service,
+                   response_frame);
+        return true;
+      }
+      [[fallthrough]];
+    }
+
+    default: {
+      const bool cache = IsCacheable(command, body, offset);
+      if (cache) {
+        std::scoped_lock lock(locker_);
+        if (const auto itr = response_cache_.find(body);
+            itr != response_cache_.cend()) {
+          ++nof_cache_hits_;
+          response_frame = itr->second;
+          return true;
+        }
+      }
+      Forward(session, body, cache);
+      return false;
+    }
+  }
+  response.DataList(data_list);
+  response.CreateBody(response_frame);
+  return true;
+}
+
+void Asap3Proxy::Forward(ProxySession& session,
+                         const std::vector<uint8_t>& body, bool cache) {
+  ++nof_forwarded_;
+  uint16_t cmd = 0;
+  Asap3Helper::ToMc3Value(body, 0, cmd);
+  const auto command = static_cast<CommandCode>(cmd);
+
+  // The request is sent as is. Everything between the command and the
+  // checksum is a raw payload.
+  auto request = std::make_unique<IRequest>(command, DataValueList());
+  request->Payload({body.begin() + 2, body.end() - 2});
+  request->KeepRawResponse(true);
+
+  // The pending response keeps the session alive
+  auto self = session.shared_from_this();
+  auto key = cache ? body : std::vector<uint8_t>();
+  auto on_response = [this, self, command, key = std::move(key)](
+                         bool, const ITelegram& telegram) {
+    std::vector<uint8_t> frame;
+    const auto* response = telegram.Response();
+    if (command == CommandCode::QUERY_AVAILABLE_SERVICE &&
+        response != nullptr &&
+        response->Status() == StatusCode::STATUS_OK) {
+      // The upstream client has stored the list
+      ServiceListFrame(client_->AvailableServices(), frame);
+    } else if (response != nullptr && !response->RawBody().empty()) {
+      const auto& raw_body = response->RawBody();
+      frame.resize(raw_body.size() + 2);
+      Asap3Helper::FromMc3Value(frame, 0,
+                                static_cast<uint16_t>(frame.size()));
+      std::ranges::copy(raw_body, frame.begin() + 2);
+      if (!key.empty() && response->Status() == StatusCode::STATUS_OK) {
+        std::scoped_lock lock(locker_);
+        response_cache_[key] = frame;
+      }
+    } else {
+      ErrorFrame(command, "No response from the server", frame);
+    }
+    post(context_, [self, frame = std::move(frame)]() mutable {
+      self->Respond(std::move(frame));
+    });
+  };
+  if (!client_->SendTelegram(std::move(request), on_response)) {
+    std::vector<uint8_t> frame;
+    ErrorFrame(command, "Request too large", frame);
+    post(context_, [self, frame = std::move(frame)]() mutable {
+      self->Respond(std::move(frame));
+    });
+  }
+}
+
+}  // namespace asap3
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asap/a3parameter.h"
+#include "asap/asap3factory.h"
+#include "asap/iclient.h"
+#include "asap/nameindex.h"
+
+namespace asap3 {
+
+class ProxySession;
+
+/** \brief Caching ASAP3 proxy in front of one server.
+ *
+ * The proxy keeps one upstream client connection and accepts any number of
+ * downstream ASAP3 clients. The downstream subscriptions are merged into one
+ * upstream acquisition that the proxy polls with a fixed period.
+ * GET_ONLINE_VALUE(_EV2), IDENTIFY and the service queries are answered from
+ * the cache. All other requests are forwarded on the upstream connection, one
+ * at a time. The server load then doesn't grow with the number of clients.
+ *
+ * Parameters are only removed from the upstream acquisition when no
+ * downstream client subscribes anymore. A value is invalid until the
+ * upstream acquisition has reported it.
+ */
+class Asap3Proxy {
+ public:
+  Asap3Proxy();
+  virtual ~Asap3Proxy();
+
+  Asap3Proxy(const Asap3Proxy&) = delete;
+  Asap3Proxy& operator=(const Asap3Proxy&) = delete;
+
+  /// Upstream server.
+  void Host(const std::string& host) { host_ = host; }
+  [[nodiscard]] const std::string& Host() const { return host_; }
+  void UpstreamPort(uint16_t port) { upstream_port_ = port; }
+  [[nodiscard]] uint16_t UpstreamPort() const { return upstream_port_; }
+
+  /// Downstream port. Port 0 selects a free port. The actual port is
+  /// available after start.
+  void Port(uint16_t port) { port_ = port; }
+  [[nodiscard]] uint16_t Port() const { return port_; }
+
+  /// Use CtAsap3Client to get the parameter types from a ComTest server.
+  void ClientType(Asap3ClientType type) { client_type_ = type; }
+  [[nodiscard]] Asap3ClientType ClientType() const { return client_type_; }
+
+  /// Upstream poll period. Default is 10 ms.
+  void PollPeriod(std::chrono::microseconds period) { poll_period_ = period; }
+  [[nodiscard]] std::chrono::microseconds PollPeriod() const {
+    return poll_period_;
+  }
+  void ScanRate(uint16_t scan_rate) { scan_rate_ = scan_rate; }
+  [[nodiscard]] uint16_t ScanRate() const { return scan_rate_; }
+
+  /// EXECUTE_SERVICE calls that are answered from the cache. Default is the
+  /// ComTest parameter and signal queries.
+  void CacheService(const std::string& service, bool cache);
+  [[nodiscard]] bool CacheService(const std::string& service) const;
+
+  bool Start();
+  void Stop();
+  [[nodiscard]] bool IsStarted() const { return started_; }
+
+  /// The upstream client. Valid after start.
+  [[nodiscard]] IClient* Upstream() { return client_.get(); }
+  /// Names in the merged upstream acquisition.
+  [[nodiscard]] std::vector<std::string> Subscription() const;
+
+  [[nodiscard]] uint64_t NofRequests() const { return nof_requests_; }
+  [[nodiscard]] uint64_t NofCacheHits() const { return nof_cache_hits_; }
+  [[nodiscard]] uint64_t NofForwarded() const { return nof_forwarded_; }
+  [[nodiscard]] uint64_t NofUpstreamPolls() const {
+    return nof_upstream_polls_;
+  }
+
+ private:
+  friend class ProxySession;
+
+  std::string host_ = "127.0.0.1";
+  uint16_t upstream_port_ = 22222;
+  uint16_t port_ = 0;
+  Asap3ClientType client_type_ = Asap3ClientType::BasicAsap3Client;
+  std::chrono::microseconds poll_period_ = std::chrono::milliseconds(10);
+  uint16_t scan_rate_ = 0;
+
+  std::unique_ptr<IClient> client_;
+
+  mutable std::mutex locker_;
+  std::set<std::string, std::less<>> cached_service_list_;
+  /// Raw response frames by request body. Cleared on each upstream connect.
+  std::map<std::vector<uint8_t>, std::vector<uint8_t>> response_cache_;
+  A3ParameterList parameter_list_;  ///< Merged acquisition, append only
+  NameIndex parameter_index_;       ///< Index into the merged acquisition
+  uint64_t generation_ = 1;         ///< Stepped when the list is cleared
+  bool subscription_changed_ = false;
+  std::shared_ptr<const DataValueList> snapshot_;  ///< Last upstream poll
+  uint64_t snapshot_generation_ = 0;
+
+  /// Only used by the worker thread.
+  bool upstream_connected_ = false;
+  bool upstream_subscribed_ = false;
+  uint64_t upstream_generation_ = 0;
+  std::atomic<bool> poll_in_flight_ = false;
+
+  boost::asio::io_context context_;
+  std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
+  boost::asio::steady_timer poll_timer_;
+  std::vector<std::weak_ptr<ProxySession>> session_list_;
+  std::thread worker_thread_;
+  std::atomic<bool> started_ = false;
+
+  std::atomic<uint64_t> nof_requests_ = 0;
+  std::atomic<uint64_t> nof_cache_hits_ = 0;
+  std::atomic<uint64_t> nof_forwarded_ = 0;
+  std::atomic<uint64_t> nof_upstream_polls_ = 0;
+
+  void DoAccept();
+  void DoPollTimer();
+  void WorkerThread();
+
+  void Poll();
+  void UpdateSubscription();
+
+  /// Returns false if the request is forwarded. The session is then
+  /// answered when the upstream response arrives.
+  bool HandleRequest(ProxySession& session, const std::vector<uint8_t>& body,
+                     std::vector<uint8_t>& response_frame);
+  /// Typed values or floats as for a plain PARAMETER_FOR_VALUE_ACQUISITION.
+  void OnlineValues(ProxySession& session, bool typed,
+                    DataValueList& value_list);
+  [[nodiscard]] bool IsCacheable(CommandCode command,
+                                 const std::vector<uint8_t>& body,
+                                 size_t offset) const;
+  void Forward(ProxySession& session, const std::vector<uint8_t>& body,
+               bool cache);
+};
+
+}  // namespace asap3
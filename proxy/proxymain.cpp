@@ -0,0 +1,74 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+
+#include "asap3proxy.h"
+
+using namespace boost::program_options;
+using namespace asap3;
+
+int main(int nof_arg, char* arg_list[]) {
+  options_description desc("Caching ASAP3 proxy");
+  desc.add_options()("help,h", "Produce help message")(
+      "port,p", value<uint16_t>()->default_value(22223),
+      "TCP/IP port for the downstream clients")(
+      "host", value<std::string>()->default_value("127.0.0.1"),
+      "Upstream server host")(
+      "upstream-port", value<uint16_t>()->default_value(22222),
+      "Upstream server port")(
+      "poll-period", value<int64_t>()->default_value(10'000),
+      "Upstream poll period (us)")(
+      "scan-rate", value<uint16_t>()->default_value(0), "Upstream scan rate")(
+      "comtest", "Use the ComTest services to get the parameter types");
+
+  variables_map vm;
+  try {
+    store(parse_command_line(nof_arg, arg_list, desc), vm);
+    notify(vm);
+  } catch (const std::exception& err) {
+    std::cerr << err.what() << std::endl << desc << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << desc << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  Asap3Proxy proxy;
+  proxy.Port(vm["port"].as<uint16_t>());
+  proxy.Host(vm["host"].as<std::string>());
+  proxy.UpstreamPort(vm["upstream-port"].as<uint16_t>());
+  proxy.PollPeriod(std::chrono::microseconds(vm["poll-period"].as<int64_t>()));
+  proxy.ScanRate(vm["scan-rate"].as<uint16_t>());
+  if (vm.count("comtest") > 0) {
+    proxy.ClientType(Asap3ClientType::CtAsap3Client);
+  }
+
+  if (!proxy.Start()) {
+    std::cerr << "Failed to start the proxy. Port: " << proxy.Port()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Proxy listening on port " << proxy.Port() << ", upstream "
+            << proxy.Host() << ":" << proxy.UpstreamPort()
+            << ". Press Ctrl-C to stop." << std::endl;
+
+  boost::asio::io_context context;
+  boost::asio::signal_set signals(context, SIGINT, SIGTERM);
+  signals.async_wait([&](const auto&, int) { context.stop(); });
+  context.run();
+
+  std::cout << "Requests: " << proxy.NofRequests()
+            << ", Cache Hits: " << proxy.NofCacheHits()
+            << ", Forwarded: " << proxy.NofForwarded()
+            << ", Upstream Polls: " << proxy.NofUpstreamPolls() << std::endl;
+  proxy.Stop();
+  return EXIT_SUCCESS;
+}
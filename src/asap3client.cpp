@@ -5,6 +5,8 @@
 
 #include "asap3client.h"
 
+#include <util/timestamp.h>
+
 #include <chrono>
 #include <functional>
 #include <sstream>
@@ -27,7 +29,9 @@ asap3::DataValueList kIdentifyList = {
 namespace asap3 {
 
 Asap3Client::Asap3Client()
-    : resolver_(context_), retry_timer_(context_), deadlock_timer_(context_) {
+    : retry_timer_(context_),
+      deadlock_timer_(context_),
+      setpoint_timer_(context_) {
   short_data_.resize(2, 0);
 }
 
@@ -48,8 +52,17 @@ bool Asap3Client::Start() {
   listen_->PreText(Name());
   listen_->ListenOut() << "Starting ASAP3 client";
   telegram_queue_.Clear();
+  metrics_.QueueClear();
+  if (!MetricsFile().empty() || !MetricsSocket().empty()) {
+    exporter_ = std::make_unique<MetricsExporter>(context_, *this);
+    exporter_->Start(MetricsFile(), MetricsSocket(), MetricsPeriod());
+  }
   stop_thread_ = false;
   worker_thread_ = std::thread(&Asap3Client::WorkerThread, this);
+  stop_trace_ = false;
+  if (IsTracing()) {
+    StartTraceThread();
+  }
 
   return true;
 }
@@ -70,6 +83,16 @@ bool Asap3Client::Stop() {
   if (worker_thread_.joinable()) {
     worker_thread_.join();
   }
+  exporter_.reset();
+
+  {
+    std::scoped_lock lock(trace_locker_);
+    stop_trace_ = true;
+  }
+  trace_condition_.notify_all();
+  if (trace_thread_.joinable()) {
+    trace_thread_.join();
+  }
   return true;
 }
 
@@ -83,37 +106,64 @@ void Asap3Client::WorkerThread() {
   }
 }
 
+void Asap3Client::TraceThread() {
+  // Formatting of the traced frames is done here, outside the I/O path. The
+  // thread ends when tracing is turned off. The next traced frame starts it
+  // again.
+  std::unique_lock lock(trace_locker_);
+  while (!stop_trace_ && IsTracing()) {
+    trace_condition_.wait_for(lock, 100ms, [&] { return stop_trace_.load(); });
+    lock.unlock();
+    ListenTrace();
+    lock.lock();
+  }
+  trace_running_ = false;
+  lock.unlock();
+  ListenTrace();
+}
+
+void Asap3Client::StartTraceThread() {
+  if (trace_running_) {
+    return;
+  }
+  std::scoped_lock lock(trace_locker_);
+  if (trace_running_ || stop_trace_) {
+    return;
+  }
+  if (trace_thread_.joinable()) {
+    trace_thread_.join();  // Has already left the loop
+  }
+  trace_running_ = true;
+  trace_thread_ = std::thread(&Asap3Client::TraceThread, this);
+}
+
 void Asap3Client::Close() {
   connected_ = false;
+  setpoint_timer_.cancel();
   StopMessageThread();
-  if (socket_) {
+  if (transport_) {
     try {
-      boost::system::error_code dummy;
-      socket_->shutdown(ip::tcp::socket::shutdown_both, dummy);
-      socket_->close(dummy);
+      transport_->Close();
     } catch (const std::exception& err) {
       listen_->ListenOut() << "Socket close failure. Error: " << err.what();
     }
   }
-  socket_.reset();
+  transport_.reset();
 }
 
 void Asap3Client::DoLookup() {
-  resolver_.async_resolve(
-      host_, std::to_string(port_),
-      [&](const error_code& error, ip::tcp::resolver::results_type result) {
-        if (error) {
-          listen_->ListenOut() << "Lookup failure. Error: " << error.message();
-          DoRetryWait();
-        } else {
-          socket_ = std::make_unique<ip::tcp::socket>(context_);
-          end_points_ = std::move(result);
-          DoConnect();
-        }
-      });
+  transport_ = asap3::Transport::Create(Transport(), context_, host_, port_,
+                                        address_);
+  if (!transport_) {
+    listen_->ListenOut() << "Transport not supported on this platform";
+    DoRetryWait();
+    return;
+  }
+  DoConnect();
 }
 
 void Asap3Client::DoRetryWait() {
+  ++metrics_.reconnects;
   Close();
   retry_timer_.expires_after(5s);
   retry_timer_.async_wait(
@@ -121,29 +171,37 @@ void Asap3Client::DoRetryWait() {
 }
 
 void Asap3Client::DoConnect() {
-  socket_->async_connect(
-      *end_points_, [&](const boost::system::error_code error) {
+  transport_->AsyncConnect(
+      [&](const boost::system::error_code& error) {
         if (error) {
           listen_->ListenOut() << "Connect failure. Error: " << error.message();
           DoRetryWait();
         } else {
           listen_->ListenOut() << "Connected";
+          if (!transport_->ApplyOptions(TcpOptions())) {
+            listen_->ListenOut() << "Failed to set some socket options";
+          }
+          ++metrics_.connects;
           DoReadLength();
           StartMessageThread();
           connected_ = true;
+          if (SetPointPeriod().count() > 0) {
+            setpoint_timer_.expires_after(SetPointPeriod());
+            DoSetPointTimer();
+          }
         }
       });
 }
 
 void Asap3Client::DoReadLength() {  // NOLINT
-  if (!socket_ || !socket_->is_open()) {
+  if (!transport_ || !transport_->IsOpen()) {
     listen_->ListenOut() << "Read length socket close";
     DoRetryWait();
     return;
   }
 
-  async_read(
-      *socket_, boost::asio::buffer(short_data_),
+  transport_->AsyncRead(
+      boost::asio::buffer(short_data_),
       [&](const boost::system::error_code& error, size_t bytes) {  // NOLINT
         if (error && error == error::eof) {
           listen_->ListenOut()
@@ -158,6 +216,7 @@ void Asap3Client::DoReadLength() {  // NOLINT
                                << short_data_.size() << ", Read: " << bytes;
           DoRetryWait();
         } else {
+          first_byte_time_ = std::chrono::steady_clock::now();
           uint16_t length = 0;
           Asap3Helper::ToMc3Value(short_data_, 0, length);
           if (length >= 8) {
@@ -174,19 +233,20 @@ void Asap3Client::DoReadLength() {  // NOLINT
 }
 
 void Asap3Client::DoReadBody() {  // NOLINT
-  if (!socket_ || !socket_->is_open()) {
+  if (!transport_ || !transport_->IsOpen()) {
     DoRetryWait();
     return;
   }
   deadlock_timer_.expires_after(10s);
   deadlock_timer_.async_wait([&](const error_code error) {
     if (error != error::operation_aborted) {
+      ++metrics_.deadlock_timeouts;
       listen_->ListenOut() << "Read body error. Error: " << error.message();
       DoRetryWait();  // If timer expires, then disconnect
     }
   });
 
-  async_read(*socket_, buffer(body_data_),
+  transport_->AsyncRead(buffer(body_data_),
              [&](const error_code& error, size_t bytes) {  // NOLINT
                deadlock_timer_.cancel();
                if (error) {
@@ -199,6 +259,15 @@ void Asap3Client::DoReadBody() {  // NOLINT
                      << body_data_.size() << ", Read: " << bytes;
                  DoRetryWait();
                } else {
+                 receive_time_ = std::chrono::steady_clock::now();
+                 ++metrics_.frames_in;
+                 metrics_.bytes_in += bytes + short_data_.size();
+                 if (IsTracing()) {
+                   StartTraceThread();
+                   trace_ring_.Write(TraceDirection::Receive,
+                                     util::time::TimeStampToNs(), short_data_,
+                                     body_data_);
+                 }
                  HandleResponse();
                  if (restart_) {
                    restart_ = false;
@@ -210,20 +279,48 @@ void Asap3Client::DoReadBody() {  // NOLINT
              });
 }
 
+void Asap3Client::DoSetPointTimer() {  // NOLINT
+  setpoint_timer_.async_wait([&](const error_code error) {
+    if (error || !connected_) {
+      return;
+    }
+    FlushSetPoints();
+    // Fixed cycle without drift
+    setpoint_timer_.expires_at(setpoint_timer_.expiry() + SetPointPeriod());
+    DoSetPointTimer();
+  });
+}
+
 void Asap3Client::HandleResponse() {
   std::unique_ptr<IResponse> response =
       std::make_unique<IResponse>(this, body_data_);
   ListenResponse(*response);
+  if (response->InvalidChecksum()) {
+    ++metrics_.checksum_failures;
+  }
+  if (Unacknowledged(response->Cmd())) {
+    // Not related to the current message
+    HandleAsyncResponse(*response);
+    return;
+  }
   const auto status = response->Status();
   const auto& response_list = response->DataList();
   const auto* request =
       current_message_ ? current_message_->Request() : nullptr;
   if (request != nullptr && request->Cmd() == response->Cmd()) {
+    if (request->KeepRawResponse()) {
+      response->RawBody(body_data_);
+    }
     current_message_->Response(response);
   }
+  if (current_message_) {
+    current_message_->FirstByteTime(first_byte_time_);
+    current_message_->ReceiveTime(receive_time_);
+  }
 
   switch (status) {
     case StatusCode::STATUS_NOT_PROCESSED:
+      ++metrics_.not_processed;
       restart_ = true;
       response_handled_ = true;
       // message_condition_.notify_all();
@@ -234,12 +331,14 @@ void Asap3Client::HandleResponse() {
       break;
 
     case StatusCode::STATUS_REPEAT_CMD:
+      ++metrics_.repeats;
       if (request != nullptr) {
         HandleRequest(*request);
       }
       break;
 
     case StatusCode::STATUS_ERROR: {
+      ++metrics_.error_responses;
       const auto error_code =
           response_list.empty()
               ? 0
@@ -251,6 +350,7 @@ void Asap3Client::HandleResponse() {
       listen_->ListenOut() << "Error message. Error: " << error_code << ":"
                            << error;
       HandleTelegram(*current_message_);
+      RecordLatency(*current_message_);
       response_handled_ = true;
       message_condition_.notify_all();
       break;
@@ -263,6 +363,7 @@ void Asap3Client::HandleResponse() {
     case StatusCode::STATUS_OK:
     default:
       HandleTelegram(*current_message_);
+      RecordLatency(*current_message_);
       response_handled_ = true;
       message_condition_.notify_all();
       break;
@@ -270,14 +371,67 @@ void Asap3Client::HandleResponse() {
   response.reset();
 }
 
+void Asap3Client::HandleAsyncResponse(const IResponse& response) {
+  const auto status = response.Status();
+  if (status == StatusCode::STATUS_MEASURING_DATA_CHANGED) {
+    InvalidateCalibration();
+    return;
+  }
+  if (status == StatusCode::STATUS_OK || status == StatusCode::STATUS_SUCCESS) {
+    return;  // The server acknowledged anyway
+  }
+  ++metrics_.async_errors;
+  uint16_t error_code = 0;
+  std::string error(Asap3Helper::StatusCodeToText(status));
+  const auto& response_list = response.DataList();
+  if (status == StatusCode::STATUS_ERROR) {
+    ++metrics_.error_responses;
+    if (const auto* code = response_list.empty()
+                               ? nullptr
+                               : std::any_cast<uint16_t>(
+                                     &response_list[0].value)) {
+      error_code = *code;
+    }
+    if (const auto* text = response_list.size() <= 1
+                               ? nullptr
+                               : std::any_cast<std::string>(
+                                     &response_list[1].value)) {
+      error = *text;
+    }
+  }
+  listen_->ListenOut() << "Asynchronous error. Command: "
+                       << Asap3Helper::CommandCodeToText(response.Cmd())
+                       << ", Error: " << error_code << ":" << error;
+  if (async_error_function_) {
+    async_error_function_(response.Cmd(), error_code, error);
+  }
+}
+
 void Asap3Client::MessageThread() {
   while (!stop_message_) {
     const bool message = telegram_queue_.Get(current_message_, true);
+    if (message) {
+      metrics_.QueueGet();
+    }
     if (message && !stop_message_ && current_message_ &&
         current_message_->Request() != nullptr) {
       response_handled_ = false;
+      current_message_->SendTime(std::chrono::steady_clock::now());
       HandleRequest(
           *current_message_->Request());  // Send this message to server
+      if (Unacknowledged(current_message_->Request()->Cmd())) {
+        // Fire and forget. Only wait until the frame is written as the
+        // transmit buffer is reused.
+        std::unique_lock lock(locker_);
+        message_condition_.wait_for(lock, 10s, [&] {
+          return !write_pending_.load() || stop_message_.load();
+        });
+        lock.unlock();
+        current_message_->OnComplete(!write_pending_ && write_ok_);
+        response_handled_ = true;
+        current_message_.reset();
+        continue;
+      }
       // Wait on response on this message before
       for (size_t timeout = 0;
            !response_handled_ && !stop_message_ && timeout < 600; ++timeout) {
@@ -286,6 +440,12 @@ void Asap3Client::MessageThread() {
           return response_handled_.load() || stop_message_.load();
         });
       }
+      if (!response_handled_ && !stop_message_) {
+        ++metrics_.message_timeouts;
+        listen_->ListenOut() << "Message timeout. Command: "
+                             << Asap3Helper::CommandCodeToText(
+                                    current_message_->Request()->Cmd());
+      }
       current_message_.reset();
     }
   }
@@ -295,6 +455,10 @@ void Asap3Client::StartMessageThread() {
   StopMessageThread();  // Just in case it is running.
   stop_message_ = false;
   telegram_queue_.Clear();
+  metrics_.QueueClear();
+  ResetSetPoints();  // Cleared telegrams are never completed
+  ClearUnacknowledged();
+  CloseSharedValues();
   telegram_queue_.Start();
   message_thread_ = std::thread(&Asap3Client::MessageThread, this);
   SendTelegram(CommandCode::INIT, kEmptyList);
@@ -329,13 +493,28 @@ void Asap3Client::StopMessageThread() {
 void Asap3Client::HandleRequest(const IRequest& request) {
   transmit_data_.clear();
   request.CreateBody(transmit_data_);
+  if (IsTracing()) {
+    StartTraceThread();
+    trace_ring_.Write(TraceDirection::Transmit, util::time::TimeStampToNs(),
+                      transmit_data_);
+  }
   ListenRequest(request);
-  async_write(*socket_, buffer(transmit_data_),
+  write_pending_ = true;
+  transport_->AsyncWrite(buffer(transmit_data_),
               [&](const error_code& error, size_t nof_bytes) {
                 if (error) {
                   listen_->ListenOut()
                       << "Write error. Error: " << error.message();
+                } else {
+                  ++metrics_.frames_out;
+                  metrics_.bytes_out += nof_bytes;
+                }
+                {
+                  std::scoped_lock lock(locker_);
+                  write_ok_ = !error;
+                  write_pending_ = false;
                 }
+                message_condition_.notify_all();
               });
 }
 
@@ -13,6 +13,8 @@
 #include <vector>
 
 #include "asap/iclient.h"
+#include "metricsexporter.h"
+#include "transport.h"
 
 namespace asap3 {
 
@@ -35,14 +37,17 @@ class Asap3Client : public IClient {
   std::condition_variable message_condition_;
   std::unique_ptr<ITelegram> current_message_;
   std::atomic<bool> response_handled_ = true;
+  std::atomic<bool> write_pending_ = false;
+  std::atomic<bool> write_ok_ = true;
 
   boost::asio::io_context context_;
-  boost::asio::ip::tcp::resolver resolver_;
   boost::asio::steady_timer retry_timer_;
   boost::asio::steady_timer deadlock_timer_;
+  boost::asio::steady_timer setpoint_timer_;
 
-  std::unique_ptr<boost::asio::ip::tcp::socket> socket_;
-  boost::asio::ip::tcp::resolver::results_type end_points_;
+  std::unique_ptr<MetricsExporter> exporter_;
+
+  std::unique_ptr<asap3::Transport> transport_;
 
   std::vector<uint8_t> short_data_;  ///< Length receive buffer
   std::vector<uint8_t>
@@ -51,15 +56,28 @@ class Asap3Client : public IClient {
 
   std::atomic<bool> restart_ = false;
 
+  std::thread trace_thread_;
+  std::atomic<bool> stop_trace_ = true;
+  std::atomic<bool> trace_running_ = false;
+  std::mutex trace_locker_;
+  std::condition_variable trace_condition_;
+
+  ITelegram::TimePoint first_byte_time_ = {};  ///< First byte of response
+  ITelegram::TimePoint receive_time_ = {};     ///< Full response received
+
   void WorkerThread();
   void MessageThread();
+  void TraceThread();
+  void StartTraceThread();
   void DoLookup();
   void DoRetryWait();
   void DoConnect();
   void DoReadLength();
   void DoReadBody();
+  void DoSetPointTimer();
 
   void HandleResponse();
+  void HandleAsyncResponse(const IResponse& response);
   void HandleRequest(const IRequest& request);
   void Close();
   virtual void StartMessageThread();
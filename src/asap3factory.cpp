@@ -5,6 +5,7 @@
 
 #include "asap/asap3factory.h"
 
+#include "ctasap3client.h"
 #include "queryparameters.h"
 
 namespace asap3 {
@@ -18,6 +19,12 @@ std::unique_ptr<IClient> Asap3Factory::CreateAsap3Client(Asap3ClientType type) {
       break;
     }
 
+    case Asap3ClientType::CtAsap3Client: {
+      auto temp = std::make_unique<CtAsap3Client>();
+      client = std::move(temp);
+      break;
+    }
+
     case Asap3ClientType::BasicAsap3Client:
     default: {
       auto temp = std::make_unique<Asap3Client>();
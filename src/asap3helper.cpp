@@ -7,16 +7,239 @@
 
 #include <util/stringutil.h>
 
-#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 using namespace util::string;
 
 namespace {
 const std::vector<uint8_t> kInvalidFloatBuffer = {0xFF, 0x00, 0x00, 0x00};
+
+using asap3::CommandCode;
+using asap3::StatusCode;
+
+struct CommandText {
+  CommandCode code;
+  std::string_view text;
+};
+
+struct StatusText {
+  StatusCode code;
+  std::string_view text;
+};
+
+constexpr CommandText kCommandList[] = {
+    {CommandCode::REPEAT_REQUEST, "REPEAT REQUEST"},
+    {CommandCode::EMERGENCY, "EMERGENCY"},
+    {CommandCode::INIT, "INIT"},
+    {CommandCode::SELECT_DESCRIPTION_FILE_AND_BINARY_FILE,
+     "SELECT DESCRIPTION FILE AND BINARY_FILE"},
+    {CommandCode::COPY_BINARY_FILE, "COPY BINARY FILE"},
+    {CommandCode::CHANGE_BINARY_FILE, "CHANGE BINARY FILE"},
+    {CommandCode::SELECT_LOOKUP_TABLE, "SELECT LOOKUP TABLE"},
+    {CommandCode::PUT_LOOKUP_TABLE, "PUT LOOKUP TABLE"},
+    {CommandCode::GET_LOOKUP_TABLE, "GET LOOKUP TABLE"},
+    {CommandCode::INCREASE_LOOKUP_TABLE, "INCREASE LOOKUP TABLE"},
+    {CommandCode::PARAMETER_FOR_VALUE_ACQUISITION,
+     "PARAMETER FOR VALUE ACQUISITION"},
+    {CommandCode::SWITCHING_OFFLINE_ONLINE, "SWITCHING OFFLINE ONLINE"},
+    {CommandCode::GET_PARAMETER, "GET PARAMETER"},
+    {CommandCode::SET_PARAMETER, "SET PARAMETER"},
+    {CommandCode::SET_GRAPHIC_MODE, "SET GRAPHIC MODE"},
+    {CommandCode::RESET_DEVICE, "RESET DEVICE"},
+    {CommandCode::SET_FORMAT, "SET FORMAT"},
+    {CommandCode::GET_ONLINE_VALUE, "GET ONLINE VALUE"},
+    {CommandCode::IDENTIFY, "IDENTIFY"},
+    {CommandCode::GET_USER_DEFINED_VALUE, "GET USER DEFINED VALUE"},
+    {CommandCode::GET_USER_DEFINED_VALUE_LIST, "GET USER DEFINED VALUE_LIST"},
+    {CommandCode::DEFINE_DESCRIPTION_FILE_AND_BINARY_FILE,
+     "DEFINE DESCRIPTION FILE AND BINARY FILE"},
+    {CommandCode::EXIT, "EXIT"},
+    {CommandCode::DEFINE_RECORDER_PARAMETERS, "DEFINE RECORDER PARAMETERS"},
+    {CommandCode::DEFINE_TRIGGER_CONDITION, "DEFINE TRIGGER CONDITION"},
+    {CommandCode::ACTIVATE_RECORDER, "ACTIVATE RECORDER"},
+    {CommandCode::GET_RECODER_STATUS, "GET RECODER STATUS"},
+    {CommandCode::GET_RECORDER_RESULT_HEADER, "GET RECORDER RESULT HEADER"},
+    {CommandCode::GET_RECORDER_RESULTS, "GET RECORDER RESULTS"},
+    {CommandCode::SAVE_RECORDER_FILE, "SAVE RECORDER FILE"},
+    {CommandCode::LOAD_RECORDER_FILE, "LOAD RECORDER FILE"},
+    {CommandCode::SET_CASE_SENSITIVE_LABELS, "SET CASE SENSITIVE LABELS"},
+    {CommandCode::PUT_LOOKUP_TABLE_EV2, "PUT LOOKUP TABLE EV2"},
+    {CommandCode::GET_LOOKUP_TABLE_EV2, "GET LOOKUP TABLE EV2"},
+    {CommandCode::INCREASE_LOOKUP_TABLE_EV2, "INCREASE LOOKUP TABLE EV2"},
+    {CommandCode::SELECT_LOOKUP_TABLE_EV2, "SELECT LOOKUP TABLE EV2"},
+    {CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2,
+     "PARAMETER FOR VALUE ACQUISITION EV2"},
+    {CommandCode::GET_PARAMETER_EV2, "GET PARAMETER EV2"},
+    {CommandCode::SET_PARAMETER_EV2, "SET PARAMETER EV2"},
+    {CommandCode::GET_ONLINE_VALUE_EV2, "GET ONLINE VALUE EV2"},
+    {CommandCode::GET_RECODER_RESULTS_EV2, "GET RECODER RESULTS EV2"},
+    {CommandCode::GET_RECORDER_RESULT_DATA_EV2, "GET RECORDER RESULT DATA EV2"},
+    {CommandCode::GET_CALPAGE_INFO, "GET CALPAGE INFO"},
+    {CommandCode::GET_CURRENT_CALPAGE, "GET CURRENT CALPAGE"},
+    {CommandCode::GET_MEASUREMENT_INFO, "GET MEASUREMENT INFO"},
+    {CommandCode::GET_RASTER_OVERVIEW, "GET RASTER OVERVIEW"},
+    {CommandCode::GET_CHARACTERISTIC_INFO, "GET CHARACTERISTIC INFO"},
+    {CommandCode::READ_CHARACTERISTIC, "READ CHARACTERISTIC"},
+    {CommandCode::READ_CELL_VALUES, "READ CELL VALUES"},
+    {CommandCode::WRITE_CHARACTERISTIC, "WRITE CHARACTERISTIC"},
+    {CommandCode::WRITE_CELL_VALUES, "WRITE CELL VALUES"},
+    {CommandCode::SELECT_CHARACTERISTIC, "SELECT CHARACTERISTIC"},
+    {CommandCode::QUERY_AVAILABLE_SERVICE, "QUERY AVAILABLE SERVICE"},
+    {CommandCode::GET_SERVICE_INFORMATION, "GET SERVICE INFORMATION"},
+    {CommandCode::EXECUTE_SERVICE, "EXECUTE SERVICE"},
+};
+
+// All command codes are less than 256, so the text is found by indexing.
+constexpr auto kCommandTextList = [] {
+  std::array<std::string_view, 256> list = {};
+  for (const auto &[code, text] : kCommandList) {
+    list[static_cast<uint16_t>(code)] = text;
+  }
+  return list;
+}();
+
+constexpr StatusText kStatusTextList[] = {
+    {StatusCode::STATUS_OK, "OK"},
+    {StatusCode::STATUS_SUCCESS, "SUCCESS"},
+    {StatusCode::STATUS_NOT_PROCESSED, "NOT PROCESSED"},
+    {StatusCode::STATUS_MEASURING_DATA_CHANGED, "MEASURING DATA CHANGED"},
+    {StatusCode::STATUS_RESERVED, "RESERVED"},
+    {StatusCode::STATUS_CMD_NOT_AVAILABLE, "CMD NOT AVAILABLE"},
+    {StatusCode::STATUS_ACK, "ACK"},
+    {StatusCode::STATUS_REPEAT_CMD, "REPEAT CMD"},
+    {StatusCode::STATUS_ERROR, "ERROR"},
+};
+
+std::string_view TrimText(std::string_view text) {
+  constexpr std::string_view kWhiteSpace = " \t\r\n";
+  const auto first = text.find_first_not_of(kWhiteSpace);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = text.find_last_not_of(kWhiteSpace);
+  return text.substr(first, last - first + 1);
+}
+
+// Invalid numbers are ignored and the default value is kept.
+template <typename T>
+T ToNumber(std::string_view text, T default_value) {
+  if (!text.empty() && text.front() == '+') {
+    text.remove_prefix(1);
+  }
+  T value = default_value;
+  const auto [ptr, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc() ? value : default_value;
+}
+
+using asap3::A3Parameter;
+using asap3::Mc3DataType;
+
+struct ConfigKey {
+  std::string_view key;
+  void (*parse)(A3Parameter &parameter, std::string_view value);
+};
+
+// Keys in a ComTest parameter configuration. The "Name" key is handled
+// separately as it starts a new parameter.
+constexpr ConfigKey kConfigKeyList[] = {
+    {"Unit",
+     [](A3Parameter &par, std::string_view value) {
+       par.Unit(std::string(value));
+     }},
+    {"Type",
+     [](A3Parameter &par, std::string_view value) {
+       par.Type(static_cast<Mc3DataType>(
+           ToNumber(value, static_cast<int>(par.Type()))));
+     }},
+    {"Max",
+     [](A3Parameter &par, std::string_view value) {
+       par.Max(ToNumber(value, par.Max()));
+     }},
+    {"Min",
+     [](A3Parameter &par, std::string_view value) {
+       par.Min(ToNumber(value, par.Min()));
+     }},
+    {"Descr",
+     [](A3Parameter &par, std::string_view value) {
+       par.Description(std::string(value));
+     }},
+    {"Device",
+     [](A3Parameter &par, std::string_view value) {
+       par.Device(std::string(value));
+     }},
+    {"Id",
+     [](A3Parameter &par, std::string_view value) {
+       par.Identity(std::string(value));
+     }},
+    {"Signal",
+     [](A3Parameter &par, std::string_view value) {
+       par.Signal(std::string(value));
+     }},
+    {"SetPoint",
+     [](A3Parameter &par, std::string_view value) {
+       par.SetPoint(ToNumber(value, par.SetPoint() ? 1 : 0) == 1);
+     }},
+    {"Dpname",
+     [](A3Parameter &par, std::string_view value) {
+       par.DisplayName(std::string(value));
+     }},
+    {"Cycle",
+     [](A3Parameter &par, std::string_view value) {
+       par.CycleTime(ToNumber(value, par.CycleTime()));
+     }},
+    {"NofDec",
+     [](A3Parameter &par, std::string_view value) {
+       par.NofDecimals(static_cast<uint8_t>(
+           ToNumber(value, static_cast<int>(par.NofDecimals()))));
+     }},
+    {"Lun",
+     [](A3Parameter &par, std::string_view value) {
+       par.LunNo(static_cast<uint16_t>(
+           ToNumber(value, static_cast<int>(par.LunNo()))));
+     }},
+};
+
+// Same format as the default ostream output, i.e. %g with 6 digits.
+template <typename T>
+void AppendValue(const std::any &value, std::string &dest) {
+  const auto *temp = std::any_cast<T>(&value);
+  if (temp == nullptr) {
+    return;
+  }
+  std::array<char, 32> buffer = {};
+  std::to_chars_result result;
+  if constexpr (std::is_floating_point_v<T>) {
+    result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), *temp,
+                           std::chars_format::general, 6);
+  } else {
+    result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), *temp);
+  }
+  if (result.ec == std::errc()) {
+    dest.append(buffer.data(), result.ptr);
+  }
+}
+
+// Bulk arrays are only shown by size
+void AppendPayload(const std::vector<uint8_t> &payload, std::string &dest) {
+  if (payload.empty()) {
+    return;
+  }
+  std::array<char, 32> buffer = {};
+  const auto result = std::to_chars(
+      buffer.data(), buffer.data() + buffer.size(), payload.size());
+  dest += ", Payload: ";
+  dest.append(buffer.data(), result.ptr);
+  dest += " bytes";
 }
 
+}  // namespace
+
 namespace asap3 {
 
 uint16_t Asap3Helper::Checksum(const std::vector<uint8_t> &message) {
@@ -247,228 +470,112 @@ void Asap3Helper::BodyToDataList(const std::vector<uint8_t> &body,
 
 std::string Asap3Helper::DataListToText(
     const std::vector<DataValue> &data_list) {
-  std::ostringstream temp;
-  for (const auto &data : data_list) {
-    if (!temp.str().empty()) {
-      temp << ", ";
+  std::string temp;
+  DataListToText(data_list, temp);
+  return temp;
+}
+
+void Asap3Helper::DataListToText(const std::vector<DataValue> &data_list,
+                                 std::string &dest) {
+  for (size_t index = 0; index < data_list.size(); ++index) {
+    if (index > 0) {
+      dest += ", ";
     }
-    temp << data.name << ": ";
-    switch (data.type) {
-      case Mc3DataType::A_FLOAT64: {
-        const auto value = std::any_cast<double>(data.value);
-        temp << value;
-        break;
-      }
+    DataValueToText(data_list[index], dest);
+  }
+}
 
-      case Mc3DataType::MC3_STRING: {
-        const auto value = std::any_cast<std::string>(data.value);
-        temp << value;
-        break;
-      }
+void Asap3Helper::DataValueToText(const DataValue &data, std::string &dest) {
+  dest += data.name;
+  dest += ": ";
+  switch (data.type) {
+    case Mc3DataType::A_FLOAT64:
+      AppendValue<double>(data.value, dest);
+      break;
 
-      case Mc3DataType::A_INT16: {
-        const auto value = std::any_cast<int16_t>(data.value);
-        temp << value;
-        break;
+    case Mc3DataType::MC3_STRING:
+      if (const auto *value = std::any_cast<std::string>(&data.value);
+          value != nullptr) {
+        dest += *value;
       }
+      break;
 
-      case Mc3DataType::A_UINT16: {
-        const auto value = std::any_cast<uint16_t>(data.value);
-        temp << value;
-        break;
-      }
+    case Mc3DataType::A_INT16:
+      AppendValue<int16_t>(data.value, dest);
+      break;
 
-      case Mc3DataType::A_INT32: {
-        const auto value = std::any_cast<int32_t>(data.value);
-        temp << value;
-        break;
-      }
+    case Mc3DataType::A_UINT16:
+      AppendValue<uint16_t>(data.value, dest);
+      break;
 
-      case Mc3DataType::A_UINT32: {
-        const auto value = std::any_cast<uint32_t>(data.value);
-        temp << value;
-        break;
-      }
+    case Mc3DataType::A_INT32:
+      AppendValue<int32_t>(data.value, dest);
+      break;
 
-      case Mc3DataType::A_INT64: {
-        const auto value = std::any_cast<int64_t>(data.value);
-        temp << value;
-        break;
-      }
+    case Mc3DataType::A_UINT32:
+      AppendValue<uint32_t>(data.value, dest);
+      break;
 
-      case Mc3DataType::A_UINT64: {
-        const auto value = std::any_cast<uint64_t>(data.value);
-        temp << value;
-        break;
-      }
+    case Mc3DataType::A_INT64:
+      AppendValue<int64_t>(data.value, dest);
+      break;
 
-      case Mc3DataType::A_FLOAT32:
-      default: {
-        const auto value = std::any_cast<float>(data.value);
-        temp << value;
-        break;
-      }
-    }
-  }
-  return temp.str();
-}
+    case Mc3DataType::A_UINT64:
+      AppendValue<uint64_t>(data.value, dest);
+      break;
 
-std::string Asap3Helper::CommandCodeToText(CommandCode command) {
-  switch (command) {
-    case CommandCode::REPEAT_REQUEST:
-      return "REPEAT REQUEST";
-    case CommandCode::EMERGENCY:
-      return "EMERGENCY";
-    case CommandCode::INIT:
-      return "INIT";
-    case CommandCode::SELECT_DESCRIPTION_FILE_AND_BINARY_FILE:
-      return "SELECT DESCRIPTION FILE AND BINARY_FILE";
-    case CommandCode::COPY_BINARY_FILE:
-      return "COPY BINARY FILE";
-    case CommandCode::CHANGE_BINARY_FILE:
-      return "CHANGE BINARY FILE";
-    case CommandCode::SELECT_LOOKUP_TABLE:
-      return "SELECT LOOKUP TABLE";
-    case CommandCode::PUT_LOOKUP_TABLE:
-      return "PUT LOOKUP TABLE";
-    case CommandCode::GET_LOOKUP_TABLE:
-      return "GET LOOKUP TABLE";
-    case CommandCode::INCREASE_LOOKUP_TABLE:
-      return "INCREASE LOOKUP TABLE";
-    case CommandCode::PARAMETER_FOR_VALUE_ACQUISITION:
-      return "PARAMETER FOR VALUE ACQUISITION";
-    case CommandCode::SWITCHING_OFFLINE_ONLINE:
-      return "SWITCHING OFFLINE ONLINE";
-    case CommandCode::GET_PARAMETER:
-      return "GET PARAMETER";
-    case CommandCode::SET_PARAMETER:
-      return "SET PARAMETER";
-    case CommandCode::SET_GRAPHIC_MODE:
-      return "SET GRAPHIC MODE";
-    case CommandCode::RESET_DEVICE:
-      return "RESET DEVICE";
-    case CommandCode::SET_FORMAT:
-      return "SET FORMAT";
-    case CommandCode::GET_ONLINE_VALUE:
-      return "GET ONLINE VALUE";
-    case CommandCode::IDENTIFY:
-      return "IDENTIFY";
-    case CommandCode::GET_USER_DEFINED_VALUE:
-      return "GET USER DEFINED VALUE";
-    case CommandCode::GET_USER_DEFINED_VALUE_LIST:
-      return "GET USER DEFINED VALUE_LIST";
-    case CommandCode::DEFINE_DESCRIPTION_FILE_AND_BINARY_FILE:
-      return "DEFINE DESCRIPTION FILE AND BINARY FILE";
-    case CommandCode::EXIT:
-      return "EXIT";
-    case CommandCode::DEFINE_RECORDER_PARAMETERS:
-      return "DEFINE RECORDER PARAMETERS";
-    case CommandCode::DEFINE_TRIGGER_CONDITION:
-      return "DEFINE TRIGGER CONDITION";
-    case CommandCode::ACTIVATE_RECORDER:
-      return "ACTIVATE RECORDER";
-    case CommandCode::GET_RECODER_STATUS:
-      return "GET RECODER STATUS";
-    case CommandCode::GET_RECORDER_RESULT_HEADER:
-      return "GET RECORDER RESULT HEADER";
-    case CommandCode::GET_RECORDER_RESULTS:
-      return "GET RECORDER RESULTS";
-    case CommandCode::SAVE_RECORDER_FILE:
-      return "SAVE RECORDER FILE";
-    case CommandCode::LOAD_RECORDER_FILE:
-      return "LOAD RECORDER FILE";
-    case CommandCode::SET_CASE_SENSITIVE_LABELS:
-      return "SET CASE SENSITIVE LABELS";
-    case CommandCode::PUT_LOOKUP_TABLE_EV2:
-      return "PUT LOOKUP TABLE EV2";
-    case CommandCode::GET_LOOKUP_TABLE_EV2:
-      return "GET LOOKUP TABLE EV2";
-    case CommandCode::INCREASE_LOOKUP_TABLE_EV2:
-      return "INCREASE LOOKUP TABLE EV2";
-    case CommandCode::SELECT_LOOKUP_TABLE_EV2:
-      return "SELECT LOOKUP TABLE EV2";
-    case CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2:
-      return "PARAMETER FOR VALUE ACQUISITION EV2";
-    case CommandCode::GET_PARAMETER_EV2:
-      return "GET PARAMETER EV2";
-    case CommandCode::SET_PARAMETER_EV2:
-      return "SET PARAMETER EV2";
-    case CommandCode::GET_ONLINE_VALUE_EV2:
-      return "GET ONLINE VALUE EV2";
-    case CommandCode::GET_RECODER_RESULTS_EV2:
-      return "GET RECODER RESULTS EV2";
-    case CommandCode::GET_RECORDER_RESULT_DATA_EV2:
-      return "GET RECORDER RESULT DATA EV2";
-    case CommandCode::GET_CALPAGE_INFO:
-      return "GET CALPAGE INFO";
-    case CommandCode::GET_CURRENT_CALPAGE:
-      return "GET CURRENT CALPAGE";
-    case CommandCode::GET_MEASUREMENT_INFO:
-      return "GET MEASUREMENT INFO";
-    case CommandCode::GET_RASTER_OVERVIEW:
-      return "GET RASTER OVERVIEW";
-    case CommandCode::GET_CHARACTERISTIC_INFO:
-      return "GET CHARACTERISTIC INFO";
-    case CommandCode::READ_CHARACTERISTIC:
-      return "READ CHARACTERISTIC";
-    case CommandCode::READ_CELL_VALUES:
-      return "READ CELL VALUES";
-    case CommandCode::WRITE_CHARACTERISTIC:
-      return "WRITE CHARACTERISTIC";
-    case CommandCode::WRITE_CELL_VALUES:
-      return "WRITE CELL VALUES";
-    case CommandCode::SELECT_CHARACTERISTIC:
-      return "SELECT CHARACTERISTIC";
-    case CommandCode::QUERY_AVAILABLE_SERVICE:
-      return "QUERY AVAILABLE SERVICE";
-    case CommandCode::GET_SERVICE_INFORMATION:
-      return "GET SERVICE INFORMATION";
-    case CommandCode::EXECUTE_SERVICE:
-      return "EXECUTE SERVICE";
+    case Mc3DataType::A_FLOAT32:
     default:
+      AppendValue<float>(data.value, dest);
       break;
   }
-  return {};
 }
 
-std::string Asap3Helper::StatusCodeToText(StatusCode status) {
-  switch (status) {
-    case StatusCode::STATUS_OK:
-      return "OK";
-    case StatusCode::STATUS_SUCCESS:
-      return "SUCCESS";
-    case StatusCode::STATUS_NOT_PROCESSED:
-      return "NOT PROCESSED";
-    case StatusCode::STATUS_MEASURING_DATA_CHANGED:
-      return "MEASURING DATA CHANGED";
-    case StatusCode::STATUS_RESERVED:
-      return "RESERVED";
-    case StatusCode::STATUS_CMD_NOT_AVAILABLE:
-      return "CMD NOT AVAILABLE";
-    case StatusCode::STATUS_ACK:
-      return "ACK";
-    case StatusCode::STATUS_REPEAT_CMD:
-      return "REPEAT CMD";
-    case StatusCode::STATUS_ERROR:
-      return "ERROR";
-    default:
-      break;
+std::string_view Asap3Helper::CommandCodeToText(CommandCode command) {
+  const auto code = static_cast<uint16_t>(command);
+  return code < kCommandTextList.size() ? kCommandTextList[code]
+                                        : std::string_view();
+}
+
+std::string_view Asap3Helper::StatusCodeToText(StatusCode status) {
+  for (const auto &[code, text] : kStatusTextList) {
+    if (code == status) {
+      return text;
+    }
   }
   return {};
 }
 
 std::string Asap3Helper::RequestToPlainText(const IRequest &request) {
-  std::ostringstream temp;
-  temp << "T:" << CommandCodeToText(request.Cmd()) << " "
-       << DataListToText(request.DataList());
-  return temp.str();
+  std::string temp;
+  RequestToPlainText(request, temp);
+  return temp;
+}
+
+void Asap3Helper::RequestToPlainText(const IRequest &request,
+                                     std::string &dest) {
+  dest += "T:";
+  dest += CommandCodeToText(request.Cmd());
+  dest += ' ';
+  DataListToText(request.DataList(), dest);
+  AppendPayload(request.Payload(), dest);
 }
+
 std::string Asap3Helper::ResponseToPlainText(const IResponse &response) {
-  std::ostringstream temp;
-  temp << "R:" << CommandCodeToText(response.Cmd())
-       << " S:" << StatusCodeToText(response.Status()) << " "
-       << DataListToText(response.DataList());
-  return temp.str();
+  std::string temp;
+  ResponseToPlainText(response, temp);
+  return temp;
+}
+
+void Asap3Helper::ResponseToPlainText(const IResponse &response,
+                                      std::string &dest) {
+  dest += "R:";
+  dest += CommandCodeToText(response.Cmd());
+  dest += " S:";
+  dest += StatusCodeToText(response.Status());
+  dest += ' ';
+  DataListToText(response.DataList(), dest);
+  AppendPayload(response.Payload(), dest);
 }
 
 float Asap3Helper::InvalidFloat() {
@@ -477,59 +584,87 @@ float Asap3Helper::InvalidFloat() {
   return temp;
 }
 
+std::any Asap3Helper::DefaultValue(Mc3DataType type) {
+  switch (type) {
+    case Mc3DataType::A_FLOAT64:
+      return 0.0;
+    case Mc3DataType::MC3_STRING:
+      return std::string();
+    case Mc3DataType::A_INT16:
+      return static_cast<int16_t>(0);
+    case Mc3DataType::A_UINT16:
+      return static_cast<uint16_t>(0);
+    case Mc3DataType::A_INT32:
+      return static_cast<int32_t>(0);
+    case Mc3DataType::A_UINT32:
+      return static_cast<uint32_t>(0);
+    case Mc3DataType::A_INT64:
+      return static_cast<int64_t>(0);
+    case Mc3DataType::A_UINT64:
+      return static_cast<uint64_t>(0);
+    case Mc3DataType::A_FLOAT32:
+    default:
+      break;
+  }
+  return InvalidFloat();
+}
+
+std::any Asap3Helper::InvalidValue(Mc3DataType type) {
+  switch (type) {
+    case Mc3DataType::A_FLOAT64:
+      return std::numeric_limits<double>::quiet_NaN();
+    case Mc3DataType::MC3_STRING:
+      return std::string();
+    case Mc3DataType::A_INT16:
+      return std::numeric_limits<int16_t>::max();
+    case Mc3DataType::A_UINT16:
+      return std::numeric_limits<uint16_t>::max();
+    case Mc3DataType::A_INT32:
+      return std::numeric_limits<int32_t>::max();
+    case Mc3DataType::A_UINT32:
+      return std::numeric_limits<uint32_t>::max();
+    case Mc3DataType::A_INT64:
+      return std::numeric_limits<int64_t>::max();
+    case Mc3DataType::A_UINT64:
+      return std::numeric_limits<uint64_t>::max();
+    case Mc3DataType::A_FLOAT32:
+    default:
+      break;
+  }
+  return InvalidFloat();
+}
+
 void Asap3Helper::ParseCtParameterConfigString(
-    const std::string &config, A3ParameterList &parameter_list) {
-  // First split the string into key/value pairs
-  std::vector<std::string> config_list;
-  boost::algorithm::split(config_list, config, boost::is_any_of("\n"));
-  std::unique_ptr<A3Parameter> parameter;
-
-  for (const auto &temp : config_list) {
-    // Note the temp may be empty due to a bug in the boost split function
-    if (IEquals(temp, "Name=", 5)) {
-      // Start of new parameter. Save the old parameter and create a new one.
-      if (parameter) {
-        parameter_list.push_back(*parameter);
-        parameter.reset();
-      }
-      parameter = std::make_unique<A3Parameter>();
-      parameter->Name(Trim(temp.substr(5)));
+    std::string_view config, A3ParameterList &parameter_list) {
+  // Single pass over the lines. Each "Name=" line starts a new parameter and
+  // the following lines update that parameter.
+  A3Parameter *parameter = nullptr;
+  while (!config.empty()) {
+    const auto end_of_line = config.find('\n');
+    const auto line = config.substr(0, end_of_line);
+    config.remove_prefix(end_of_line == std::string_view::npos
+                             ? config.size()
+                             : end_of_line + 1);
+
+    const auto equal = line.find('=');
+    if (equal == std::string_view::npos) {
+      continue;
     }
-    if (!parameter) {
+    const auto key = TrimText(line.substr(0, equal));
+    const auto value = TrimText(line.substr(equal + 1));
+    if (asap3::IEqualsName(key, "Name")) {
+      parameter = &parameter_list.emplace_back();
+      parameter->Name(std::string(value));
       continue;
     }
-
-    if (IEquals(temp, "Unit=", 5)) {
-      parameter->Unit(Trim(temp.substr(5)));
-    } else if (IEquals(temp, "Type=", 5)) {
-      const int type = std::stoi(temp.substr(5));
-      parameter->Type(static_cast<Mc3DataType>(type));
-    } else if (IEquals(temp, "Max=", 4)) {
-      parameter->Max(std::stod(temp.substr(4)));
-    } else if (IEquals(temp, "Min=", 4)) {
-      parameter->Min(std::stod(temp.substr(4)));
-    } else if (IEquals(temp, "Descr=", 6)) {
-      parameter->Description(Trim(temp.substr(6)));
-    } else if (IEquals(temp, "Device=", 7)) {
-      parameter->Device(Trim(temp.substr(7)));
-    } else if (IEquals(temp, "Id=", 3)) {
-      parameter->Identity(Trim(temp.substr(3)));
-    } else if (IEquals(temp, "Signal=", 7)) {
-      parameter->Signal(Trim(temp.substr(7)));
-    } else if (IEquals(temp, "SetPoint=", 9)) {
-      const int set_point = std::stoi(temp.substr(9));
-      parameter->SetPoint(set_point == 1);
-    } else if (IEquals(temp, "Dpname=", 7)) {
-      parameter->DisplayName(Trim(temp.substr(7)));
-    } else if (IEquals(temp, "Cycle=", 6)) {
-      const int cycle_time = std::stoi(temp.substr(6));
-      parameter->CycleTime(cycle_time);
-    } else if (IEquals(temp, "NofDec=", 7)) {
-      const int nof_dec = std::stoi(temp.substr(7));
-      parameter->NofDecimals(static_cast<uint8_t>(nof_dec));
-    } else if (IEquals(temp, "Lun=", 4)) {
-      const int lun = std::stoi(temp.substr(4));
-      parameter->LunNo(static_cast<uint16_t>(lun));
+    if (parameter == nullptr) {
+      continue;
+    }
+    for (const auto &[config_key, parse] : kConfigKeyList) {
+      if (asap3::IEqualsName(key, config_key)) {
+        parse(*parameter, value);
+        break;
+      }
     }
   }
 }
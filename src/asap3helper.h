@@ -6,14 +6,21 @@
 #pragma once
 #include <boost/endian/buffers.hpp>
 #include <boost/endian/conversion.hpp>
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <string_view>
 #include <vector>
 #include <ranges>
 #include "asap/a3parameter.h"
 #include "asap/asap3def.h"
 #include "asap/irequest.h"
 #include "asap/iresponse.h"
+#include "asap/nameindex.h"
 #include "util/stringutil.h"
 
 namespace asap3 {
@@ -28,6 +35,15 @@ class Asap3Helper {
   static size_t FromMc3Value(std::vector<uint8_t>& data, size_t offset,
                              const T& source);
 
+  /// Bulk copy of big-endian values. Returns number of bytes.
+  template <typename T>
+  static size_t ToMc3Array(const std::vector<uint8_t>& data, size_t offset,
+                           std::span<T> dest);
+
+  template <typename T>
+  static size_t FromMc3Array(std::vector<uint8_t>& data, size_t offset,
+                             std::span<const T> source);
+
   static uint16_t Checksum(const std::vector<uint8_t>& message);
   static size_t DataListSize(const std::vector<DataValue>& data_list);
   static void DataListToBody(const std::vector<DataValue>& data_list,
@@ -35,17 +51,33 @@ class Asap3Helper {
   static void BodyToDataList(const std::vector<uint8_t>& body, size_t& offset,
                              std::vector<DataValue>& data_list);
   static std::string DataListToText(const std::vector<DataValue>& data_list);
+  /// Appends the text to dest. Reuse dest to avoid allocations.
+  static void DataListToText(const std::vector<DataValue>& data_list,
+                             std::string& dest);
+  static void DataValueToText(const DataValue& data, std::string& dest);
   template <typename T>
   static void SetDataListProperty(DataValueList& data_list,
-                                  const std::string& property, const T& value);
+                                  std::string_view property, const T& value);
 
-  static std::string CommandCodeToText(CommandCode command);
-  static std::string StatusCodeToText(StatusCode status);
+  static std::string_view CommandCodeToText(CommandCode command);
+  static std::string_view StatusCodeToText(StatusCode status);
   static std::string RequestToPlainText(const IRequest& request);
+  static void RequestToPlainText(const IRequest& request, std::string& dest);
   static std::string ResponseToPlainText(const IResponse& response);
+  static void ResponseToPlainText(const IResponse& response,
+                                  std::string& dest);
   static float InvalidFloat();
-  static void ParseCtParameterConfigString(const std::string& config,
+  static std::any DefaultValue(Mc3DataType type);
+  /// Marks a value that isn't known. Floats use InvalidFloat() or NaN and
+  /// integers their max value.
+  static std::any InvalidValue(Mc3DataType type);
+  /// Appends the parameters in the config text to the list.
+  static void ParseCtParameterConfigString(std::string_view config,
                                            A3ParameterList& parameter_list);
+
+ private:
+  template <size_t N>
+  static void SwapBytes(uint8_t* data, size_t count);
 };
 
 template <typename T>
@@ -88,12 +120,58 @@ template <>
 size_t Asap3Helper::FromMc3Value(std::vector<uint8_t>& data, size_t offset,
                                  const std::vector<uint8_t>& source);
 
+template <size_t N>
+void Asap3Helper::SwapBytes(uint8_t* data, size_t count) {
+  if constexpr (N > 1 && std::endian::native == std::endian::little) {
+    using Word = std::conditional_t<
+        N == 2, uint16_t, std::conditional_t<N == 4, uint32_t, uint64_t>>;
+    // A plain loop that the compiler unrolls and vectorizes.
+    for (size_t index = 0; index < count; ++index) {
+      Word word;
+      memcpy(&word, data + index * N, N);
+      boost::endian::endian_reverse_inplace(word);
+      memcpy(data + index * N, &word, N);
+    }
+  }
+}
+
+template <typename T>
+size_t Asap3Helper::ToMc3Array(const std::vector<uint8_t>& data,
+                               size_t offset, std::span<T> dest) {
+  static_assert(std::is_arithmetic_v<T>);
+  const size_t data_size = dest.size_bytes();
+  if (data.size() < data_size + offset) {
+    std::ranges::fill(dest, T{});
+  } else if (data_size > 0) {
+    memcpy(dest.data(), data.data() + offset, data_size);
+    SwapBytes<sizeof(T)>(reinterpret_cast<uint8_t*>(dest.data()),
+                         dest.size());
+  }
+  return data_size;
+}
+
+template <typename T>
+size_t Asap3Helper::FromMc3Array(std::vector<uint8_t>& data, size_t offset,
+                                 std::span<const T> source) {
+  static_assert(std::is_arithmetic_v<T>);
+  const size_t data_size = source.size_bytes();
+  if (data.size() < data_size + offset) {
+    data.resize(data_size + offset, 0);
+  }
+  if (data_size > 0) {
+    memcpy(data.data() + offset, source.data(), data_size);
+    SwapBytes<sizeof(T)>(data.data() + offset, source.size());
+  }
+  return data_size;
+}
+
 template <typename T>
 void Asap3Helper::SetDataListProperty(DataValueList& data_list,
-                                      const std::string& property,
+                                      std::string_view property,
                                       const T& value) {
+  // The data lists are short, so a scan without copies is faster than a hash
   auto itr = std::ranges::find_if(data_list, [&](const auto& data) {
-    return util::string::IEquals(property, data.name);
+    return IEqualsName(property, data.name);
   });
   if (itr != data_list.end()) {
     itr->value = value;
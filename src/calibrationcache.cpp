@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/calibrationcache.h"
+
+namespace asap3 {
+
+void CalibrationCache::PageList(uint16_t lun, CalPageList page_list) {
+  std::scoped_lock lock(locker_);
+  lun_list_[lun].page_list = std::move(page_list);
+}
+
+CalPageList CalibrationCache::PageList(uint16_t lun) const {
+  std::scoped_lock lock(locker_);
+  const auto itr = lun_list_.find(lun);
+  return itr != lun_list_.cend() ? itr->second.page_list : CalPageList();
+}
+
+bool CalibrationCache::CurrentPage(uint16_t lun, uint16_t page) {
+  std::scoped_lock lock(locker_);
+  auto& cache = lun_list_[lun];
+  if (page == cache.current_page) {
+    return false;
+  }
+  const bool switched = cache.current_page != kUnknownPage;
+  cache.current_page = page;
+  if (switched) {
+    cache.page_value_list.clear();
+    ++generation_;
+  }
+  return switched;
+}
+
+uint16_t CalibrationCache::CurrentPage(uint16_t lun) const {
+  std::scoped_lock lock(locker_);
+  const auto itr = lun_list_.find(lun);
+  return itr != lun_list_.cend() ? itr->second.current_page : kUnknownPage;
+}
+
+void CalibrationCache::Info(uint16_t lun, const std::string& name,
+                            const CharacteristicInfo& info) {
+  std::scoped_lock lock(locker_);
+  lun_list_[lun].info_list.insert_or_assign(name, info);
+}
+
+bool CalibrationCache::FindInfo(uint16_t lun, std::string_view name,
+                                CharacteristicInfo& info) const {
+  std::scoped_lock lock(locker_);
+  const auto lun_itr = lun_list_.find(lun);
+  if (lun_itr != lun_list_.cend()) {
+    const auto& info_list = lun_itr->second.info_list;
+    if (const auto itr = info_list.find(name); itr != info_list.cend()) {
+      ++hits_;
+      info = itr->second;
+      return true;
+    }
+  }
+  ++misses_;
+  return false;
+}
+
+void CalibrationCache::Value(
+    uint16_t lun, std::shared_ptr<const Characteristic> characteristic,
+    uint64_t generation) {
+  if (!characteristic) {
+    return;
+  }
+  std::scoped_lock lock(locker_);
+  if (generation != generation_) {
+    return;
+  }
+  auto& cache = lun_list_[lun];
+  cache.page_value_list[cache.current_page].insert_or_assign(
+      characteristic->Name(), std::move(characteristic));
+}
+
+std::shared_ptr<const Characteristic> CalibrationCache::Value(
+    uint16_t lun, std::string_view name) const {
+  std::scoped_lock lock(locker_);
+  const auto lun_itr = lun_list_.find(lun);
+  if (lun_itr != lun_list_.cend()) {
+    const auto& cache = lun_itr->second;
+    const auto page_itr = cache.page_value_list.find(cache.current_page);
+    if (page_itr != cache.page_value_list.cend()) {
+      const auto itr = page_itr->second.find(name);
+      if (itr != page_itr->second.cend()) {
+        ++hits_;
+        return itr->second;
+      }
+    }
+  }
+  ++misses_;
+  return {};
+}
+
+void CalibrationCache::Invalidate(uint16_t lun, std::string_view name) {
+  std::scoped_lock lock(locker_);
+  if (auto lun_itr = lun_list_.find(lun); lun_itr != lun_list_.end()) {
+    for (auto& [page, value_list] : lun_itr->second.page_value_list) {
+      if (auto itr = value_list.find(name); itr != value_list.end()) {
+        value_list.erase(itr);
+      }
+    }
+  }
+  ++generation_;
+}
+
+void CalibrationCache::InvalidateValues() {
+  std::scoped_lock lock(locker_);
+  for (auto& [lun, cache] : lun_list_) {
+    cache.page_value_list.clear();
+  }
+  ++generation_;
+}
+
+void CalibrationCache::Clear() {
+  std::scoped_lock lock(locker_);
+  lun_list_.clear();
+  ++generation_;
+}
+
+}  // namespace asap3
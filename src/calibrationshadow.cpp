@@ -0,0 +1,151 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/calibrationshadow.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Length, command and checksum
+constexpr size_t kFrameOverhead = 6;
+
+// Length word and text, padded to an even size
+size_t StringSize(std::string_view text) {
+  return 2 + text.size() + (text.size() % 2);
+}
+
+}  // namespace
+
+namespace asap3 {
+
+void CalibrationShadow::Store(uint16_t lun,
+                              const Characteristic& characteristic) {
+  std::scoped_lock lock(locker_);
+  lun_list_[lun].insert_or_assign(characteristic.Name(), characteristic);
+}
+
+void CalibrationShadow::Store(uint16_t lun, const std::string& name,
+                              Mc3CharType type,
+                              std::span<const uint16_t> dimension_list,
+                              std::span<const float> value_list) {
+  Characteristic characteristic(
+      name, type, {dimension_list.begin(), dimension_list.end()});
+  if (!characteristic.Values(value_list)) {
+    Erase(lun, name);
+    return;
+  }
+  std::scoped_lock lock(locker_);
+  lun_list_[lun].insert_or_assign(name, std::move(characteristic));
+}
+
+bool CalibrationShadow::Update(uint16_t lun, const std::string& name,
+                               Mc3CharType type,
+                               std::span<const uint16_t> dimension_list,
+                               std::span<const float> value_list,
+                               size_t max_gap, CellRunList& run_list) {
+  run_list.clear();
+  {
+    std::scoped_lock lock(locker_);
+    auto& shadow_list = lun_list_[lun];
+    auto itr = shadow_list.find(name);
+    if (itr != shadow_list.end() && itr->second.Type() == type &&
+        std::ranges::equal(itr->second.DimensionList(), dimension_list) &&
+        itr->second.NofValues() == value_list.size()) {
+      auto& shadow = itr->second;
+      run_list = Diff(shadow.Values(), value_list, shadow.Dimension(0),
+                      max_gap);
+      shadow.Values(value_list);
+      return true;
+    }
+  }
+  Store(lun, name, type, dimension_list, value_list);
+  return false;
+}
+
+bool CalibrationShadow::Contains(uint16_t lun, std::string_view name) const {
+  std::scoped_lock lock(locker_);
+  const auto itr = lun_list_.find(lun);
+  return itr != lun_list_.cend() &&
+         itr->second.find(name) != itr->second.cend();
+}
+
+void CalibrationShadow::Erase(uint16_t lun, std::string_view name) {
+  std::scoped_lock lock(locker_);
+  auto lun_itr = lun_list_.find(lun);
+  if (lun_itr == lun_list_.end()) {
+    return;
+  }
+  auto& shadow_list = lun_itr->second;
+  if (auto itr = shadow_list.find(name); itr != shadow_list.end()) {
+    shadow_list.erase(itr);
+  }
+}
+
+void CalibrationShadow::Clear(uint16_t lun) {
+  std::scoped_lock lock(locker_);
+  lun_list_.erase(lun);
+}
+
+void CalibrationShadow::Clear() {
+  std::scoped_lock lock(locker_);
+  lun_list_.clear();
+}
+
+size_t CalibrationShadow::Size() const {
+  std::scoped_lock lock(locker_);
+  size_t size = 0;
+  for (const auto& [lun, shadow_list] : lun_list_) {
+    size += shadow_list.size();
+  }
+  return size;
+}
+
+CellRunList CalibrationShadow::Diff(std::span<const float> previous,
+                                    std::span<const float> current,
+                                    size_t row_size, size_t max_gap) {
+  CellRunList run_list;
+  const auto size = std::min(previous.size(), current.size());
+  if (row_size == 0) {
+    row_size = size;
+  }
+  for (size_t index = 0; index < size; ++index) {
+    // Bitwise compare, so a NaN is sent only once
+    if (std::bit_cast<uint32_t>(previous[index]) ==
+        std::bit_cast<uint32_t>(current[index])) {
+      continue;
+    }
+    if (!run_list.empty()) {
+      auto& last = run_list.back();
+      const auto end = last.first + last.count;
+      const bool same_row = last.first / row_size == index / row_size;
+      if (same_row && index - end <= max_gap) {
+        last.count = index - last.first + 1;
+        continue;
+      }
+    }
+    run_list.push_back({index, 1});
+  }
+  return run_list;
+}
+
+size_t CalibrationShadow::CharacteristicFrameSize(std::string_view name,
+                                                  size_t nof_dimensions,
+                                                  size_t nof_values) {
+  // LUN, name, type, dimensions, sizes and values
+  return kFrameOverhead + 2 + StringSize(name) + 2 + 2 +
+         (2 * nof_dimensions) + (sizeof(float) * nof_values);
+}
+
+size_t CalibrationShadow::CellFrameSize(std::string_view name,
+                                        size_t nof_dimensions,
+                                        size_t nof_values) {
+  // LUN, name, dimensions, start list, count list and values
+  return kFrameOverhead + 2 + StringSize(name) + 2 + (4 * nof_dimensions) +
+         (sizeof(float) * nof_values);
+}
+
+}  // namespace asap3
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/characteristic.h"
+
+#include <algorithm>
+
+namespace asap3 {
+
+Characteristic::Characteristic(std::string name, Mc3CharType type,
+                               std::vector<uint16_t> dimension_list)
+    : name_(std::move(name)) {
+  Resize(type, std::move(dimension_list));
+}
+
+void Characteristic::Resize(Mc3CharType type,
+                            std::vector<uint16_t> dimension_list) {
+  type_ = type;
+  dimension_list_ = std::move(dimension_list);
+  axis_list_.clear();
+  if (HasAxes(type_)) {
+    for (const auto dimension : dimension_list_) {
+      axis_list_.emplace_back(dimension, 0.0F);
+    }
+  }
+  value_list_.assign(NofValues(dimension_list_), 0.0F);
+}
+
+std::span<const float> Characteristic::Axis(size_t dimension) const {
+  if (dimension >= axis_list_.size()) {
+    return {};
+  }
+  return axis_list_[dimension];
+}
+
+std::span<float> Characteristic::Axis(size_t dimension) {
+  if (dimension >= axis_list_.size()) {
+    return {};
+  }
+  return axis_list_[dimension];
+}
+
+bool Characteristic::Values(std::span<const float> value_list) {
+  if (value_list.size() != value_list_.size()) {
+    return false;
+  }
+  std::ranges::copy(value_list, value_list_.begin());
+  return true;
+}
+
+size_t Characteristic::NofValues(std::span<const uint16_t> dimension_list) {
+  size_t count = 1;
+  for (const auto dimension : dimension_list) {
+    count *= dimension;
+  }
+  return count;
+}
+
+bool Characteristic::HasAxes(Mc3CharType type) {
+  switch (type) {
+    case Mc3CharType::CURVE:
+    case Mc3CharType::MAP:
+    case Mc3CharType::CUBE3D:
+    case Mc3CharType::CUBE4D:
+    case Mc3CharType::CUBE5D:
+      return true;
+
+    default:
+      break;
+  }
+  return false;
+}
+
+}  // namespace asap3
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/clientmetrics.h"
+
+#include <sstream>
+
+namespace {
+
+std::string EscapeLabel(const std::string& text) {
+  std::string temp;
+  temp.reserve(text.size());
+  for (const char input : text) {
+    switch (input) {
+      case '\\':
+        temp += "\\\\";
+        break;
+      case '"':
+        temp += "\\\"";
+        break;
+      case '\n':
+        temp += "\\n";
+        break;
+      default:
+        temp += input;
+        break;
+    }
+  }
+  return temp;
+}
+
+void AddMetric(std::ostringstream& out, const std::string& label,
+               const char* name, const char* type, const char* help,
+               uint64_t value) {
+  out << "# HELP " << name << " " << help << "\n"
+      << "# TYPE " << name << " " << type << "\n"
+      << name << "{client=\"" << label << "\"} " << value << "\n";
+}
+
+}  // namespace
+
+namespace asap3 {
+
+std::string MetricsSnapshot::ToPrometheus(const std::string& client) const {
+  const auto label = EscapeLabel(client);
+  std::ostringstream out;
+  AddMetric(out, label, "asap3_frames_in_total", "counter",
+            "Received ASAP3 response frames.", frames_in);
+  AddMetric(out, label, "asap3_frames_out_total", "counter",
+            "Transmitted ASAP3 request frames.", frames_out);
+  AddMetric(out, label, "asap3_bytes_in_total", "counter",
+            "Received bytes.", bytes_in);
+  AddMetric(out, label, "asap3_bytes_out_total", "counter",
+            "Transmitted bytes.", bytes_out);
+  AddMetric(out, label, "asap3_checksum_failures_total", "counter",
+            "Responses with an invalid checksum.", checksum_failures);
+  AddMetric(out, label, "asap3_repeats_total", "counter",
+            "Requests resent due to STATUS_REPEAT_CMD.", repeats);
+  AddMetric(out, label, "asap3_not_processed_total", "counter",
+            "Restarts due to STATUS_NOT_PROCESSED.", not_processed);
+  AddMetric(out, label, "asap3_error_responses_total", "counter",
+            "Responses with STATUS_ERROR.", error_responses);
+  AddMetric(out, label, "asap3_connects_total", "counter",
+            "Successful connects.", connects);
+  AddMetric(out, label, "asap3_reconnects_total", "counter",
+            "Disconnects followed by a retry.", reconnects);
+  AddMetric(out, label, "asap3_deadlock_timeouts_total", "counter",
+            "Response body read timeouts.", deadlock_timeouts);
+  AddMetric(out, label, "asap3_message_timeouts_total", "counter",
+            "Requests that never got a response.", message_timeouts);
+  AddMetric(out, label, "asap3_queue_depth", "gauge",
+            "Telegrams waiting in the send queue.", queue_depth);
+  AddMetric(out, label, "asap3_queue_high_water", "gauge",
+            "Max number of telegrams in the send queue.", queue_high_water);
+  AddMetric(out, label, "asap3_setpoints_sent_total", "counter",
+            "Set-point values sent.", setpoints_sent);
+  AddMetric(out, label, "asap3_setpoints_coalesced_total", "counter",
+            "Set-point values replaced before they were sent.",
+            setpoints_coalesced);
+  AddMetric(out, label, "asap3_async_errors_total", "counter",
+            "Error responses on unacknowledged commands.", async_errors);
+  return out.str();
+}
+
+void ClientMetrics::QueuePut() {
+  const auto depth = ++queue_depth;
+  auto high = queue_high_water.load(std::memory_order_relaxed);
+  while (depth > high && !queue_high_water.compare_exchange_weak(
+                             high, depth, std::memory_order_relaxed)) {
+  }
+}
+
+void ClientMetrics::QueueGet() {
+  auto depth = queue_depth.load(std::memory_order_relaxed);
+  while (depth > 0 && !queue_depth.compare_exchange_weak(
+                          depth, depth - 1, std::memory_order_relaxed)) {
+  }
+}
+
+MetricsSnapshot ClientMetrics::Snapshot() const {
+  MetricsSnapshot snapshot;
+  snapshot.frames_in = frames_in;
+  snapshot.frames_out = frames_out;
+  snapshot.bytes_in = bytes_in;
+  snapshot.bytes_out = bytes_out;
+  snapshot.checksum_failures = checksum_failures;
+  snapshot.repeats = repeats;
+  snapshot.not_processed = not_processed;
+  snapshot.error_responses = error_responses;
+  snapshot.connects = connects;
+  snapshot.reconnects = reconnects;
+  snapshot.deadlock_timeouts = deadlock_timeouts;
+  snapshot.message_timeouts = message_timeouts;
+  snapshot.queue_depth = queue_depth;
+  snapshot.queue_high_water = queue_high_water;
+  snapshot.setpoints_sent = setpoints_sent;
+  snapshot.setpoints_coalesced = setpoints_coalesced;
+  snapshot.async_errors = async_errors;
+  return snapshot;
+}
+
+}  // namespace asap3
@@ -9,6 +9,7 @@
 namespace asap3 {
 
 class CtAsap3Client : public Asap3Client {
+ public:
   CtAsap3Client() = default;
   ~CtAsap3Client() override;
 
@@ -9,7 +9,11 @@
 #include <util/utilfactory.h>
 
 #include <algorithm>
+#include <chrono>
+#include <limits>
+#include <optional>
 #include <sstream>
+#include <utility>
 
 #include "asap/itelegram.h"
 #include "asap3helper.h"
@@ -17,6 +21,79 @@
 
 using namespace util::string;
 
+namespace {
+constexpr size_t kMaxFrameSize = 0xFFFF;  ///< The length is a 16-bit word
+
+template <typename T>
+T ListValue(const asap3::DataValueList& data_list, size_t index) {
+  const auto* value =
+      index < data_list.size() ? std::any_cast<T>(&data_list[index].value)
+                               : nullptr;
+  return value != nullptr ? *value : T{};
+}
+
+std::any ToTypedValue(asap3::Mc3DataType type, double value) {
+  switch (type) {
+    case asap3::Mc3DataType::A_FLOAT64:
+      return value;
+    case asap3::Mc3DataType::MC3_STRING:
+      return std::to_string(value);
+    case asap3::Mc3DataType::A_INT16:
+      return static_cast<int16_t>(value);
+    case asap3::Mc3DataType::A_UINT16:
+      return static_cast<uint16_t>(value);
+    case asap3::Mc3DataType::A_INT32:
+      return static_cast<int32_t>(value);
+    case asap3::Mc3DataType::A_UINT32:
+      return static_cast<uint32_t>(value);
+    case asap3::Mc3DataType::A_INT64:
+      return static_cast<int64_t>(value);
+    case asap3::Mc3DataType::A_UINT64:
+      return static_cast<uint64_t>(value);
+    case asap3::Mc3DataType::A_FLOAT32:
+    default:
+      break;
+  }
+  return static_cast<float>(value);
+}
+
+template <typename T>
+double AnyToDouble(const std::any& value) {
+  const auto* typed = std::any_cast<T>(&value);
+  return typed != nullptr ? static_cast<double>(*typed)
+                          : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ToDouble(const asap3::DataValue& data) {
+  switch (data.type) {
+    case asap3::Mc3DataType::A_FLOAT32:
+      return AnyToDouble<float>(data.value);
+    case asap3::Mc3DataType::A_FLOAT64:
+      return AnyToDouble<double>(data.value);
+    case asap3::Mc3DataType::A_INT16:
+      return AnyToDouble<int16_t>(data.value);
+    case asap3::Mc3DataType::A_UINT16:
+      return AnyToDouble<uint16_t>(data.value);
+    case asap3::Mc3DataType::A_INT32:
+      return AnyToDouble<int32_t>(data.value);
+    case asap3::Mc3DataType::A_UINT32:
+      return AnyToDouble<uint32_t>(data.value);
+    case asap3::Mc3DataType::A_INT64:
+      return AnyToDouble<int64_t>(data.value);
+    case asap3::Mc3DataType::A_UINT64:
+      return AnyToDouble<uint64_t>(data.value);
+    default:
+      break;
+  }
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+// Bytes of one name and value pair in SET_PARAMETER_EV2
+size_t SetPointSize(const std::string& name) {
+  return 2 + name.size() + (name.size() % 2) + sizeof(float);
+}
+}  // namespace
+
 namespace asap3 {
 IClient::IClient()
     : listen_(
@@ -28,6 +105,8 @@ bool IClient::IsConnected() const { return connected_; }
 void IClient::SendTelegram(CommandCode cmd,
                            const std::vector<DataValue>& data_list) {
   auto telegram = std::make_unique<ITelegram>(cmd, data_list);
+  telegram->EnqueueTime(std::chrono::steady_clock::now());
+  metrics_.QueuePut();
   telegram_queue_.Put(telegram);
 }
 
@@ -36,9 +115,629 @@ void IClient::SendTelegram(CommandCode cmd,
                            ITelegram::OnCompleteFunction on_complete_function) {
   auto telegram = std::make_unique<ITelegram>(cmd, data_list,
                                               std::move(on_complete_function));
+  telegram->EnqueueTime(std::chrono::steady_clock::now());
+  metrics_.QueuePut();
   telegram_queue_.Put(telegram);
 }
 
+bool IClient::SendTelegram(std::unique_ptr<IRequest> request,
+                           ITelegram::OnCompleteFunction on_complete_function) {
+  if (!request) {
+    return false;
+  }
+  const auto frame_size = 6 + Asap3Helper::DataListSize(request->DataList()) +
+                          request->Payload().size();
+  if (frame_size > kMaxFrameSize) {
+    return false;
+  }
+  auto telegram = std::make_unique<ITelegram>(std::move(request),
+                                              std::move(on_complete_function));
+  telegram->EnqueueTime(std::chrono::steady_clock::now());
+  metrics_.QueuePut();
+  telegram_queue_.Put(telegram);
+  return true;
+}
+
+void IClient::GetCharacteristicInfo(uint16_t lun, const std::string& name,
+                                    CharacteristicInfoFunction on_info) {
+  if (CharacteristicInfo info;
+      cache_calibration_ && cal_cache_.FindInfo(lun, name, info)) {
+    if (on_info) {
+      on_info(true, info);
+    }
+    return;
+  }
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+      {"Name", Mc3DataType::MC3_STRING, name},
+  };
+  SendTelegram(
+      CommandCode::GET_CHARACTERISTIC_INFO, data_list,
+      [this, lun, name, on_info = std::move(on_info)](bool success,
+                                                 const ITelegram& telegram) {
+        CharacteristicInfo info;
+        const auto* response = telegram.Response();
+        if (success && response != nullptr) {
+          const auto& list = response->DataList();
+          info.type = static_cast<Mc3CharType>(ListValue<uint16_t>(list, 0));
+          info.min = ListValue<float>(list, 1);
+          info.max = ListValue<float>(list, 2);
+          info.increment = ListValue<float>(list, 3);
+          for (size_t index = 5; index < list.size(); ++index) {
+            info.dimension_list.push_back(ListValue<uint16_t>(list, index));
+          }
+          cal_cache_.Info(lun, name, info);
+        }
+        if (on_info) {
+          on_info(success, info);
+        }
+      });
+}
+
+void IClient::ReadCharacteristic(uint16_t lun, const std::string& name,
+                                 CharacteristicFunction on_read) {
+  if (cache_calibration_) {
+    if (const auto cached = cal_cache_.Value(lun, name); cached) {
+      if (on_read) {
+        on_read(true, *cached);
+      }
+      return;
+    }
+  }
+  // A write after this read invalidates the response
+  const auto generation = cal_cache_.Generation();
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+      {"Name", Mc3DataType::MC3_STRING, name},
+  };
+  SendTelegram(CommandCode::READ_CHARACTERISTIC, data_list,
+               [this, lun, name, generation, on_read = std::move(on_read)](
+                   bool success, const ITelegram& telegram) {
+                 const auto* response = telegram.Response();
+                 auto characteristic = response != nullptr
+                                           ? response->CharacteristicValue()
+                                           : nullptr;
+                 if (!success || !characteristic) {
+                   if (on_read) {
+                     on_read(false, Characteristic());
+                   }
+                   return;
+                 }
+                 characteristic->Name(name);
+                 shadow_.Store(lun, *characteristic);
+                 if (cache_calibration_) {
+                   cal_cache_.Value(lun, characteristic, generation);
+                 }
+                 if (on_read) {
+                   on_read(true, *characteristic);
+                 }
+               });
+}
+
+bool IClient::WriteCharacteristic(uint16_t lun,
+                                  const Characteristic& characteristic,
+                                  ITelegram::OnCompleteFunction on_complete) {
+  return WriteCharacteristic(lun, characteristic.Name(), characteristic.Type(),
+                             characteristic.DimensionList(),
+                             characteristic.Values(), std::move(on_complete));
+}
+
+bool IClient::WriteCharacteristic(uint16_t lun, const std::string& name,
+                                  Mc3CharType type,
+                                  std::span<const uint16_t> dimension_list,
+                                  std::span<const float> value_list,
+                                  ITelegram::OnCompleteFunction on_complete) {
+  if (value_list.size() != Characteristic::NofValues(dimension_list)) {
+    return false;
+  }
+  // The shadow is removed if the write fails
+  shadow_.Store(lun, name, type, dimension_list, value_list);
+  cal_cache_.Invalidate(lun, name);
+  const bool sent = SendCharacteristic(
+      lun, name, type, dimension_list, value_list,
+      [this, lun, name, on_complete = std::move(on_complete)](
+          bool success, const ITelegram& telegram) {
+        if (!success) {
+          shadow_.Erase(lun, name);
+        }
+        if (on_complete) {
+          on_complete(success, telegram);
+        }
+      });
+  if (!sent) {
+    shadow_.Erase(lun, name);
+  }
+  return sent;
+}
+
+bool IClient::SendCharacteristic(uint16_t lun, const std::string& name,
+                                 Mc3CharType type,
+                                 std::span<const uint16_t> dimension_list,
+                                 std::span<const float> value_list,
+                                 ITelegram::OnCompleteFunction on_complete) {
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+      {"Name", Mc3DataType::MC3_STRING, name},
+      {"Type", Mc3DataType::A_UINT16, static_cast<uint16_t>(type)},
+      {"Dimensions", Mc3DataType::A_UINT16,
+       static_cast<uint16_t>(dimension_list.size())},
+  };
+  // The values are not added to the data list. They are swapped directly
+  // into the payload.
+  std::vector<uint8_t> payload(dimension_list.size_bytes() +
+                               value_list.size_bytes());
+  const auto offset = Asap3Helper::FromMc3Array(payload, 0, dimension_list);
+  Asap3Helper::FromMc3Array(payload, offset, value_list);
+
+  auto request = std::make_unique<IRequest>(CommandCode::WRITE_CHARACTERISTIC,
+                                            data_list);
+  request->Payload(std::move(payload));
+  return SendTelegram(std::move(request), std::move(on_complete));
+}
+
+bool IClient::ReadCellValues(uint16_t lun, const std::string& name,
+                             std::span<const uint16_t> start_list,
+                             std::span<const uint16_t> count_list,
+                             CellValueFunction on_read) {
+  if (start_list.size() != count_list.size()) {
+    return false;
+  }
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+      {"Name", Mc3DataType::MC3_STRING, name},
+      {"Dimensions", Mc3DataType::A_UINT16,
+       static_cast<uint16_t>(start_list.size())},
+  };
+  std::vector<uint8_t> payload(start_list.size_bytes() +
+                               count_list.size_bytes());
+  const auto offset = Asap3Helper::FromMc3Array(payload, 0, start_list);
+  Asap3Helper::FromMc3Array(payload, offset, count_list);
+
+  auto request =
+      std::make_unique<IRequest>(CommandCode::READ_CELL_VALUES, data_list);
+  request->Payload(std::move(payload));
+  const auto nof_values = Characteristic::NofValues(count_list);
+  return SendTelegram(
+      std::move(request),
+      [on_read = std::move(on_read), nof_values](bool success,
+                                                 const ITelegram& telegram) {
+        if (!on_read) {
+          return;
+        }
+        // A truncated response has no values
+        const auto* response = telegram.Response();
+        if (!success || response == nullptr ||
+            response->ValueArray().size() != nof_values) {
+          on_read(false, {});
+          return;
+        }
+        on_read(true, response->ValueArray());
+      });
+}
+
+bool IClient::WriteCellValues(uint16_t lun, const std::string& name,
+                              std::span<const uint16_t> start_list,
+                              std::span<const uint16_t> count_list,
+                              std::span<const float> value_list,
+                              ITelegram::OnCompleteFunction on_complete) {
+  if (start_list.size() != count_list.size() ||
+      value_list.size() != Characteristic::NofValues(count_list)) {
+    return false;
+  }
+  // The next update needs a full write
+  shadow_.Erase(lun, name);
+  cal_cache_.Invalidate(lun, name);
+  return SendCellValues(lun, name, start_list, count_list, value_list,
+                        std::move(on_complete));
+}
+
+bool IClient::ReadCellValues(uint16_t lun, const std::string& name,
+                             TensorView<float> view, WriteFunction on_read) {
+  std::vector<uint16_t> start_list;
+  std::vector<uint16_t> count_list;
+  view.CellRange(start_list, count_list);
+  return ReadCellValues(
+      lun, name, start_list, count_list,
+      [view, on_read = std::move(on_read)](bool success,
+                                           std::span<const float> value_list) {
+        success = success && value_list.size() == view.Size();
+        if (success) {
+          view.CopyFrom(value_list);
+        }
+        if (on_read) {
+          on_read(success);
+        }
+      });
+}
+
+bool IClient::WriteCellValues(uint16_t lun, const std::string& name,
+                              TensorView<const float> view,
+                              ITelegram::OnCompleteFunction on_complete) {
+  if (view.Empty()) {
+    return false;
+  }
+  std::vector<uint16_t> start_list;
+  std::vector<uint16_t> count_list;
+  view.CellRange(start_list, count_list);
+  if (const auto value_list = view.Contiguous(); !value_list.empty()) {
+    return WriteCellValues(lun, name, start_list, count_list, value_list,
+                           std::move(on_complete));
+  }
+  std::vector<float> value_list(view.Size());
+  view.CopyTo(value_list);
+  return WriteCellValues(lun, name, start_list, count_list, value_list,
+                         std::move(on_complete));
+}
+
+bool IClient::SendCellValues(uint16_t lun, const std::string& name,
+                             std::span<const uint16_t> start_list,
+                             std::span<const uint16_t> count_list,
+                             std::span<const float> value_list,
+                             ITelegram::OnCompleteFunction on_complete) {
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+      {"Name", Mc3DataType::MC3_STRING, name},
+      {"Dimensions", Mc3DataType::A_UINT16,
+       static_cast<uint16_t>(start_list.size())},
+  };
+  std::vector<uint8_t> payload(start_list.size_bytes() +
+                               count_list.size_bytes() +
+                               value_list.size_bytes());
+  auto offset = Asap3Helper::FromMc3Array(payload, 0, start_list);
+  offset += Asap3Helper::FromMc3Array(payload, offset, count_list);
+  Asap3Helper::FromMc3Array(payload, offset, value_list);
+
+  auto request =
+      std::make_unique<IRequest>(CommandCode::WRITE_CELL_VALUES, data_list);
+  request->Payload(std::move(payload));
+  return SendTelegram(std::move(request), std::move(on_complete));
+}
+
+bool IClient::UpdateCharacteristic(uint16_t lun,
+                                   const Characteristic& characteristic,
+                                   WriteFunction on_write) {
+  return UpdateCharacteristic(lun, characteristic.Name(),
+                              characteristic.Type(),
+                              characteristic.DimensionList(),
+                              characteristic.Values(), std::move(on_write));
+}
+
+bool IClient::UpdateCharacteristic(uint16_t lun, const std::string& name,
+                                   Mc3CharType type,
+                                   std::span<const uint16_t> dimension_list,
+                                   std::span<const float> value_list,
+                                   WriteFunction on_write) {
+  if (value_list.size() != Characteristic::NofValues(dimension_list)) {
+    return false;
+  }
+  const auto nof_dimensions = dimension_list.size();
+  // Merging two runs is cheaper than a new frame if the gap is small
+  const auto max_gap =
+      CalibrationShadow::CellFrameSize(name, nof_dimensions, 0) /
+      sizeof(float);
+  CellRunList run_list;
+  const bool delta = shadow_.Update(lun, name, type, dimension_list,
+                                    value_list, max_gap, run_list);
+  if (delta && run_list.empty()) {
+    if (on_write) {
+      on_write(true);
+    }
+    return true;
+  }
+  cal_cache_.Invalidate(lun, name);
+
+  size_t cell_size = 0;
+  for (const auto& run : run_list) {
+    cell_size +=
+        CalibrationShadow::CellFrameSize(name, nof_dimensions, run.count);
+  }
+  const auto full_size = CalibrationShadow::CharacteristicFrameSize(
+      name, nof_dimensions, value_list.size());
+  const bool full = !delta || cell_size >= full_size;
+
+  // The function is called once when all frames are done
+  struct WriteState {
+    std::atomic<size_t> pending = 0;
+    std::atomic<bool> success = true;
+    WriteFunction on_write;
+  };
+  auto state = std::make_shared<WriteState>();
+  state->pending = full ? 1 : run_list.size();
+  state->on_write = std::move(on_write);
+  auto done = [this, lun, name, state](bool success) {
+    if (!success) {
+      state->success = false;
+      shadow_.Erase(lun, name);
+    }
+    if (--state->pending == 0 && state->on_write) {
+      state->on_write(state->success);
+    }
+  };
+  auto on_complete = [done](bool success, const ITelegram&) {
+    done(success);
+  };
+
+  if (full) {
+    const bool sent = SendCharacteristic(lun, name, type, dimension_list,
+                                         value_list, on_complete);
+    if (!sent) {
+      done(false);
+    }
+    return sent;
+  }
+
+  bool sent = true;
+  std::vector<uint16_t> start_list(nof_dimensions, 0);
+  std::vector<uint16_t> count_list(nof_dimensions, 1);
+  for (const auto& run : run_list) {
+    // Runs never cross a row, so only X has a count above 1
+    auto index = run.first;
+    for (size_t dimension = 0; dimension < nof_dimensions; ++dimension) {
+      start_list[dimension] =
+          static_cast<uint16_t>(index % dimension_list[dimension]);
+      index /= dimension_list[dimension];
+    }
+    if (nof_dimensions > 0) {
+      count_list[0] = static_cast<uint16_t>(run.count);
+    }
+    if (!SendCellValues(lun, name, start_list, count_list,
+                        value_list.subspan(run.first, run.count),
+                        on_complete)) {
+      sent = false;
+      done(false);
+    }
+  }
+  return sent;
+}
+
+void IClient::GetCalPageInfo(uint16_t lun, CalPageFunction on_info) {
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+  };
+  SendTelegram(
+      CommandCode::GET_CALPAGE_INFO, data_list,
+      [this, lun, on_info = std::move(on_info)](bool success, const ITelegram&) {
+        if (on_info) {
+          on_info(success, cal_cache_.PageList(lun));
+        }
+      });
+}
+
+void IClient::GetCurrentCalPage(uint16_t lun, CurrentPageFunction on_page) {
+  const DataValueList data_list = {
+      {"LUN", Mc3DataType::A_UINT16, lun},
+  };
+  SendTelegram(
+      CommandCode::GET_CURRENT_CALPAGE, data_list,
+      [this, lun, on_page = std::move(on_page)](bool success, const ITelegram&) {
+        if (on_page) {
+          on_page(success, cal_cache_.CurrentPage(lun));
+        }
+      });
+}
+
+struct IClient::LookupBatch {
+  CommandCode cmd = CommandCode::SELECT_LOOKUP_TABLE_EV2;
+  LookupTableList table_list;
+  LookupTableIncreaseList increase_list;  ///< Same order as the tables
+  std::atomic<size_t> pending = 0;
+  LookupTableFunction on_done;
+};
+
+void IClient::SelectLookupTables(uint16_t lun,
+                                 const std::vector<std::string>& name_list,
+                                 LookupTableFunction on_done) {
+  auto batch = std::make_shared<LookupBatch>();
+  for (const auto& name : name_list) {
+    batch->table_list.push_back({.name = name, .value_list = {}});
+  }
+  batch->on_done = std::move(on_done);
+  SendLookupBatch(lun, std::move(batch));
+}
+
+void IClient::GetLookupTables(uint16_t lun,
+                              const std::vector<std::string>& name_list,
+                              LookupTableFunction on_done) {
+  auto batch = std::make_shared<LookupBatch>();
+  batch->cmd = CommandCode::GET_LOOKUP_TABLE_EV2;
+  for (const auto& name : name_list) {
+    batch->table_list.push_back({.name = name, .value_list = {}});
+  }
+  batch->on_done = std::move(on_done);
+  SendLookupBatch(lun, std::move(batch));
+}
+
+void IClient::PutLookupTables(uint16_t lun, LookupTableList table_list,
+                              LookupTableFunction on_done) {
+  auto batch = std::make_shared<LookupBatch>();
+  batch->cmd = CommandCode::PUT_LOOKUP_TABLE_EV2;
+  batch->table_list = std::move(table_list);
+  batch->on_done = std::move(on_done);
+  SendLookupBatch(lun, std::move(batch));
+}
+
+void IClient::IncreaseLookupTables(
+    uint16_t lun, const LookupTableIncreaseList& increase_list,
+    LookupTableFunction on_done) {
+  auto batch = std::make_shared<LookupBatch>();
+  batch->cmd = CommandCode::INCREASE_LOOKUP_TABLE_EV2;
+  for (const auto& increase : increase_list) {
+    batch->table_list.push_back({.name = increase.name, .value_list = {}});
+  }
+  batch->increase_list = increase_list;
+  batch->on_done = std::move(on_done);
+  SendLookupBatch(lun, std::move(batch));
+}
+
+void IClient::ClearLookupTables() {
+  std::scoped_lock lock(value_locker_);
+  lookup_table_list_.clear();
+}
+
+void IClient::InvalidateCalibration() {
+  cal_cache_.Clear();
+  shadow_.Clear();
+  ClearLookupTables();
+}
+
+void IClient::ClearLookupTables(uint16_t lun) {
+  std::scoped_lock lock(value_locker_);
+  lookup_table_list_.erase(lun);
+}
+
+void IClient::SendLookupBatch(uint16_t lun,
+                              std::shared_ptr<LookupBatch> batch) {
+  std::vector<size_t> select_list;
+  {
+    std::scoped_lock lock(value_locker_);
+    const auto& address_list = lookup_table_list_[lun];
+    for (size_t index = 0; index < batch->table_list.size(); ++index) {
+      auto& table = batch->table_list[index];
+      const auto itr = address_list.find(table.name);
+      if (itr == address_list.cend()) {
+        select_list.push_back(index);
+        continue;
+      }
+      table.address = itr->second.address;
+      table.x_dim = itr->second.x_dim;
+      table.y_dim = itr->second.y_dim;
+      table.valid = true;
+    }
+  }
+  if (select_list.empty()) {
+    SendLookupRequests(lun, std::move(batch));
+    return;
+  }
+
+  // All selects are queued before the table requests are sent
+  batch->pending = select_list.size();
+  for (const auto index : select_list) {
+    const DataValueList data_list = {
+        {"LUN", Mc3DataType::A_UINT16, lun},
+        {"Name", Mc3DataType::MC3_STRING, batch->table_list[index].name},
+    };
+    SendTelegram(
+        CommandCode::SELECT_LOOKUP_TABLE_EV2, data_list,
+        [this, lun, batch, index](bool success, const ITelegram& telegram) {
+          auto& table = batch->table_list[index];
+          const auto* response = telegram.Response();
+          table.valid = success && response != nullptr;
+          if (table.valid) {
+            const auto& list = response->DataList();
+            table.address = ListValue<uint32_t>(list, 0);
+            table.x_dim = ListValue<uint16_t>(list, 1);
+            table.y_dim = ListValue<uint16_t>(list, 2);
+            std::scoped_lock lock(value_locker_);
+            lookup_table_list_[lun].insert_or_assign(
+                table.name, LookupTable{table.name, table.address,
+                                        table.x_dim, table.y_dim, {}, true});
+          }
+          if (--batch->pending == 0) {
+            SendLookupRequests(lun, batch);
+          }
+        });
+  }
+}
+
+void IClient::SendLookupRequests(uint16_t lun,
+                                 std::shared_ptr<LookupBatch> batch) {
+  const auto cmd = batch->cmd;
+  std::vector<size_t> send_list;
+  for (size_t index = 0; index < batch->table_list.size(); ++index) {
+    const auto& table = batch->table_list[index];
+    if (!table.valid) {
+      continue;
+    }
+    if (cmd == CommandCode::PUT_LOOKUP_TABLE_EV2 &&
+        table.value_list.size() !=
+            static_cast<size_t>(table.x_dim) * table.y_dim) {
+      batch->table_list[index].valid = false;
+      continue;
+    }
+    send_list.push_back(index);
+  }
+  if (cmd == CommandCode::SELECT_LOOKUP_TABLE_EV2 || send_list.empty()) {
+    LookupDone(*batch);
+    return;
+  }
+
+  batch->pending = send_list.size();
+  for (const auto index : send_list) {
+    auto& table = batch->table_list[index];
+    DataValueList data_list = {
+        {"LUN", Mc3DataType::A_UINT16, lun},
+        {"Address", Mc3DataType::A_UINT32, table.address},
+    };
+    std::vector<uint8_t> payload;
+    switch (cmd) {
+      case CommandCode::PUT_LOOKUP_TABLE_EV2:
+        data_list.push_back({"X Dim", Mc3DataType::A_UINT16, table.x_dim});
+        data_list.push_back({"Y Dim", Mc3DataType::A_UINT16, table.y_dim});
+        Asap3Helper::FromMc3Array(payload, 0,
+                                  std::span<const float>(table.value_list));
+        break;
+
+      case CommandCode::INCREASE_LOOKUP_TABLE_EV2: {
+        const auto& increase = batch->increase_list[index];
+        data_list.push_back({"Mode", Mc3DataType::A_UINT16,
+                             static_cast<uint16_t>(increase.mode)});
+        data_list.push_back(
+            {"X Start", Mc3DataType::A_UINT16, increase.x_start});
+        data_list.push_back(
+            {"Y Start", Mc3DataType::A_UINT16, increase.y_start});
+        data_list.push_back(
+            {"X Count", Mc3DataType::A_UINT16, increase.x_count});
+        data_list.push_back(
+            {"Y Count", Mc3DataType::A_UINT16, increase.y_count});
+        data_list.push_back({"Value", Mc3DataType::A_FLOAT32, increase.value});
+        break;
+      }
+
+      default:
+        break;
+    }
+    if (cmd != CommandCode::GET_LOOKUP_TABLE_EV2) {
+      // The table is also a characteristic
+      cal_cache_.Invalidate(lun, table.name);
+      shadow_.Erase(lun, table.name);
+    }
+
+    auto request = std::make_unique<IRequest>(cmd, data_list);
+    request->Payload(std::move(payload));
+    const bool sent = SendTelegram(
+        std::move(request),
+        [batch, index](bool success, const ITelegram& telegram) {
+          auto& table = batch->table_list[index];
+          const auto* response = telegram.Response();
+          table.valid = success && response != nullptr;
+          if (table.valid && batch->cmd == CommandCode::GET_LOOKUP_TABLE_EV2) {
+            const auto& value_list = response->ValueArray();
+            table.valid = value_list.size() ==
+                          static_cast<size_t>(table.x_dim) * table.y_dim;
+            table.value_list.assign(value_list.cbegin(), value_list.cend());
+          }
+          if (--batch->pending == 0) {
+            LookupDone(*batch);
+          }
+        });
+    if (!sent) {
+      table.valid = false;
+      if (--batch->pending == 0) {
+        LookupDone(*batch);
+      }
+    }
+  }
+}
+
+void IClient::LookupDone(LookupBatch& batch) {
+  if (!batch.on_done) {
+    return;
+  }
+  const bool success = std::ranges::all_of(
+      batch.table_list, [](const auto& table) { return table.valid; });
+  batch.on_done(success, batch.table_list);
+}
+
 void IClient::ListenRequest(const IRequest& request) {
   if (!listen_ || !listen_->IsActive()) {
     return;
@@ -46,38 +745,35 @@ void IClient::ListenRequest(const IRequest& request) {
   // Log level 0: Show all plain text
   // Log level 1: Hide cyclic data
   // Log level 2: Hide commands
-  // Log level 3: Show hex
-
+  // Log level 3: Show hex (raw frames are sent from the trace ring)
+  const bool cyclic = request.Cmd() == CommandCode::GET_ONLINE_VALUE ||
+                      request.Cmd() == CommandCode::GET_ONLINE_VALUE_EV2;
+  bool show = false;
   switch (listen_->LogLevel()) {
-    case 3: {
-      std::vector<uint8_t> temp_body;
-      request.CreateBody(temp_body);
-      const auto now = util::time::TimeStampToNs();
-      std::ostringstream pre_text;
-      pre_text << Name() << "T:";
-      listen_->ListenTransmit(now, pre_text.str(), temp_body, nullptr);
+    case 3:
       break;
-    }
 
-    case 1:  // Hide cyclic data
-      if (request.Cmd() != CommandCode::GET_ONLINE_VALUE &&
-          request.Cmd() != CommandCode::GET_ONLINE_VALUE_EV2) {
-        listen_->ListenOut() << Asap3Helper::RequestToPlainText(request);
-      }
+    case 1:
+      show = !cyclic;
       break;
 
-    case 2:  // Hide commands data (Well opposite of case 1)
-      if (request.Cmd() == CommandCode::GET_ONLINE_VALUE ||
-          request.Cmd() == CommandCode::GET_ONLINE_VALUE_EV2) {
-        listen_->ListenOut() << Asap3Helper::RequestToPlainText(request);
-      }
+    case 2:
+      show = cyclic;
       break;
 
     case 0:
     default:
-      listen_->ListenOut() << Asap3Helper::RequestToPlainText(request);
+      show = true;
       break;
   }
+  if (show) {
+    // The buffer keeps its capacity, so large telegrams are rendered
+    // without allocating.
+    thread_local std::string text;
+    text.clear();
+    Asap3Helper::RequestToPlainText(request, text);
+    listen_->ListenOut() << text;
+  }
 }
 
 void IClient::ListenResponse(const IResponse& response) {
@@ -87,39 +783,56 @@ void IClient::ListenResponse(const IResponse& response) {
   // Log level 0: Show all plain text
   // Log level 1: Hide cyclic data
   // Log level 2: Hide commands
-  // Log level 3: Show hex
-
+  // Log level 3: Show hex (raw frames are sent from the trace ring)
+  const bool cyclic = response.Cmd() == CommandCode::GET_ONLINE_VALUE ||
+                      response.Cmd() == CommandCode::GET_ONLINE_VALUE_EV2;
+  bool show = false;
   switch (listen_->LogLevel()) {
-    case 3: {
-      IResponse temp(response);
-      std::vector<uint8_t> temp_body;
-      temp.CreateBody(temp_body);
-      const auto now = util::time::TimeStampToNs();
-      std::ostringstream pre_text;
-      pre_text << Name() << "R:";
-      listen_->ListenReceive(now, pre_text.str(), temp_body, nullptr);
+    case 3:
       break;
-    }
 
-    case 1:  // Hide cyclic data
-      if (response.Cmd() != CommandCode::GET_ONLINE_VALUE &&
-          response.Cmd() != CommandCode::GET_ONLINE_VALUE_EV2) {
-        listen_->ListenOut() << Asap3Helper::ResponseToPlainText(response);
-      }
+    case 1:
+      show = !cyclic;
       break;
 
-    case 2:  // Hide commands data (Well opposite of case 1)
-      if (response.Cmd() == CommandCode::GET_ONLINE_VALUE ||
-          response.Cmd() == CommandCode::GET_ONLINE_VALUE_EV2) {
-        listen_->ListenOut() << Asap3Helper::ResponseToPlainText(response);
-      }
+    case 2:
+      show = cyclic;
       break;
 
     case 0:
     default:
-      listen_->ListenOut() << Asap3Helper::ResponseToPlainText(response);
+      show = true;
       break;
   }
+  if (show) {
+    // The buffer keeps its capacity, so large telegrams are rendered
+    // without allocating.
+    thread_local std::string text;
+    text.clear();
+    Asap3Helper::ResponseToPlainText(response, text);
+    listen_->ListenOut() << text;
+  }
+}
+
+bool IClient::IsTracing() const {
+  return trace_ ||
+         (listen_ && listen_->IsActive() && listen_->LogLevel() == 3);
+}
+
+void IClient::ListenTrace() {
+  TraceRecord record;
+  while (trace_ring_.Read(record)) {
+    if (!listen_ || !listen_->IsActive() || listen_->LogLevel() != 3) {
+      continue;
+    }
+    if (record.direction == TraceDirection::Transmit) {
+      listen_->ListenTransmit(record.time, Name() + "T:", record.frame,
+                              nullptr);
+    } else {
+      listen_->ListenReceive(record.time, Name() + "R:", record.frame,
+                             nullptr);
+    }
+  }
 }
 
 bool IClient::HandleTelegram(ITelegram& telegram) {
@@ -132,6 +845,10 @@ bool IClient::HandleTelegram(ITelegram& telegram) {
   const auto& data_list = response->DataList();
   bool success = true;
 
+  if (response->Status() == StatusCode::STATUS_MEASURING_DATA_CHANGED) {
+    InvalidateCalibration();
+  }
+
   if (response->Status() != StatusCode::STATUS_OK &&
       response->Status() != StatusCode::STATUS_SUCCESS) {
     success = false;
@@ -167,6 +884,31 @@ bool IClient::HandleTelegram(ITelegram& telegram) {
       SetServiceList(response->DataList());
       break;
 
+    case CommandCode::GET_CALPAGE_INFO: {
+      // Pages followed by index, name and properties for each page
+      CalPageList page_list;
+      for (size_t index = 1; index + 2 < data_list.size(); index += 3) {
+        page_list.push_back({ListValue<uint16_t>(data_list, index),
+                             ListValue<std::string>(data_list, index + 1),
+                             ListValue<uint16_t>(data_list, index + 2)});
+      }
+      if (request != nullptr) {
+        cal_cache_.PageList(ListValue<uint16_t>(request->DataList(), 0),
+                            std::move(page_list));
+      }
+      break;
+    }
+
+    case CommandCode::GET_CURRENT_CALPAGE:
+      if (request != nullptr &&
+          cal_cache_.CurrentPage(ListValue<uint16_t>(request->DataList(), 0),
+                                 ListValue<uint16_t>(data_list, 0))) {
+        const auto lun = ListValue<uint16_t>(request->DataList(), 0);
+        shadow_.Clear(lun);
+        ClearLookupTables(lun);  // Addresses may differ between the pages
+      }
+      break;
+
     // Update the service list info
     case CommandCode::GET_SERVICE_INFORMATION:
       if (request != nullptr) {
@@ -185,6 +927,7 @@ bool IClient::HandleTelegram(ITelegram& telegram) {
 void IClient::SetOnlineData(const std::vector<uint8_t>& body, size_t offset) {
   std::scoped_lock lock(value_locker_);
   Asap3Helper::BodyToDataList(body, offset, online_value_list_);
+  ExportValues();
 }
 
 void IClient::DefineUserDefinedData(const std::vector<uint8_t>& body,
@@ -218,32 +961,75 @@ ServiceList IClient::AvailableServices() const {
 }
 
 void IClient::SetServiceList(const DataValueList& data_list) {
-  std::scoped_lock lock(value_locker_);
-  service_list_.clear();
+  ServiceList service_list;
   for (size_t index = 1; index < data_list.size(); ++index) {
     const DataValue& data = data_list[index];
     std::string name = data.type == Mc3DataType::MC3_STRING
                            ? std::any_cast<std::string>(data.value)
                            : std::string();
-    service_list_.push_back({name, std::string()});
+    service_list.push_back({name, std::string()});
+  }
+  SetServiceList(std::move(service_list));
+}
+
+void IClient::SetServiceList(ServiceList service_list) {
+  std::scoped_lock lock(value_locker_);
+  service_list_ = std::move(service_list);
+  service_index_.Clear();
+  service_index_.Reserve(service_list_.size());
+  std::vector<std::string_view> name_list;
+  name_list.reserve(service_list_.size());
+  for (size_t index = 0; index < service_list_.size(); ++index) {
+    service_index_.Add(service_list_[index].name, index);
+    name_list.emplace_back(service_list_[index].name);
   }
+  service_search_ = SearchIndex(name_list);
+}
+
+ServiceList IClient::SearchServices(std::string_view pattern) const {
+  std::scoped_lock lock(value_locker_);
+  ServiceList list;
+  for (const auto index : service_search_.Glob(pattern)) {
+    list.push_back(service_list_[index]);
+  }
+  return list;
 }
 
 void IClient::SetServiceInfo(const std::string& service,
                              const std::string& info) {
   std::scoped_lock lock(value_locker_);
-
-  auto itr = std::ranges::find_if(
-      service_list_, [&](const auto& serv) { return serv.name == service; });
-  if (itr != service_list_.end()) {
-    itr->info = info;
+  const auto index = service_index_.Find(service);
+  if (index && *index < service_list_.size()) {
+    service_list_[*index].info = info;
   }
 }
 
-bool IClient::HasService(const std::string& service) const {
-  return std::ranges::any_of(service_list_, [&](const auto& serv) {
-    return IEquals(service, serv.name);
-  });
+bool IClient::HasService(std::string_view service) const {
+  std::scoped_lock lock(value_locker_);
+  return service_index_.Contains(service);
+}
+
+ParameterCatalogPtr IClient::Catalog() const {
+  std::scoped_lock lock(value_locker_);
+  return catalog_;
+}
+
+void IClient::Catalog(ParameterCatalogPtr catalog) {
+  std::scoped_lock lock(value_locker_);
+  catalog_ = std::move(catalog);
+}
+
+ParameterCatalogPtr IClient::SignalCatalog() const {
+  std::scoped_lock lock(value_locker_);
+  return signal_catalog_;
+}
+
+void IClient::BuildCatalog() {
+  auto catalog = ParameterCatalog::Create(parameter_list_);
+  auto signal_catalog = ParameterCatalog::Create(signal_list_);
+  std::scoped_lock lock(value_locker_);
+  catalog_ = std::move(catalog);
+  signal_catalog_ = std::move(signal_catalog);
 }
 
 bool IClient::IsSubscriptionInitialized() const {
@@ -276,6 +1062,9 @@ bool IClient::IsSubscriptionInitialized() const {
 }
 
 void IClient::ParameterList(const A3ParameterList& parameter_list) {
+  // The list is the requested acquisition. The catalog keeps the discovered
+  // parameters, so it is not rebuilt here.
+  std::scoped_lock lock(value_locker_);
   parameter_list_ = parameter_list;
 
   // Set the exist flag to true.indicating that this parameter must
@@ -285,7 +1074,449 @@ void IClient::ParameterList(const A3ParameterList& parameter_list) {
   }
 }
 
-bool IClient::StartSubscription(uint16_t scan_rate) { return false; }
+bool IClient::StartSubscription(uint16_t scan_rate) {
+  if (parameter_list_.empty()) {
+    listen_->ListenOut()
+        << "Empty subscription detected. Cannot start the subscription";
+    return false;
+  }
+  // First check if the subscription already is initialized. If so we
+  // can go online directly.
+
+  // This is a simple ComTest subscription so all parameter value are fetched
+  // with the same sample rate and LUN numbers are omitted. Note that
+  // scan rate gives a base scan rate.
+
+  // Define the value lists. Set-points are written so they are kept
+  // outside the acquisition.
+  DefineValueLists();
+
+  // Always use extended call to ComTest as it support the call.
+  DataValueList empty_list = {
+      {"Emulator LUN", Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+      {"Sample Rate", Mc3DataType::A_UINT16, scan_rate},
+      {"Measurements", Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+  };
+  // Reset any previously subscriptions
+  SendTelegram(CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2, empty_list);
+
+  std::vector<const A3Parameter*> acquisition_list;
+  for (const auto& parameter : parameter_list_) {
+    if (!parameter.SetPoint()) {
+      acquisition_list.push_back(&parameter);
+    }
+  }
+
+  // Split into smaller subscription in case
+  for (size_t count = 0; count < acquisition_list.size(); count += 50) {
+    uint16_t nof_meas = 50;
+    if (count + nof_meas >= acquisition_list.size()) {
+      nof_meas = static_cast<uint16_t>(acquisition_list.size() - count);
+    }
+    DataValueList sub_list;
+    sub_list.push_back(
+        {"Emulator LUN", Mc3DataType::A_UINT16, static_cast<uint16_t>(0)});
+    sub_list.push_back({"Sample Rate", Mc3DataType::A_UINT16, scan_rate});
+    sub_list.push_back({"Measurements", Mc3DataType::A_UINT16, nof_meas});
+    for (uint16_t index = 0; index < nof_meas; ++index) {
+      std::ostringstream label;
+      label << "Name " << index + count + 1;
+      const auto* parameter = acquisition_list[count + index];
+      sub_list.push_back({label.str(), Mc3DataType::MC3_STRING,
+                          std::string(parameter->Name())});
+    }
+    SendTelegram(CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2, sub_list);
+  }
+  return true;
+}
+
+void IClient::DefineValueLists() {
+  std::scoped_lock lock(value_locker_);
+  online_value_list_.clear();
+  output_value_list_.clear();
+  setpoint_index_.Clear();
+  for (auto& parameter : parameter_list_) {
+    auto& value_list =
+        parameter.SetPoint() ? output_value_list_ : online_value_list_;
+    parameter.ValueIndex(value_list.size());
+    if (parameter.SetPoint()) {
+      setpoint_index_.Add(parameter.Name(), value_list.size());
+    }
+    value_list.push_back({parameter.Name(), parameter.Type(),
+                          Asap3Helper::DefaultValue(parameter.Type())});
+  }
+  setpoint_value_list_.assign(output_value_list_.size(), 0.0F);
+  setpoint_lun_list_.clear();
+  for (const auto& parameter : parameter_list_) {
+    if (parameter.SetPoint()) {
+      setpoint_lun_list_.push_back(parameter.LunNo());
+    }
+  }
+  setpoint_dirty_list_.assign(output_value_list_.size(), 0);
+  setpoint_sent_list_.assign(output_value_list_.size(), 0);
+  setpoint_pending_list_.clear();
+  ExportParameters();
+}
+
+DataValueList IClient::OnlineValues() const {
+  std::scoped_lock lock(value_locker_);
+  return online_value_list_;
+}
+
+bool IClient::SetPointValue(std::string_view name, float value) {
+  std::optional<size_t> index;
+  {
+    std::scoped_lock lock(value_locker_);
+    index = setpoint_index_.Find(name);
+  }
+  return index && SetPointValue(*index, value);
+}
+
+bool IClient::SetPointValue(size_t index, float value) {
+  std::scoped_lock lock(value_locker_);
+  if (index >= output_value_list_.size()) {
+    return false;
+  }
+  auto& output = output_value_list_[index];
+  output.value = ToTypedValue(output.type, value);
+  setpoint_value_list_[index] = value;
+  if (setpoint_dirty_list_[index] != 0) {
+    // Last write wins. The pending value is replaced in place.
+    ++metrics_.setpoints_coalesced;
+  } else {
+    setpoint_dirty_list_[index] = 1;
+    setpoint_pending_list_.push_back(index);
+  }
+  return true;
+}
+
+DataValueList IClient::OutputValues() const {
+  std::scoped_lock lock(value_locker_);
+  return output_value_list_;
+}
+
+size_t IClient::FlushSetPoints() {
+  if (!IsConnected()) {
+    return 0;
+  }
+  // One frame holds the values and the set-point indexes of one LUN
+  struct SetPointFrame {
+    CommandCode cmd = CommandCode::SET_PARAMETER_EV2;
+    DataValueList data_list;
+    std::vector<size_t> index_list;
+  };
+  std::vector<SetPointFrame> frame_list;
+  size_t nof_values = 0;
+  uint64_t epoch = 0;
+  {
+    std::scoped_lock lock(value_locker_);
+    if (setpoint_in_flight_ > 0 || setpoint_pending_list_.empty()) {
+      return 0;
+    }
+    std::map<uint16_t, std::vector<size_t>> lun_list;
+    for (const auto index : setpoint_pending_list_) {
+      lun_list[setpoint_lun_list_[index]].push_back(index);
+      setpoint_dirty_list_[index] = 0;
+      setpoint_sent_list_[index] = 1;
+    }
+    nof_values = setpoint_pending_list_.size();
+    setpoint_pending_list_.clear();
+
+    for (const auto& [lun, index_list] : lun_list) {
+      if (!batch_setpoints_) {
+        for (const auto index : index_list) {
+          SetPointFrame frame;
+          frame.cmd = CommandCode::SET_PARAMETER;
+          frame.data_list = {
+              {"LUN", Mc3DataType::A_UINT16, lun},
+              {"Name", Mc3DataType::MC3_STRING, output_value_list_[index].name},
+              {"Value", Mc3DataType::A_FLOAT32, setpoint_value_list_[index]},
+              {"Delay", Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+          };
+          frame.index_list.push_back(index);
+          frame_list.push_back(std::move(frame));
+        }
+        continue;
+      }
+
+      // Length, command, LUN, number of values and checksum
+      constexpr size_t kHeaderSize = 5 * sizeof(uint16_t);
+      size_t frame_size = kMaxFrameSize;
+      for (const auto index : index_list) {
+        const auto& name = output_value_list_[index].name;
+        const auto size = SetPointSize(name);
+        if (frame_size + size > kMaxFrameSize) {
+          SetPointFrame frame;
+          frame.data_list = {
+              {"LUN", Mc3DataType::A_UINT16, lun},
+              {"Parameters", Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+          };
+          frame_list.push_back(std::move(frame));
+          frame_size = kHeaderSize;
+        }
+        auto& frame = frame_list.back();
+        auto& data_list = frame.data_list;
+        data_list.push_back({"Name", Mc3DataType::MC3_STRING, name});
+        data_list.push_back(
+            {"Value", Mc3DataType::A_FLOAT32, setpoint_value_list_[index]});
+        data_list[1].value = static_cast<uint16_t>((data_list.size() - 2) / 2);
+        frame.index_list.push_back(index);
+        frame_size += size;
+      }
+    }
+    setpoint_in_flight_ += frame_list.size();
+    epoch = setpoint_epoch_;
+  }
+  metrics_.setpoints_sent += nof_values;
+
+  for (auto& frame : frame_list) {
+    auto on_sent = [this, epoch, index_list = std::move(frame.index_list)](
+                       bool success, const ITelegram&) {
+      OnSetPointsSent(epoch, index_list, success);
+    };
+    SendTelegram(frame.cmd, frame.data_list, on_sent);
+  }
+  return nof_values;
+}
+
+void IClient::OnSetPointsSent(uint64_t epoch,
+                              const std::vector<size_t>& index_list,
+                              bool success) {
+  std::scoped_lock lock(value_locker_);
+  if (epoch != setpoint_epoch_) {
+    return;  // Already reset when the queue was cleared
+  }
+  for (const auto index : index_list) {
+    if (index >= setpoint_dirty_list_.size()) {
+      continue;
+    }
+    setpoint_sent_list_[index] = 0;
+    // A newer value is already pending if the set-point is dirty
+    if (!success && setpoint_dirty_list_[index] == 0) {
+      setpoint_dirty_list_[index] = 1;
+      setpoint_pending_list_.push_back(index);
+    }
+  }
+  if (setpoint_in_flight_ > 0) {
+    --setpoint_in_flight_;
+  }
+}
+
+void IClient::ResetSetPoints() {
+  std::scoped_lock lock(value_locker_);
+  ++setpoint_epoch_;
+  setpoint_in_flight_ = 0;
+  for (size_t index = 0; index < setpoint_sent_list_.size(); ++index) {
+    if (setpoint_sent_list_[index] == 0) {
+      continue;
+    }
+    setpoint_sent_list_[index] = 0;
+    if (setpoint_dirty_list_[index] == 0) {
+      setpoint_dirty_list_[index] = 1;
+      setpoint_pending_list_.push_back(index);
+    }
+  }
+}
+
+bool IClient::OpenSharedValues(const std::string& name) {
+  auto reader = std::make_shared<SharedValueReader>();
+  if (!reader->Open(name)) {
+    listen_->ListenOut() << "Shared memory open failure. Name: " << name;
+    return false;
+  }
+  listen_->ListenOut() << "Online values from shared memory. Name: " << name;
+  std::scoped_lock lock(value_locker_);
+  shared_reader_ = std::move(reader);
+  return true;
+}
+
+void IClient::CloseSharedValues() {
+  std::scoped_lock lock(value_locker_);
+  shared_reader_.reset();
+}
+
+bool IClient::IsSharedMemory() const {
+  std::scoped_lock lock(value_locker_);
+  return static_cast<bool>(shared_reader_);
+}
+
+bool IClient::ReadSharedValues() {
+  std::shared_ptr<SharedValueReader> reader;
+  {
+    std::scoped_lock lock(value_locker_);
+    reader = shared_reader_;
+  }
+  std::vector<double> value_list;
+  if (!reader || !reader->Read(value_list)) {
+    return false;
+  }
+  // The table is in subscription order, same as GET_ONLINE_VALUE
+  std::scoped_lock lock(value_locker_);
+  if (value_list.size() != online_value_list_.size()) {
+    return false;
+  }
+  for (size_t index = 0; index < value_list.size(); ++index) {
+    auto& online = online_value_list_[index];
+    online.value = ToTypedValue(online.type, value_list[index]);
+  }
+  ExportValues();
+  return true;
+}
+
+void IClient::ExportName(const std::string& name) {
+  std::scoped_lock lock(value_locker_);
+  if (name == export_name_) {
+    return;
+  }
+  export_name_ = name;
+  export_table_.reset();
+}
+
+std::string IClient::ExportName() const {
+  std::scoped_lock lock(value_locker_);
+  return export_name_;
+}
+
+void IClient::ExportParameters() {
+  if (export_name_.empty()) {
+    return;
+  }
+  if (!export_table_) {
+    auto table = std::make_unique<OnlineTableWriter>();
+    if (!table->Create(export_name_, export_capacity_)) {
+      listen_->ListenOut() << "Online table export failure. Name: "
+                           << export_name_;
+      export_name_.clear();
+      return;
+    }
+    export_table_ = std::move(table);
+  }
+  std::vector<SharedParameter> shared_list;
+  shared_list.reserve(online_value_list_.size());
+  for (const auto& parameter : parameter_list_) {
+    if (parameter.SetPoint()) {
+      continue;
+    }
+    SharedParameter shared;
+    // A truncated name may match another parameter, so it isn't exported
+    if (parameter.Name().size() >= sizeof(shared.name)) {
+      listen_->ListenOut() << "Too long name to export. Name: "
+                           << parameter.Name();
+      continue;
+    }
+    // Keep the terminating null
+    parameter.Name().copy(shared.name, sizeof(shared.name) - 1);
+    parameter.Unit().copy(shared.unit, sizeof(shared.unit) - 1);
+    shared.type = static_cast<uint16_t>(parameter.Type());
+    shared.nof_decimals = parameter.NofDecimals();
+    shared.index = static_cast<uint32_t>(parameter.ValueIndex());
+    shared.min = parameter.Min();
+    shared.max = parameter.Max();
+    shared_list.push_back(shared);
+  }
+  if (!export_table_->WriteParameters(shared_list)) {
+    listen_->ListenOut() << "Too many parameters to export. Parameters: "
+                         << shared_list.size();
+  }
+  export_value_list_.resize(online_value_list_.size());
+}
+
+void IClient::ExportValues() {
+  if (!export_table_) {
+    return;
+  }
+  export_value_list_.resize(online_value_list_.size());
+  for (size_t index = 0; index < online_value_list_.size(); ++index) {
+    export_value_list_[index] = ToDouble(online_value_list_[index]);
+  }
+  export_table_->WriteValues(export_value_list_);
+}
+
+void IClient::Unacknowledged(CommandCode cmd, bool unacknowledged) {
+  const auto index = static_cast<size_t>(cmd) % unacknowledged_list_.size();
+  unacknowledged_list_[index] = unacknowledged;
+}
+
+bool IClient::Unacknowledged(CommandCode cmd) const {
+  const auto index = static_cast<size_t>(cmd) % unacknowledged_list_.size();
+  return unacknowledged_list_[index];
+}
+
+void IClient::ClearUnacknowledged() {
+  for (auto& unacknowledged : unacknowledged_list_) {
+    unacknowledged = false;
+  }
+}
+
 bool IClient::StopSubscription() { return false; }
 bool IClient::IsScanning() const { return false; }
+IClient::LatencySet& IClient::GetLatencySet(CommandCode cmd) {
+  const auto index = static_cast<size_t>(cmd) % latency_list_.size();
+  auto* latency = latency_list_[index].load(std::memory_order_acquire);
+  if (latency != nullptr) {
+    return *latency;
+  }
+  std::scoped_lock lock(latency_locker_);
+  latency = latency_list_[index].load(std::memory_order_acquire);
+  if (latency == nullptr) {
+    auto temp = std::make_unique<LatencySet>();
+    latency = temp.get();
+    latency_owner_list_.push_back(std::move(temp));
+    latency_list_[index].store(latency, std::memory_order_release);
+  }
+  return *latency;
+}
+
+void IClient::RecordLatency(const ITelegram& telegram) {
+  const auto* request = telegram.Request();
+  if (request == nullptr) {
+    return;
+  }
+  const ITelegram::TimePoint none = {};
+  auto& stage_list = GetLatencySet(request->Cmd()).stage_list;
+  auto record = [&](LatencyStage stage, ITelegram::TimePoint from,
+                    ITelegram::TimePoint to) {
+    if (from != none && to != none) {
+      stage_list[static_cast<size_t>(stage)].Record(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(to - from)
+              .count());
+    }
+  };
+  record(LatencyStage::QueueTime, telegram.EnqueueTime(), telegram.SendTime());
+  record(LatencyStage::ServerTime, telegram.SendTime(),
+         telegram.FirstByteTime());
+  record(LatencyStage::HandleTime, telegram.ReceiveTime(),
+         telegram.CompleteTime());
+  if (telegram.HasCallback()) {
+    stage_list[static_cast<size_t>(LatencyStage::CallbackTime)].Record(
+        telegram.CallbackTime().count());
+  }
+}
+
+CommandLatencyList IClient::LatencySnapshot() const {
+  CommandLatencyList list;
+  for (size_t index = 0; index < latency_list_.size(); ++index) {
+    const auto* latency = latency_list_[index].load(std::memory_order_acquire);
+    if (latency == nullptr) {
+      continue;
+    }
+    CommandLatency command;
+    command.cmd = static_cast<CommandCode>(index);
+    for (size_t stage = 0; stage < kNofLatencyStages; ++stage) {
+      command.stage_list[stage] = latency->stage_list[stage].Snapshot();
+    }
+    list.push_back(std::move(command));
+  }
+  return list;
+}
+
+void IClient::ResetLatency() {
+  std::scoped_lock lock(latency_locker_);
+  for (auto& latency : latency_owner_list_) {
+    for (auto& stage : latency->stage_list) {
+      stage.Reset();
+    }
+  }
+}
+
 }  // namespace asap3
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 #include "asap/irequest.h"
 
+#include <cstring>
+
 #include "asap3helper.h"
 
 namespace asap3 {
@@ -18,7 +20,8 @@ void IRequest::CreateBody(std::vector<uint8_t> &body) const {
   uint16_t length;
   uint16_t sum;
   const auto temp_size = sizeof(length) + sizeof(cmd_) +
-                         Asap3Helper::DataListSize(data_list_) + sizeof(sum);
+                         Asap3Helper::DataListSize(data_list_) +
+                         payload_.size() + sizeof(sum);
   length = static_cast<uint16_t>(temp_size);
 
   if (body.size() != length) {
@@ -28,6 +31,10 @@ void IRequest::CreateBody(std::vector<uint8_t> &body) const {
   auto offset = Asap3Helper::FromMc3Value(body, 0, length);
   offset += Asap3Helper::FromMc3Value(body, offset, cmd_);
   Asap3Helper::DataListToBody(data_list_, body, offset);
+  if (!payload_.empty()) {
+    memcpy(body.data() + offset, payload_.data(), payload_.size());
+    offset += payload_.size();
+  }
   sum = Asap3Helper::Checksum(body);
   Asap3Helper::FromMc3Value(body, offset, sum);
 }
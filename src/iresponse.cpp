@@ -5,6 +5,7 @@
 
 #include "asap/iresponse.h"
 
+#include <cstring>
 #include <sstream>
 
 #include "asap/iclient.h"
@@ -35,6 +36,16 @@ const asap3::DataValueList kGetCalInfoResponse = {
     {"Pages", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
 };
 
+const asap3::DataValueList kCurrentCalPageResponse = {
+    {"Page", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+};
+
+const asap3::DataValueList kSelectLookupTableResponse = {
+    {"Address", asap3::Mc3DataType::A_UINT32, static_cast<uint32_t>(0)},
+    {"X Dim", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+    {"Y Dim", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+};
+
 const asap3::DataValueList kServiceInfoResponse = {
     {"Service Info", asap3::Mc3DataType::MC3_STRING, std::string()},
 };
@@ -42,13 +53,22 @@ const asap3::DataValueList kServiceInfoResponse = {
 const asap3::DataValueList kExecuteServiceResponse = {
     {"Output", asap3::Mc3DataType::MC3_STRING, std::string()},
 };
+
+const asap3::DataValueList kCharacteristicInfoResponse = {
+    {"Type", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+    {"Min", asap3::Mc3DataType::A_FLOAT32, 0.0F},
+    {"Max", asap3::Mc3DataType::A_FLOAT32, 0.0F},
+    {"Increment", asap3::Mc3DataType::A_FLOAT32, 0.0F},
+    {"Dimensions", asap3::Mc3DataType::A_UINT16, static_cast<uint16_t>(0)},
+};
 }  // namespace
 
 namespace asap3 {
 
 void IResponse::CreateBody(std::vector<uint8_t> &body) {
   auto temp_size = sizeof(length_) + sizeof(cmd_) + sizeof(status_) +
-                   Asap3Helper::DataListSize(data_list_) + sizeof(sum_);
+                   Asap3Helper::DataListSize(data_list_) + payload_.size() +
+                   sizeof(sum_);
   length_ = static_cast<uint16_t>(temp_size);
   if (body.size() != length_) {
     body.resize(length_);
@@ -58,6 +78,10 @@ void IResponse::CreateBody(std::vector<uint8_t> &body) {
   offset += Asap3Helper::FromMc3Value(body, offset, cmd_);
   offset += Asap3Helper::FromMc3Value(body, offset, status_);
   Asap3Helper::DataListToBody(data_list_, body, offset);
+  if (!payload_.empty()) {
+    memcpy(body.data() + offset, payload_.data(), payload_.size());
+    offset += payload_.size();
+  }
   sum_ = Asap3Helper::Checksum(body);
   Asap3Helper::FromMc3Value(body, offset, sum_);
 }
@@ -77,7 +101,8 @@ IResponse::IResponse(IClient *client,
   BodyToDataList(body_without_length, offset);
   Asap3Helper::ToMc3Value(body_without_length, body_without_length.size() - 2,
                           sum_);
-  const auto sum = length_ + Asap3Helper::Checksum(body_without_length);
+  const auto sum = static_cast<uint16_t>(
+      length_ + Asap3Helper::Checksum(body_without_length));
   invalid_checksum_ = sum != sum_;
 }
 
@@ -135,6 +160,18 @@ void IResponse::BodyToDataList(const std::vector<uint8_t> &body,
       break;
     }
 
+    case CommandCode::GET_CURRENT_CALPAGE:
+      data_list_ = kCurrentCalPageResponse;
+      break;
+
+    case CommandCode::SELECT_LOOKUP_TABLE_EV2:
+      data_list_ = kSelectLookupTableResponse;
+      break;
+
+    case CommandCode::GET_LOOKUP_TABLE_EV2:
+      GetLookupTableToDataList(body, offset);
+      return;
+
     case CommandCode::GET_ONLINE_VALUE:
     case CommandCode::GET_ONLINE_VALUE_EV2:
       // Fills the previously defined online_value_list_
@@ -168,6 +205,28 @@ void IResponse::BodyToDataList(const std::vector<uint8_t> &body,
       data_list_ = kExecuteServiceResponse;
       break;
 
+    case CommandCode::GET_CHARACTERISTIC_INFO: {
+      // Type, min, max and increment precede the number of dimensions
+      uint16_t dimensions = 0;
+      Asap3Helper::ToMc3Value(body, offset + 14, dimensions);
+      data_list_ = kCharacteristicInfoResponse;
+      for (uint16_t dimension = 0; dimension < dimensions; ++dimension) {
+        std::ostringstream temp;
+        temp << "Dimension " << dimension + 1;
+        data_list_.push_back(
+            {temp.str(), Mc3DataType::A_UINT16, static_cast<uint16_t>(0)});
+      }
+      break;
+    }
+
+    case CommandCode::READ_CHARACTERISTIC:
+      ReadCharacteristicToDataList(body, offset);
+      return;
+
+    case CommandCode::READ_CELL_VALUES:
+      ReadCellValuesToDataList(body, offset);
+      return;
+
     default:
       // Empty response list
       break;
@@ -218,6 +277,77 @@ void IResponse::QueryAvailableServicesToDataList(
   }
 }
 
+void IResponse::ReadCharacteristicToDataList(const std::vector<uint8_t> &body,
+                                             size_t offset) {
+  // Type, dimensions, dimension sizes, axis points and the values. Only the
+  // header is added to the data list.
+  size_t index = offset;
+  uint16_t type = 0;
+  uint16_t dimensions = 0;
+  index += Asap3Helper::ToMc3Value(body, index, type);
+  index += Asap3Helper::ToMc3Value(body, index, dimensions);
+  data_list_.push_back({"Type", Mc3DataType::A_UINT16, type});
+  data_list_.push_back({"Dimensions", Mc3DataType::A_UINT16, dimensions});
+
+  std::vector<uint16_t> dimension_list(dimensions, 0);
+  index += Asap3Helper::ToMc3Array(body, index,
+                                   std::span<uint16_t>(dimension_list));
+  const auto char_type = static_cast<Mc3CharType>(type);
+  size_t nof_floats = 1;
+  for (const auto dimension : dimension_list) {
+    nof_floats *= dimension;
+    if (nof_floats > body.size()) {
+      return;  // Also stops an overflow
+    }
+  }
+  if (Characteristic::HasAxes(char_type)) {
+    for (const auto dimension : dimension_list) {
+      nof_floats += dimension;
+    }
+  }
+  if (index + nof_floats * sizeof(float) + 2 > body.size()) {
+    return;  // Truncated response
+  }
+
+  auto characteristic = std::make_shared<Characteristic>();
+  characteristic->Resize(char_type, std::move(dimension_list));
+  for (size_t axis = 0; axis < characteristic->NofAxes(); ++axis) {
+    index += Asap3Helper::ToMc3Array(body, index, characteristic->Axis(axis));
+  }
+  Asap3Helper::ToMc3Array(body, index, characteristic->Values());
+  characteristic_ = std::move(characteristic);
+}
+
+void IResponse::ReadCellValuesToDataList(const std::vector<uint8_t> &body,
+                                         size_t offset) {
+  uint16_t values = 0;
+  size_t index = offset;
+  index += Asap3Helper::ToMc3Value(body, index, values);
+  data_list_.push_back({"Values", Mc3DataType::A_UINT16, values});
+  if (index + values * sizeof(float) + 2 > body.size()) {
+    return;
+  }
+  value_array_.resize(values);
+  Asap3Helper::ToMc3Array(body, index, std::span<float>(value_array_));
+}
+
+void IResponse::GetLookupTableToDataList(const std::vector<uint8_t> &body,
+                                         size_t offset) {
+  uint16_t x_dim = 0;
+  uint16_t y_dim = 0;
+  size_t index = offset;
+  index += Asap3Helper::ToMc3Value(body, index, x_dim);
+  index += Asap3Helper::ToMc3Value(body, index, y_dim);
+  data_list_.push_back({"X Dim", Mc3DataType::A_UINT16, x_dim});
+  data_list_.push_back({"Y Dim", Mc3DataType::A_UINT16, y_dim});
+  const size_t values = static_cast<size_t>(x_dim) * y_dim;
+  if (index + values * sizeof(float) + 2 > body.size()) {
+    return;
+  }
+  value_array_.resize(values);
+  Asap3Helper::ToMc3Array(body, index, std::span<float>(value_array_));
+}
+
 template <>
 std::string IResponse::GetData(size_t index) const {
   std::string value;
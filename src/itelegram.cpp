@@ -14,9 +14,15 @@ ITelegram::ITelegram(CommandCode cmd, const DataValueList &data_list,
     : request_(std::make_unique<IRequest>(cmd, data_list)),
       on_complete_(std::move(on_complete)) {}
 
+ITelegram::ITelegram(std::unique_ptr<IRequest> request,
+                     OnCompleteFunction on_complete)
+    : request_(std::move(request)), on_complete_(std::move(on_complete)) {}
+
 void ITelegram::OnComplete(bool success) {
+  complete_time_ = std::chrono::steady_clock::now();
   if (on_complete_) {
     on_complete_(success, *this);
+    callback_time_ = std::chrono::steady_clock::now() - complete_time_;
   }
 }
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/latencyhistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace asap3 {
+
+uint64_t HistogramSnapshot::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto limit = std::clamp(percentile, 0.0, 100.0);
+  auto rank = static_cast<uint64_t>(
+      std::ceil(limit / 100.0 * static_cast<double>(count_)));
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t sum = 0;
+  for (size_t index = 0; index < bucket_list_.size(); ++index) {
+    sum += bucket_list_[index];
+    if (sum >= rank) {
+      return std::clamp(LatencyHistogram::BucketHighValue(index), min_, max_);
+    }
+  }
+  return max_;
+}
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& bucket : bucket_list_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  const auto shift = static_cast<size_t>(std::bit_width(value)) - 1 -
+                     kSubBucketBits;
+  const auto sub_bucket =
+      static_cast<size_t>(value >> shift) & (kSubBuckets - 1);
+  return std::min((shift + 1) * kSubBuckets + sub_bucket, kNofBuckets - 1);
+}
+
+uint64_t LatencyHistogram::BucketLowValue(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const auto shift = index / kSubBuckets - 1;
+  const auto sub_bucket = index % kSubBuckets;
+  return static_cast<uint64_t>(kSubBuckets + sub_bucket) << shift;
+}
+
+uint64_t LatencyHistogram::BucketHighValue(size_t index) {
+  if (index + 1 >= kNofBuckets) {
+    return UINT64_MAX;
+  }
+  return BucketLowValue(index + 1) - 1;
+}
+
+void LatencyHistogram::Record(int64_t ns) {
+  const auto value = ns < 0 ? 0 : static_cast<uint64_t>(ns);
+  bucket_list_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+
+  auto min = min_.load(std::memory_order_relaxed);
+  while (value < min && !min_.compare_exchange_weak(
+                            min, value, std::memory_order_relaxed)) {
+  }
+  auto max = max_.load(std::memory_order_relaxed);
+  while (value > max && !max_.compare_exchange_weak(
+                            max, value, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : bucket_list_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_ = 0;
+  min_ = UINT64_MAX;
+  max_ = 0;
+  sum_ = 0;
+}
+
+HistogramSnapshot LatencyHistogram::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.count_ = count_.load(std::memory_order_relaxed);
+  snapshot.min_ = min_.load(std::memory_order_relaxed);
+  snapshot.max_ = max_.load(std::memory_order_relaxed);
+  snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+
+  // Trim trailing empty buckets to keep the snapshot small.
+  size_t last = 0;
+  for (size_t index = 0; index < bucket_list_.size(); ++index) {
+    if (bucket_list_[index].load(std::memory_order_relaxed) > 0) {
+      last = index + 1;
+    }
+  }
+  snapshot.bucket_list_.reserve(last);
+  for (size_t index = 0; index < last; ++index) {
+    snapshot.bucket_list_.push_back(
+        bucket_list_[index].load(std::memory_order_relaxed));
+  }
+  return snapshot;
+}
+
+}  // namespace asap3
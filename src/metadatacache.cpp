@@ -0,0 +1,211 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/metadatacache.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace boost::interprocess;
+
+namespace {
+
+// The numbers are stored in native byte order. The magic word detects a file
+// from a machine with another byte order.
+constexpr uint32_t kMagic = 0x434D3341;  // "A3MC"
+constexpr uint32_t kFormatVersion = 2;
+
+class CacheWriter {
+ public:
+  template <typename T>
+  void Write(T value) {
+    const auto* data = reinterpret_cast<const char*>(&value);
+    buffer_.append(data, sizeof(T));
+  }
+
+  void Write(const std::string& text) {
+    Write(static_cast<uint32_t>(text.size()));
+    buffer_.append(text);
+  }
+
+  [[nodiscard]] const std::string& Buffer() const { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+class CacheReader {
+ public:
+  CacheReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  T Read() {
+    Check(sizeof(T));
+    T value = {};
+    memcpy(&value, data_ + position_, sizeof(T));
+    position_ += sizeof(T);
+    return value;
+  }
+
+  std::string ReadString() {
+    const auto length = Read<uint32_t>();
+    Check(length);
+    std::string text(data_ + position_, length);
+    position_ += length;
+    return text;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t position_ = 0;
+
+  void Check(size_t bytes) const {
+    if (position_ + bytes > size_) {
+      throw std::out_of_range("Truncated metadata cache file");
+    }
+  }
+};
+
+void WriteParameterList(CacheWriter& writer,
+                        const asap3::A3ParameterList& parameter_list) {
+  writer.Write(static_cast<uint32_t>(parameter_list.size()));
+  for (const auto& parameter : parameter_list) {
+    writer.Write(parameter.Name());
+    writer.Write(parameter.Unit());
+    writer.Write(parameter.Description());
+    writer.Write(parameter.Device());
+    writer.Write(parameter.Signal());
+    writer.Write(parameter.Identity());
+    writer.Write(parameter.DisplayName());
+    writer.Write(static_cast<uint8_t>(parameter.Type()));
+    writer.Write(static_cast<uint8_t>(parameter.SetPoint() ? 1 : 0));
+    writer.Write(parameter.NofDecimals());
+    writer.Write(parameter.LunNo());
+    writer.Write(static_cast<int32_t>(parameter.CycleTime()));
+    writer.Write(parameter.Min());
+    writer.Write(parameter.Max());
+  }
+}
+
+void ReadParameterList(CacheReader& reader,
+                       asap3::A3ParameterList& parameter_list) {
+  const auto nof_parameters = reader.Read<uint32_t>();
+  parameter_list.reserve(nof_parameters);
+  for (uint32_t index = 0; index < nof_parameters; ++index) {
+    asap3::A3Parameter parameter;
+    parameter.Name(reader.ReadString());
+    parameter.Unit(reader.ReadString());
+    parameter.Description(reader.ReadString());
+    parameter.Device(reader.ReadString());
+    parameter.Signal(reader.ReadString());
+    parameter.Identity(reader.ReadString());
+    parameter.DisplayName(reader.ReadString());
+    parameter.Type(static_cast<asap3::Mc3DataType>(reader.Read<uint8_t>()));
+    parameter.SetPoint(reader.Read<uint8_t>() != 0);
+    parameter.NofDecimals(reader.Read<uint8_t>());
+    parameter.LunNo(reader.Read<uint16_t>());
+    parameter.CycleTime(reader.Read<int32_t>());
+    parameter.Min(reader.Read<double>());
+    parameter.Max(reader.Read<double>());
+    parameter_list.push_back(std::move(parameter));
+  }
+}
+
+}  // namespace
+
+namespace asap3 {
+
+uint64_t MetadataCache::Fingerprint(std::string_view text) {
+  uint64_t hash = 14'695'981'039'346'656'037ULL;
+  for (const char input : text) {
+    hash ^= static_cast<uint8_t>(input);
+    hash *= 1'099'511'628'211ULL;
+  }
+  return hash;
+}
+
+bool MetadataCache::Save(const std::string& filename,
+                         const ServerMetadata& metadata) {
+  CacheWriter writer;
+  writer.Write(kMagic);
+  writer.Write(kFormatVersion);
+  writer.Write(metadata.remote_name);
+  writer.Write(metadata.remote_version);
+  writer.Write(metadata.fingerprint);
+
+  writer.Write(static_cast<uint32_t>(metadata.service_list.size()));
+  for (const auto& service : metadata.service_list) {
+    writer.Write(service.name);
+    writer.Write(service.info);
+  }
+
+  WriteParameterList(writer, metadata.parameter_list);
+  writer.Write(static_cast<uint8_t>(metadata.has_signals ? 1 : 0));
+  WriteParameterList(writer, metadata.signal_list);
+
+  // Write to a temporary file and rename so readers never see a partial file
+  const auto temp_name = filename + ".tmp";
+  {
+    std::ofstream file(temp_name, std::ios_base::binary | std::ios_base::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    file.write(writer.Buffer().data(),
+               static_cast<std::streamsize>(writer.Buffer().size()));
+    if (!file.good()) {
+      return false;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temp_name, filename, error);
+  return !error;
+}
+
+bool MetadataCache::Load(const std::string& filename,
+                         ServerMetadata& metadata) {
+  try {
+    std::error_code error;
+    if (std::filesystem::file_size(filename, error) == 0 || error) {
+      return false;
+    }
+    const file_mapping file(filename.c_str(), read_only);
+    const mapped_region region(file, read_only);
+    CacheReader reader(static_cast<const char*>(region.get_address()),
+                       region.get_size());
+
+    if (reader.Read<uint32_t>() != kMagic ||
+        reader.Read<uint32_t>() != kFormatVersion) {
+      return false;
+    }
+    ServerMetadata temp;
+    temp.remote_name = reader.ReadString();
+    temp.remote_version = reader.Read<uint16_t>();
+    temp.fingerprint = reader.Read<uint64_t>();
+
+    const auto nof_services = reader.Read<uint32_t>();
+    temp.service_list.reserve(nof_services);
+    for (uint32_t index = 0; index < nof_services; ++index) {
+      Service service;
+      service.name = reader.ReadString();
+      service.info = reader.ReadString();
+      temp.service_list.push_back(std::move(service));
+    }
+
+    ReadParameterList(reader, temp.parameter_list);
+    temp.has_signals = reader.Read<uint8_t>() != 0;
+    ReadParameterList(reader, temp.signal_list);
+    metadata = std::move(temp);
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace asap3
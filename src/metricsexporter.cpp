@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "metricsexporter.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "asap/iclient.h"
+
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace asap3 {
+
+MetricsExporter::MetricsExporter(io_context& context, const IClient& client)
+    : context_(context), client_(client), timer_(context) {}
+
+MetricsExporter::~MetricsExporter() { Stop(); }
+
+void MetricsExporter::Start(const std::string& filename,
+                            const std::string& socket_name,
+                            std::chrono::milliseconds period) {
+  filename_ = filename;
+  period_ = period.count() > 0 ? period : std::chrono::seconds(10);
+  if (!filename_.empty()) {
+    DoWait();
+  }
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  socket_name_ = socket_name;
+  if (!socket_name_.empty()) {
+    try {
+      std::error_code dummy;
+      std::filesystem::remove(socket_name_, dummy);
+      acceptor_ = std::make_unique<local::stream_protocol::acceptor>(
+          context_, local::stream_protocol::endpoint(socket_name_));
+      DoAccept();
+    } catch (const std::exception&) {
+      acceptor_.reset();
+    }
+  }
+#endif
+}
+
+void MetricsExporter::Stop() {
+  timer_.cancel();
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  if (acceptor_) {
+    error_code dummy;
+    acceptor_->close(dummy);
+    acceptor_.reset();
+    std::error_code dummy2;
+    std::filesystem::remove(socket_name_, dummy2);
+  }
+#endif
+}
+
+void MetricsExporter::DoWait() {
+  timer_.expires_after(period_);
+  timer_.async_wait([&](const error_code& error) {
+    if (error) {
+      return;
+    }
+    WriteFile();
+    DoWait();
+  });
+}
+
+void MetricsExporter::WriteFile() {
+  // Write to a temporary file and rename so readers never see a partial file
+  const auto text = client_.Metrics().ToPrometheus(client_.Name());
+  const auto temp_name = filename_ + ".tmp";
+  {
+    std::ofstream file(temp_name, std::ios_base::trunc);
+    if (!file.is_open()) {
+      return;
+    }
+    file << text;
+  }
+  std::error_code dummy;
+  std::filesystem::rename(temp_name, filename_, dummy);
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+void MetricsExporter::DoAccept() {
+  if (!acceptor_) {
+    return;
+  }
+  acceptor_->async_accept(
+      [&](const error_code& error, local::stream_protocol::socket socket) {
+        if (error) {
+          return;
+        }
+        auto peer =
+            std::make_shared<local::stream_protocol::socket>(std::move(socket));
+        auto text = std::make_shared<std::string>(
+            client_.Metrics().ToPrometheus(client_.Name()));
+        async_write(*peer, buffer(*text),
+                    [peer, text](const error_code&, size_t) {
+                      error_code dummy;
+                      peer->shutdown(local::stream_protocol::socket::shutdown_both,
+                                     dummy);
+                      peer->close(dummy);
+                    });
+        DoAccept();
+      });
+}
+#endif
+
+}  // namespace asap3
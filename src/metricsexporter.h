@@ -0,0 +1,51 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <boost/asio.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace asap3 {
+
+class IClient;
+
+/** \brief Periodic export of the client metrics in Prometheus text format.
+ *
+ * The text is either written to a file (textfile collector style) or served
+ * on a local (Unix domain) socket where each connection gets one dump. The
+ * exporter runs on the client's I/O context.
+ */
+class MetricsExporter {
+ public:
+  MetricsExporter(boost::asio::io_context& context, const IClient& client);
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter&) = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  void Start(const std::string& filename, const std::string& socket_name,
+             std::chrono::milliseconds period);
+  void Stop();
+
+ private:
+  boost::asio::io_context& context_;
+  const IClient& client_;
+  boost::asio::steady_timer timer_;
+  std::string filename_;
+  std::chrono::milliseconds period_ = std::chrono::seconds(10);
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  std::string socket_name_;
+  std::unique_ptr<boost::asio::local::stream_protocol::acceptor> acceptor_;
+  void DoAccept();
+#endif
+
+  void DoWait();
+  void WriteFile();
+};
+
+}  // namespace asap3
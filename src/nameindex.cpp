@@ -0,0 +1,54 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/nameindex.h"
+
+namespace {
+
+constexpr char ToLower(char input) {
+  return input >= 'A' && input <= 'Z' ? static_cast<char>(input + ('a' - 'A'))
+                                      : input;
+}
+
+}  // namespace
+
+namespace asap3 {
+
+bool IEqualsName(std::string_view name1, std::string_view name2) {
+  if (name1.size() != name2.size()) {
+    return false;
+  }
+  for (size_t index = 0; index < name1.size(); ++index) {
+    if (ToLower(name1[index]) != ToLower(name2[index])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t HashName(std::string_view name) {
+  uint64_t hash = 14'695'981'039'346'656'037ULL;
+  for (const char input : name) {
+    hash ^= static_cast<uint8_t>(ToLower(input));
+    hash *= 1'099'511'628'211ULL;
+  }
+  return hash;
+}
+
+void NameIndex::Add(std::string_view name, size_t index) {
+  if (index_map_.find(name) == index_map_.cend()) {
+    index_map_.emplace(std::string(name), index);
+  }
+}
+
+std::optional<size_t> NameIndex::Find(std::string_view name) const {
+  const auto itr = index_map_.find(name);
+  if (itr == index_map_.cend()) {
+    return std::nullopt;
+  }
+  return itr->second;
+}
+
+}  // namespace asap3
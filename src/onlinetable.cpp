@@ -0,0 +1,271 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/onlinetable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "sharedregion.h"
+
+namespace {
+constexpr size_t kMaxReadAttempts = 10'000;
+
+asap3::OnlineTableHeader* Header(const asap3::SharedRegion& region) {
+  return reinterpret_cast<asap3::OnlineTableHeader*>(region.Data());
+}
+
+asap3::SharedParameter* ParameterData(const asap3::SharedRegion& region) {
+  return reinterpret_cast<asap3::SharedParameter*>(
+      region.Data() + Header(region)->parameter_offset);
+}
+
+double* ValueData(const asap3::SharedRegion& region, uint64_t count) {
+  return reinterpret_cast<double*>(region.Data() +
+                                   Header(region)->value_offset[count % 2]);
+}
+
+uint64_t Load(uint64_t& value,
+              std::memory_order order = std::memory_order_acquire) {
+  return std::atomic_ref(value).load(order);
+}
+
+void Store(uint64_t& value, uint64_t new_value,
+           std::memory_order order = std::memory_order_release) {
+  std::atomic_ref(value).store(new_value, order);
+}
+
+// The value slots are read while they are written, so each value is one
+// atomic access. The region is writable, atomic_ref<const T> is C++26.
+double LoadValue(const double& value) {
+  return std::atomic_ref(const_cast<double&>(value))
+      .load(std::memory_order_relaxed);
+}
+
+void StoreValues(double* data, std::span<const double> value_list) {
+  for (size_t index = 0; index < value_list.size(); ++index) {
+    std::atomic_ref(data[index])
+        .store(value_list[index], std::memory_order_relaxed);
+  }
+}
+
+uint64_t Now() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+}  // namespace
+
+namespace asap3 {
+
+OnlineTableWriter::OnlineTableWriter()
+    : region_(std::make_unique<SharedRegion>()) {}
+
+OnlineTableWriter::~OnlineTableWriter() = default;
+
+bool OnlineTableWriter::Create(const std::string& name, size_t capacity) {
+  const size_t parameter_offset = sizeof(OnlineTableHeader);
+  const size_t value_offset =
+      parameter_offset + capacity * sizeof(SharedParameter);
+  const size_t size = value_offset + 2 * capacity * sizeof(double);
+  if (!region_->Create(name, size)) {
+    return false;
+  }
+  auto* header = new (region_->Data()) OnlineTableHeader();
+  header->capacity = static_cast<uint32_t>(capacity);
+  header->parameter_offset = parameter_offset;
+  header->value_offset[0] = value_offset;
+  header->value_offset[1] = value_offset + capacity * sizeof(double);
+  std::atomic_thread_fence(std::memory_order_release);
+  return true;
+}
+
+void OnlineTableWriter::Close() { region_->Close(); }
+
+bool OnlineTableWriter::IsOpen() const { return region_->IsOpen(); }
+
+const std::string& OnlineTableWriter::Name() const { return region_->Name(); }
+
+size_t OnlineTableWriter::Capacity() const {
+  return IsOpen() ? Header(*region_)->capacity : 0;
+}
+
+uint64_t OnlineTableWriter::Generation() const {
+  return IsOpen() ? Load(Header(*region_)->generation) : 0;
+}
+
+bool OnlineTableWriter::WriteParameters(
+    std::span<const SharedParameter> parameter_list) {
+  if (!IsOpen() || parameter_list.size() > Capacity()) {
+    return false;
+  }
+  auto* header = Header(*region_);
+  const auto sequence = Load(header->meta_sequence, std::memory_order_relaxed);
+  const auto count = Load(header->end_count, std::memory_order_relaxed);
+  Store(header->meta_sequence, sequence + 1, std::memory_order_relaxed);
+  Store(header->begin_count, count + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::memcpy(ParameterData(*region_), parameter_list.data(),
+              parameter_list.size_bytes());
+  std::atomic_ref(header->nof_values)
+      .store(static_cast<uint32_t>(parameter_list.size()),
+             std::memory_order_relaxed);
+  // Old values don't belong to the new parameters
+  const std::vector<double> nan_list(parameter_list.size(),
+                                     std::numeric_limits<double>::quiet_NaN());
+  for (uint64_t buffer = 0; buffer < 2; ++buffer) {
+    StoreValues(ValueData(*region_, buffer), nan_list);
+  }
+  Store(header->generation, Load(header->generation) + 1,
+        std::memory_order_relaxed);
+  Store(header->end_count, count + 1);
+  Store(header->meta_sequence, sequence + 2);
+  return true;
+}
+
+bool OnlineTableWriter::WriteValues(std::span<const double> value_list) {
+  if (!IsOpen()) {
+    return false;
+  }
+  auto* header = Header(*region_);
+  if (value_list.size() != header->nof_values) {
+    return false;
+  }
+  // Fill the buffer that readers don't use and then flip to it
+  const auto count = Load(header->end_count, std::memory_order_relaxed);
+  Store(header->begin_count, count + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  StoreValues(ValueData(*region_, count + 1), value_list);
+  Store(header->time, Now(), std::memory_order_relaxed);
+  Store(header->end_count, count + 1);
+  return true;
+}
+
+OnlineTableReader::OnlineTableReader()
+    : region_(std::make_unique<SharedRegion>()) {}
+
+OnlineTableReader::~OnlineTableReader() = default;
+
+bool OnlineTableReader::Open(const std::string& name) {
+  if (!region_->Open(name)) {
+    return false;
+  }
+  const auto* header = Header(*region_);
+  const auto size = region_->Size();
+  if (size < sizeof(OnlineTableHeader) ||
+      header->magic != OnlineTableHeader::kMagic ||
+      header->version != OnlineTableHeader::kVersion ||
+      header->parameter_offset +
+              header->capacity * sizeof(SharedParameter) > size ||
+      header->value_offset[1] + header->capacity * sizeof(double) > size) {
+    region_->Close();
+    return false;
+  }
+  return true;
+}
+
+void OnlineTableReader::Close() { region_->Close(); }
+
+bool OnlineTableReader::IsOpen() const { return region_->IsOpen(); }
+
+const std::string& OnlineTableReader::Name() const { return region_->Name(); }
+
+uint64_t OnlineTableReader::Generation() const {
+  return IsOpen() ? Load(Header(*region_)->generation) : 0;
+}
+
+bool OnlineTableReader::ReadParameters(
+    std::vector<SharedParameter>& parameter_list, uint64_t* generation) const {
+  if (!IsOpen()) {
+    return false;
+  }
+  auto* header = Header(*region_);
+  for (size_t attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    const auto sequence = Load(header->meta_sequence);
+    if ((sequence & 1) != 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    const auto nof_values =
+        std::min(std::atomic_ref(header->nof_values).load(
+                     std::memory_order_relaxed),
+                 header->capacity);
+    parameter_list.resize(nof_values);
+    std::memcpy(parameter_list.data(), ParameterData(*region_),
+                nof_values * sizeof(SharedParameter));
+    const auto current = Load(header->generation, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (Load(header->meta_sequence, std::memory_order_relaxed) == sequence) {
+      if (generation != nullptr) {
+        *generation = current;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+OnlineTableReader::View OnlineTableReader::Latest() const {
+  View view;
+  if (!IsOpen()) {
+    return view;
+  }
+  auto* header = Header(*region_);
+  const auto sequence = Load(header->meta_sequence);
+  if ((sequence & 1) != 0) {
+    return view;
+  }
+  view.count = Load(header->end_count);
+  view.generation = Load(header->generation, std::memory_order_relaxed);
+  view.time = Load(header->time, std::memory_order_relaxed);
+  const auto nof_values = std::min(
+      std::atomic_ref(header->nof_values).load(std::memory_order_relaxed),
+      header->capacity);
+  view.value_list = {ValueData(*region_, view.count), nof_values};
+  return view;
+}
+
+bool OnlineTableReader::IsValid(const View& view) const {
+  if (!IsOpen()) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  auto* header = Header(*region_);
+  // The buffer is reused by write count + 2
+  return Load(header->begin_count, std::memory_order_relaxed) <=
+             view.count + 1 &&
+         Load(header->generation, std::memory_order_relaxed) ==
+             view.generation &&
+         (Load(header->meta_sequence, std::memory_order_relaxed) & 1) == 0;
+}
+
+bool OnlineTableReader::Read(std::vector<double>& value_list,
+                             uint64_t* generation) const {
+  for (size_t attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    const auto view = Latest();
+    if (view.count == 0 && view.value_list.empty() && !IsOpen()) {
+      return false;
+    }
+    value_list.resize(view.value_list.size());
+    std::ranges::transform(view.value_list, value_list.begin(), LoadValue);
+    if (IsValid(view)) {
+      if (generation != nullptr) {
+        *generation = view.generation;
+      }
+      return true;
+    }
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+}  // namespace asap3
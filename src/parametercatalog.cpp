@@ -0,0 +1,197 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/parametercatalog.h"
+
+#include <unordered_map>
+
+namespace asap3 {
+
+std::string_view ParameterView::Name() const {
+  return catalog_->Text(catalog_->name_list_[index_]);
+}
+
+std::string_view ParameterView::DisplayName() const {
+  return catalog_->Text(catalog_->display_name_list_[index_]);
+}
+
+std::string_view ParameterView::Description() const {
+  return catalog_->Text(catalog_->description_list_[index_]);
+}
+
+std::string_view ParameterView::Unit() const {
+  return catalog_->Text(catalog_->unit_list_[index_]);
+}
+
+std::string_view ParameterView::Device() const {
+  return catalog_->Text(catalog_->device_list_[index_]);
+}
+
+std::string_view ParameterView::Identity() const {
+  return catalog_->Text(catalog_->identity_list_[index_]);
+}
+
+std::string_view ParameterView::Signal() const {
+  return catalog_->Text(catalog_->signal_list_[index_]);
+}
+
+Mc3DataType ParameterView::Type() const {
+  return catalog_->type_list_[index_];
+}
+
+double ParameterView::Max() const { return catalog_->max_list_[index_]; }
+
+double ParameterView::Min() const { return catalog_->min_list_[index_]; }
+
+bool ParameterView::SetPoint() const {
+  return catalog_->set_point_list_[index_] != 0;
+}
+
+uint8_t ParameterView::NofDecimals() const {
+  return catalog_->nof_decimals_list_[index_];
+}
+
+int ParameterView::CycleTime() const {
+  return catalog_->cycle_time_list_[index_];
+}
+
+uint16_t ParameterView::LunNo() const { return catalog_->lun_list_[index_]; }
+
+A3Parameter ParameterView::ToParameter() const {
+  A3Parameter parameter;
+  parameter.Name(std::string(Name()));
+  parameter.DisplayName(std::string(DisplayName()));
+  parameter.Description(std::string(Description()));
+  parameter.Unit(std::string(Unit()));
+  parameter.Device(std::string(Device()));
+  parameter.Identity(std::string(Identity()));
+  parameter.Signal(std::string(Signal()));
+  parameter.Type(Type());
+  parameter.Max(Max());
+  parameter.Min(Min());
+  parameter.SetPoint(SetPoint());
+  parameter.NofDecimals(NofDecimals());
+  parameter.CycleTime(CycleTime());
+  parameter.LunNo(LunNo());
+  return parameter;
+}
+
+std::shared_ptr<const ParameterCatalog> ParameterCatalog::Create(
+    const A3ParameterList& parameter_list) {
+  // The constructor is private, so make_shared cannot be used.
+  std::shared_ptr<ParameterCatalog> catalog(new ParameterCatalog);
+  const auto size = parameter_list.size();
+
+  // The map only lives while the catalog is built. The keys point into the
+  // parameter list and not into the arena, which may be reallocated.
+  std::unordered_map<std::string_view, uint32_t> intern_map;
+  intern_map.reserve(size * 2);
+  catalog->text_list_.push_back({});
+  intern_map.emplace(std::string_view(), 0);
+
+  auto intern = [&](const std::string& text) -> uint32_t {
+    const auto [itr, inserted] = intern_map.emplace(
+        text, static_cast<uint32_t>(catalog->text_list_.size()));
+    if (inserted) {
+      catalog->text_list_.push_back(
+          {static_cast<uint32_t>(catalog->arena_.size()),
+           static_cast<uint32_t>(text.size())});
+      catalog->arena_.append(text);
+    }
+    return itr->second;
+  };
+
+  auto& cat = *catalog;
+  cat.name_list_.reserve(size);
+  cat.display_name_list_.reserve(size);
+  cat.description_list_.reserve(size);
+  cat.unit_list_.reserve(size);
+  cat.device_list_.reserve(size);
+  cat.identity_list_.reserve(size);
+  cat.signal_list_.reserve(size);
+  cat.type_list_.reserve(size);
+  cat.max_list_.reserve(size);
+  cat.min_list_.reserve(size);
+  cat.set_point_list_.reserve(size);
+  cat.nof_decimals_list_.reserve(size);
+  cat.cycle_time_list_.reserve(size);
+  cat.lun_list_.reserve(size);
+
+  for (const auto& parameter : parameter_list) {
+    cat.name_list_.push_back(intern(parameter.Name()));
+    cat.display_name_list_.push_back(intern(parameter.DisplayName()));
+    cat.description_list_.push_back(intern(parameter.Description()));
+    cat.unit_list_.push_back(intern(parameter.Unit()));
+    cat.device_list_.push_back(intern(parameter.Device()));
+    cat.identity_list_.push_back(intern(parameter.Identity()));
+    cat.signal_list_.push_back(intern(parameter.Signal()));
+    cat.type_list_.push_back(parameter.Type());
+    cat.max_list_.push_back(parameter.Max());
+    cat.min_list_.push_back(parameter.Min());
+    cat.set_point_list_.push_back(parameter.SetPoint() ? 1 : 0);
+    cat.nof_decimals_list_.push_back(parameter.NofDecimals());
+    cat.cycle_time_list_.push_back(parameter.CycleTime());
+    cat.lun_list_.push_back(parameter.LunNo());
+  }
+  cat.name_index_.Reserve(size);
+  cat.display_name_index_.Reserve(size);
+  cat.identity_index_.Reserve(size);
+  for (size_t index = 0; index < size; ++index) {
+    const auto& parameter = parameter_list[index];
+    cat.name_index_.Add(parameter.Name(), index);
+    if (!parameter.DisplayName().empty()) {
+      cat.display_name_index_.Add(parameter.DisplayName(), index);
+    }
+    if (!parameter.Identity().empty()) {
+      cat.identity_index_.Add(parameter.Identity(), index);
+    }
+  }
+  cat.arena_.shrink_to_fit();
+  cat.text_list_.shrink_to_fit();
+  return catalog;
+}
+
+A3ParameterList ParameterCatalog::ToParameterList() const {
+  A3ParameterList list;
+  list.reserve(Size());
+  for (const auto view : *this) {
+    list.push_back(view.ToParameter());
+  }
+  return list;
+}
+
+const SearchIndex& ParameterCatalog::NameSearch() const {
+  std::call_once(search_flag_, [&] {
+    std::vector<std::string_view> name_list;
+    name_list.reserve(Size());
+    for (const auto text_index : name_list_) {
+      name_list.push_back(Text(text_index));
+    }
+    search_index_ = std::make_unique<SearchIndex>(name_list);
+  });
+  return *search_index_;
+}
+
+std::vector<ParameterView> ParameterCatalog::Search(std::string_view pattern,
+                                                    size_t limit) const {
+  const auto& search = NameSearch();
+  const auto index_list =
+      pattern.find_first_of("*?") != std::string_view::npos
+          ? search.Glob(pattern, limit)
+          : search.Substring(pattern, limit);
+  std::vector<ParameterView> list;
+  list.reserve(index_list.size());
+  for (const auto index : index_list) {
+    list.emplace_back(*this, index);
+  }
+  return list;
+}
+
+std::string_view ParameterCatalog::Text(uint32_t text_index) const {
+  const auto& ref = text_list_[text_index];
+  return {arena_.data() + ref.offset, ref.size};
+}
+
+}  // namespace asap3
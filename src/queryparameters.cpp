@@ -8,8 +8,10 @@
 #include <util/logstream.h>
 #include <util/stringutil.h>
 
+#include <algorithm>
 #include <string_view>
 
+#include "asap/metadatacache.h"
 #include "asap3helper.h"
 
 using namespace util::log;
@@ -18,11 +20,28 @@ using namespace util::string;
 namespace {
 constexpr std::string_view kGetNofParameters = "Get Number of Parameters";
 constexpr std::string_view kGetParameterConfig = "Get Parameter Configuration";
+constexpr std::string_view kGetNofSignals = "Get Number of Signals";
+constexpr std::string_view kGetSignalConfig = "Get Signal Configuration";
+constexpr std::string_view kGetConfigFile = "Get Config File";
 const asap3::DataValueList kEmptyList;
 }  // namespace
 
 namespace asap3 {
 
+QueryParameters::QueryParameters() {
+  auto& parameters = discovery_list_[0];
+  parameters.nof_service = kGetNofParameters;
+  parameters.config_service = kGetParameterConfig;
+  parameters.list = &parameter_list_;
+  parameters.function = &parameter_function_;
+
+  auto& signals = discovery_list_[1];
+  signals.nof_service = kGetNofSignals;
+  signals.config_service = kGetSignalConfig;
+  signals.list = &signal_list_;
+  signals.function = &signal_function_;
+}
+
 QueryParameters::~QueryParameters() { QueryParameters::Stop(); }
 
 bool QueryParameters::Start() {
@@ -32,36 +51,25 @@ bool QueryParameters::Start() {
                 << ", Port: " << Port();
     return false;
   }
-  // Block call until the connection is ready with initialization
-  const bool wait1 = Asap3Client::WaitOnIdle();
-  if (!wait1) {
+  if (!BlockingStart()) {
+    return true;  // Progress is reported through the OnParameters() function
+  }
+
+  // Block call until the connection is ready and all parameters are received.
+  // The next request is always queued before the current is done, so the
+  // client is idle first when the discovery is done.
+  const bool wait = Asap3Client::WaitOnIdle();
+  if (!wait) {
     LOG_ERROR() << "Failed to wait on ASAP 3 to initialize. Host: " << Host()
                 << ", Port: " << Port();
     return false;
   }
-  if (!HasService(kGetNofParameters.data()) ||
-      !HasService(kGetParameterConfig.data())) {
+  if (!HasService(kGetNofParameters) || !HasService(kGetParameterConfig)) {
     LOG_ERROR() << "The server doesnt support the required services. Host: "
                 << Host() << ", Port: " << Port();
     return false;
   }
-
-  ClearParameterList();
-  DataValueList nof_par_list = {
-      {"Service", Mc3DataType::MC3_STRING, std::string(kGetNofParameters)},
-      {"Input", Mc3DataType::MC3_STRING, std::string()},
-  };
-  SendTelegram(CommandCode::EXECUTE_SERVICE, nof_par_list);
-
-  // Block call until the request is ready
-  const bool wait2 = Asap3Client::WaitOnIdle();
-  if (!wait2) {
-    LOG_ERROR() << "Failed to wait on ASAP 3 service request. Host: " << Host()
-                << ", Port: " << Port();
-    return false;
-  }
-
-  return true;
+  return IsDiscovered();
 }
 
 bool QueryParameters::HandleTelegram(ITelegram& telegram) {
@@ -70,50 +78,290 @@ bool QueryParameters::HandleTelegram(ITelegram& telegram) {
   if (response == nullptr) {
     return false;
   }
+  const bool success = Asap3Client::HandleTelegram(telegram);
 
-  if (response->Status() != StatusCode::STATUS_OK &&
-      response->Status() != StatusCode::STATUS_SUCCESS) {
-    return Asap3Client::HandleTelegram(telegram);
+  switch (response->Cmd()) {
+    case CommandCode::QUERY_AVAILABLE_SERVICE:
+      StartDiscovery();
+      break;
+
+    case CommandCode::EXECUTE_SERVICE:
+      if (request != nullptr) {
+        SetExecuteService(request->GetData<std::string>(0), success,
+                          response->GetData<std::string>(0));
+      }
+      break;
+
+    default:
+      break;
   }
+  return success;
+}
 
-  if (response->Cmd() == CommandCode::EXECUTE_SERVICE && request != nullptr) {
-    SetExecuteService(request->GetData<std::string>(0),
-                      request->GetData<std::string>(1),
-                      response->GetData<std::string>(0));
+void QueryParameters::StartDiscovery() {
+  // Parameters and signals are fetched at the same time. Signals are
+  // optional, so a server without the signal services is not an error.
+  for (auto& discovery : discovery_list_) {
+    if (discovery.done) {
+      continue;
+    }
+    if (HasService(discovery.nof_service) &&
+        HasService(discovery.config_service)) {
+      const DataValueList nof_list = {
+          {"Service", Mc3DataType::MC3_STRING,
+           std::string(discovery.nof_service)},
+          {"Input", Mc3DataType::MC3_STRING, std::string()},
+      };
+      SendTelegram(CommandCode::EXECUTE_SERVICE, nof_list);
+    } else if (discovery.list == &signal_list_) {
+      discovery.done = true;
+    }
   }
-  return Asap3Client::HandleTelegram(telegram);
+  CheckDiscovered();
 }
 
 void QueryParameters::SetExecuteService(const std::string& service,
-                                        const std::string& input,
+                                        bool success,
                                         const std::string& output) {
-  if (IEquals(service, "Get Number of Parameters")) {
-    ClearParameterList();
-    const int parameters = std::stoi(output);
-    for (int parameter = 0; parameter < parameters; parameter += 50) {
-      const int min_index = parameter;
-      int max_index = parameter + 49;
-      if (max_index >= parameters) {
-        max_index = parameters - 1;
+  if (IEqualsName(service, kGetConfigFile)) {
+    OnFingerprint(success, output);
+    return;
+  }
+  for (auto& discovery : discovery_list_) {
+    if (IEqualsName(service, discovery.nof_service) && cached_metadata_) {
+      OnCountCheck(discovery, success, output);
+      break;
+    }
+    if (IEqualsName(service, discovery.nof_service)) {
+      OnNofItems(discovery, success, output);
+      break;
+    }
+    if (IEqualsName(service, discovery.config_service)) {
+      OnConfig(discovery, success, output);
+      break;
+    }
+  }
+}
+
+void QueryParameters::OnNofItems(Discovery& discovery, bool success,
+                                 const std::string& output) {
+  discovery.nof_items = 0;
+  discovery.next_index = 0;
+  discovery.nof_pending = 0;
+  if (success) {
+    try {
+      discovery.nof_items = std::stoul(output);
+    } catch (const std::exception& err) {
+      LOG_ERROR() << "Invalid number of items. Service: "
+                  << discovery.nof_service << ", Output: " << output;
+    }
+  }
+  {
+    std::scoped_lock lock(value_locker_);
+    discovery.list->clear();
+    discovery.list->reserve(discovery.nof_items);
+  }
+  // Keep a few requests in the queue, so the next request is sent as soon
+  // as the previous response is received.
+  const auto window = std::max(DiscoveryWindow(), size_t{1});
+  for (size_t request = 0; request < window; ++request) {
+    SendNextRequest(discovery);
+  }
+  if (discovery.nof_items == 0) {
+    discovery.done = true;
+    CheckDiscovered();
+    if (*discovery.function) {
+      (*discovery.function)({}, 0, 0);
+    }
+  }
+}
+
+void QueryParameters::OnConfig(Discovery& discovery, bool success,
+                               const std::string& output) {
+  // Parse and report each chunk directly. An invalid response is reported
+  // as an empty chunk, so the discovery still completes.
+  A3ParameterList chunk;
+  if (success) {
+    Asap3Helper::ParseCtParameterConfigString(output, chunk);
+  }
+  size_t nof_received = 0;
+  {
+    std::scoped_lock lock(value_locker_);
+    discovery.list->insert(discovery.list->end(), chunk.cbegin(),
+                           chunk.cend());
+    nof_received = discovery.list->size();
+  }
+  if (discovery.nof_pending > 0) {
+    --discovery.nof_pending;
+  }
+  SendNextRequest(discovery);
+  if (discovery.nof_pending == 0 &&
+      discovery.next_index >= discovery.nof_items) {
+    discovery.done = true;
+    CheckDiscovered();
+  }
+  if (*discovery.function) {
+    (*discovery.function)(chunk, nof_received, discovery.nof_items);
+  }
+}
+
+void QueryParameters::SendNextRequest(Discovery& discovery) {
+  if (discovery.next_index >= discovery.nof_items) {
+    return;
+  }
+  const auto chunk_size = std::max(DiscoveryChunkSize(), size_t{1});
+  const auto min_index = discovery.next_index;
+  const auto max_index =
+      std::min(min_index + chunk_size, discovery.nof_items) - 1;
+  discovery.next_index = max_index + 1;
+
+  std::string min_max_text = std::to_string(min_index);
+  min_max_text += ',';
+  min_max_text += std::to_string(max_index);
+  const DataValueList config_list = {
+      {"Service", Mc3DataType::MC3_STRING,
+       std::string(discovery.config_service)},
+      {"Input", Mc3DataType::MC3_STRING, min_max_text},
+  };
+  ++discovery.nof_pending;
+  SendTelegram(CommandCode::EXECUTE_SERVICE, config_list);
+}
+
+void QueryParameters::CheckDiscovered() {
+  const bool done = std::ranges::all_of(
+      discovery_list_, [](const auto& discovery) { return discovery.done; });
+  if (discovered_ || !done) {
+    return;
+  }
+  BuildCatalog();
+  discovered_ = true;
+  SaveMetadata();
+}
+
+void QueryParameters::OnFingerprint(bool success, const std::string& output) {
+  // The config file identifies the server configuration. It is only a file
+  // name, so the number of parameters and signals is also checked before
+  // the cache is used instead of the discovery.
+  has_fingerprint_ = success && !output.empty();
+  fingerprint_ = has_fingerprint_ ? MetadataCache::Fingerprint(output) : 0;
+
+  auto metadata = std::make_unique<ServerMetadata>();
+  if (has_fingerprint_ &&
+      MetadataCache::Load(MetadataCacheFile(), *metadata) &&
+      metadata->fingerprint == fingerprint_ &&
+      metadata->remote_version == RemoteVersion() &&
+      metadata->remote_name == RemoteName() &&
+      (metadata->has_signals || !DiscoverSignals())) {
+    cached_metadata_ = std::move(metadata);
+    counts_match_ = true;
+    nof_count_checks_ = 0;
+    for (const auto& discovery : discovery_list_) {
+      if (discovery.list == &signal_list_ && !DiscoverSignals()) {
+        continue;
       }
-      std::ostringstream min_max;
-      min_max << min_index << "," << max_index;
-      const auto min_max_text = min_max.str();
-      DataValueList get_par_list = {
+      const DataValueList nof_list = {
           {"Service", Mc3DataType::MC3_STRING,
-           std::string(kGetParameterConfig)},
-          {"Input", Mc3DataType::MC3_STRING, std::string("1,44")},
+           std::string(discovery.nof_service)},
+          {"Input", Mc3DataType::MC3_STRING, std::string()},
       };
-      SendTelegram(CommandCode::EXECUTE_SERVICE, get_par_list);
+      ++nof_count_checks_;
+      SendTelegram(CommandCode::EXECUTE_SERVICE, nof_list);
     }
-  } else if (IEquals(service, "Get Parameter Configuration")) {
-    Asap3Helper::ParseCtParameterConfigString(output, parameter_list_);
+    return;
+  }
+  SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, kEmptyList);
+}
+
+void QueryParameters::OnCountCheck(const Discovery& discovery, bool success,
+                                   const std::string& output) {
+  const auto expected = discovery.list == &signal_list_
+                            ? cached_metadata_->signal_list.size()
+                            : cached_metadata_->parameter_list.size();
+  size_t nof_items = 0;
+  try {
+    nof_items = success ? std::stoul(output) : 0;
+  } catch (const std::exception&) {
+    success = false;
+  }
+  if (!success || nof_items != expected) {
+    counts_match_ = false;
+  }
+  if (nof_count_checks_ > 0 && --nof_count_checks_ > 0) {
+    return;
+  }
+
+  auto metadata = std::move(cached_metadata_);
+  if (counts_match_) {
+    UseMetadata(*metadata);
+  } else {
+    SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, kEmptyList);
+  }
+}
+
+void QueryParameters::UseMetadata(ServerMetadata& metadata) {
+  SetServiceList(std::move(metadata.service_list));
+  size_t nof_parameters = 0;
+  size_t nof_signals = 0;
+  {
+    std::scoped_lock lock(value_locker_);
+    parameter_list_ = std::move(metadata.parameter_list);
+    signal_list_ = std::move(metadata.signal_list);
+    nof_parameters = parameter_list_.size();
+    nof_signals = signal_list_.size();
+  }
+  for (auto& discovery : discovery_list_) {
+    discovery.done = true;
+  }
+  BuildCatalog();
+  metadata_cached_ = true;
+  discovered_ = true;
+  if (parameter_function_) {
+    parameter_function_(ParameterList(), nof_parameters, nof_parameters);
+  }
+  if (signal_function_ && DiscoverSignals()) {
+    signal_function_(SignalList(), nof_signals, nof_signals);
+  }
+}
+
+void QueryParameters::SaveMetadata() {
+  if (MetadataCacheFile().empty() || !has_fingerprint_) {
+    return;
+  }
+  ServerMetadata metadata;
+  metadata.remote_name = RemoteName();
+  metadata.remote_version = RemoteVersion();
+  metadata.fingerprint = fingerprint_;
+  metadata.has_signals = DiscoverSignals();
+  {
+    std::scoped_lock lock(value_locker_);
+    metadata.service_list = service_list_;
+    metadata.parameter_list = parameter_list_;
+    metadata.signal_list = signal_list_;
+  }
+  if (!MetadataCache::Save(MetadataCacheFile(), metadata)) {
+    LOG_ERROR() << "Failed to save the metadata cache. File: "
+                << MetadataCacheFile();
   }
 }
 
 void QueryParameters::OnStartMessage() {
   Asap3Client::OnStartMessage();
-  SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, kEmptyList);
+  discovered_ = false;
+  metadata_cached_ = false;
+  has_fingerprint_ = false;
+  cached_metadata_.reset();
+  nof_count_checks_ = 0;
+  discovery_list_[0].done = false;
+  discovery_list_[1].done = !DiscoverSignals();
+  if (MetadataCacheFile().empty()) {
+    SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, kEmptyList);
+  } else {
+    const DataValueList config_file_list = {
+        {"Service", Mc3DataType::MC3_STRING, std::string(kGetConfigFile)},
+        {"Input", Mc3DataType::MC3_STRING, std::string()},
+    };
+    SendTelegram(CommandCode::EXECUTE_SERVICE, config_file_list);
+  }
 }
 
 }  // namespace asap3
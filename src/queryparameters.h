@@ -9,16 +9,18 @@
 #include <boost/asio.hpp>
 #include <condition_variable>
 #include <mutex>
+#include <string_view>
 #include <thread>
 #include <vector>
 
+#include "asap/metadatacache.h"
 #include "asap3client.h"
 
 namespace asap3 {
 
 class QueryParameters : public Asap3Client {
  public:
-  QueryParameters() = default;
+  QueryParameters();
   ~QueryParameters() override;
 
   bool Start() override;
@@ -28,8 +30,40 @@ class QueryParameters : public Asap3Client {
   bool HandleTelegram(ITelegram& telegram) override;
 
  private:
-  void SetExecuteService(const std::string& service, const std::string& input,
+  /// State of one ranged discovery, i.e. parameters or signals.
+  struct Discovery {
+    std::string_view nof_service;     ///< "Get Number of ..."
+    std::string_view config_service;  ///< "Get ... Configuration"
+    A3ParameterList* list = nullptr;
+    ParameterFunction* function = nullptr;
+    size_t nof_items = 0;    ///< Reported by the server
+    size_t next_index = 0;   ///< First index in the next request
+    size_t nof_pending = 0;  ///< Requests sent but not completed
+    bool done = true;
+  };
+  std::array<Discovery, 2> discovery_list_;
+
+  bool has_fingerprint_ = false;
+  uint64_t fingerprint_ = 0;  ///< Hash of the "Get Config File" output
+  /// Cache that matches the fingerprint. It is used if the live number of
+  /// parameters and signals also match.
+  std::unique_ptr<ServerMetadata> cached_metadata_;
+  size_t nof_count_checks_ = 0;  ///< Count requests not yet answered
+  bool counts_match_ = true;
+
+  void SetExecuteService(const std::string& service, bool success,
                          const std::string& output);
+  void StartDiscovery();
+  void OnNofItems(Discovery& discovery, bool success,
+                  const std::string& output);
+  void OnConfig(Discovery& discovery, bool success, const std::string& output);
+  void SendNextRequest(Discovery& discovery);
+  void CheckDiscovered();
+  void OnFingerprint(bool success, const std::string& output);
+  void OnCountCheck(const Discovery& discovery, bool success,
+                    const std::string& output);
+  void UseMetadata(ServerMetadata& metadata);
+  void SaveMetadata();
 };
 
 }  // namespace asap3
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/searchindex.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr char ToLower(char input) {
+  return input >= 'A' && input <= 'Z' ? static_cast<char>(input + ('a' - 'A'))
+                                      : input;
+}
+
+std::string Fold(std::string_view text) {
+  std::string temp(text);
+  std::ranges::transform(temp, temp.begin(), ToLower);
+  return temp;
+}
+
+constexpr uint32_t Trigram(std::string_view text, size_t pos) {
+  return (static_cast<uint32_t>(static_cast<uint8_t>(text[pos])) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(text[pos + 1])) << 8) |
+         static_cast<uint32_t>(static_cast<uint8_t>(text[pos + 2]));
+}
+
+bool IsWildcard(char input) { return input == '*' || input == '?'; }
+
+}  // namespace
+
+namespace asap3 {
+
+SearchIndex::SearchIndex(const std::vector<std::string_view>& name_list) {
+  offset_list_.reserve(name_list.size() + 1);
+  for (const auto name : name_list) {
+    offset_list_.push_back(static_cast<uint32_t>(arena_.size()));
+    for (const char input : name) {
+      arena_.push_back(ToLower(input));
+    }
+  }
+  offset_list_.push_back(static_cast<uint32_t>(arena_.size()));
+
+  sorted_list_.resize(name_list.size());
+  for (size_t index = 0; index < sorted_list_.size(); ++index) {
+    sorted_list_[index] = static_cast<uint32_t>(index);
+  }
+  std::ranges::sort(sorted_list_, [&](uint32_t index1, uint32_t index2) {
+    return Name(index1) < Name(index2);
+  });
+
+  for (size_t index = 0; index < name_list.size(); ++index) {
+    const auto name = Name(index);
+    for (size_t pos = 0; pos + 3 <= name.size(); ++pos) {
+      auto& list = trigram_map_[Trigram(name, pos)];
+      if (list.empty() || list.back() != index) {
+        list.push_back(static_cast<uint32_t>(index));
+      }
+    }
+  }
+}
+
+std::string_view SearchIndex::Name(size_t index) const {
+  const auto first = offset_list_[index];
+  return {arena_.data() + first, offset_list_[index + 1] - first};
+}
+
+std::pair<size_t, size_t> SearchIndex::PrefixRange(
+    std::string_view prefix) const {
+  const auto first = std::ranges::lower_bound(
+      sorted_list_, prefix, {}, [&](uint32_t index) { return Name(index); });
+  auto last = first;
+  while (last != sorted_list_.cend() && Name(*last).starts_with(prefix)) {
+    ++last;
+  }
+  return {static_cast<size_t>(first - sorted_list_.cbegin()),
+          static_cast<size_t>(last - sorted_list_.cbegin())};
+}
+
+const std::vector<uint32_t>* SearchIndex::Candidates(
+    std::string_view text) const {
+  // The shortest trigram list holds all names that may contain the text.
+  static const std::vector<uint32_t> kEmpty;
+  const std::vector<uint32_t>* shortest = nullptr;
+  for (size_t pos = 0; pos + 3 <= text.size(); ++pos) {
+    const auto itr = trigram_map_.find(Trigram(text, pos));
+    if (itr == trigram_map_.cend()) {
+      return &kEmpty;
+    }
+    if (shortest == nullptr || itr->second.size() < shortest->size()) {
+      shortest = &itr->second;
+    }
+  }
+  return shortest;
+}
+
+std::vector<size_t> SearchIndex::Prefix(std::string_view prefix,
+                                        size_t limit) const {
+  const auto folded = Fold(prefix);
+  const auto [first, last] = PrefixRange(folded);
+  std::vector<size_t> list;
+  list.reserve(last - first);
+  for (auto index = first; index < last; ++index) {
+    list.push_back(sorted_list_[index]);
+  }
+  std::ranges::sort(list);
+  if (list.size() > limit) {
+    list.resize(limit);
+  }
+  return list;
+}
+
+std::vector<size_t> SearchIndex::Substring(std::string_view text,
+                                           size_t limit) const {
+  const auto folded = Fold(text);
+  std::vector<size_t> list;
+  const auto* candidates = Candidates(folded);
+  if (candidates != nullptr) {
+    for (const auto index : *candidates) {
+      if (list.size() >= limit) {
+        break;
+      }
+      if (Name(index).find(folded) != std::string_view::npos) {
+        list.push_back(index);
+      }
+    }
+    return list;
+  }
+
+  // Short texts have no trigrams
+  for (size_t index = 0; index < Size() && list.size() < limit; ++index) {
+    if (Name(index).find(folded) != std::string_view::npos) {
+      list.push_back(index);
+    }
+  }
+  return list;
+}
+
+std::vector<size_t> SearchIndex::Glob(std::string_view pattern,
+                                      size_t limit) const {
+  const auto folded = Fold(pattern);
+  std::vector<size_t> list;
+
+  // Use the literal start of the pattern as a prefix
+  const auto literal_end =
+      std::ranges::find_if(folded, IsWildcard) - folded.cbegin();
+  if (literal_end > 0) {
+    const auto [first, last] = PrefixRange(
+        std::string_view(folded).substr(0, static_cast<size_t>(literal_end)));
+    for (auto index = first; index < last; ++index) {
+      if (GlobMatch(folded, Name(sorted_list_[index]))) {
+        list.push_back(sorted_list_[index]);
+      }
+    }
+    std::ranges::sort(list);
+    if (list.size() > limit) {
+      list.resize(limit);
+    }
+    return list;
+  }
+
+  // Else use the longest literal part for a trigram lookup
+  std::string_view longest;
+  for (size_t pos = 0; pos < folded.size();) {
+    const auto next = folded.find_first_of("*?", pos);
+    const auto end = next == std::string::npos ? folded.size() : next;
+    if (end - pos > longest.size()) {
+      longest = std::string_view(folded).substr(pos, end - pos);
+    }
+    pos = end + 1;
+  }
+  const auto* candidates = longest.size() >= 3 ? Candidates(longest) : nullptr;
+  if (candidates != nullptr) {
+    for (const auto index : *candidates) {
+      if (list.size() >= limit) {
+        break;
+      }
+      if (GlobMatch(folded, Name(index))) {
+        list.push_back(index);
+      }
+    }
+    return list;
+  }
+
+  for (size_t index = 0; index < Size() && list.size() < limit; ++index) {
+    if (GlobMatch(folded, Name(index))) {
+      list.push_back(index);
+    }
+  }
+  return list;
+}
+
+bool SearchIndex::GlobMatch(std::string_view pattern, std::string_view text) {
+  // Iterative match that backtracks to the last '*'
+  size_t pat = 0;
+  size_t pos = 0;
+  size_t star = std::string_view::npos;
+  size_t star_pos = 0;
+  while (pos < text.size()) {
+    if (pat < pattern.size() &&
+        (pattern[pat] == '?' ||
+         ToLower(pattern[pat]) == ToLower(text[pos]))) {
+      ++pat;
+      ++pos;
+    } else if (pat < pattern.size() && pattern[pat] == '*') {
+      star = pat++;
+      star_pos = pos;
+    } else if (star != std::string_view::npos) {
+      pat = star + 1;
+      pos = ++star_pos;
+    } else {
+      return false;
+    }
+  }
+  while (pat < pattern.size() && pattern[pat] == '*') {
+    ++pat;
+  }
+  return pat == pattern.size();
+}
+
+}  // namespace asap3
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sharedregion.h"
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+using namespace boost::interprocess;
+
+namespace asap3 {
+
+SharedRegion::SharedRegion() = default;
+
+SharedRegion::~SharedRegion() { Close(); }
+
+bool SharedRegion::Create(const std::string& name, size_t size) {
+  Close();
+  try {
+    shared_memory_object::remove(name.c_str());
+    shared_memory_object memory(create_only, name.c_str(), read_write);
+    memory.truncate(static_cast<offset_t>(size));
+    region_ = std::make_unique<mapped_region>(memory, read_write);
+    name_ = name;
+    owner_ = true;
+  } catch (const std::exception&) {
+    shared_memory_object::remove(name.c_str());
+    region_.reset();
+    return false;
+  }
+  return true;
+}
+
+bool SharedRegion::Open(const std::string& name, bool read_only) {
+  Close();
+  try {
+    const auto mode = read_only ? boost::interprocess::read_only
+                                : boost::interprocess::read_write;
+    shared_memory_object memory(open_only, name.c_str(), mode);
+    region_ = std::make_unique<mapped_region>(memory, mode);
+    name_ = name;
+    owner_ = false;
+  } catch (const std::exception&) {
+    region_.reset();
+    return false;
+  }
+  return true;
+}
+
+void SharedRegion::Close() {
+  region_.reset();
+  if (owner_ && !name_.empty()) {
+    shared_memory_object::remove(name_.c_str());
+  }
+  owner_ = false;
+  name_.clear();
+}
+
+uint8_t* SharedRegion::Data() const {
+  return region_ ? static_cast<uint8_t*>(region_->get_address()) : nullptr;
+}
+
+size_t SharedRegion::Size() const { return region_ ? region_->get_size() : 0; }
+
+}  // namespace asap3
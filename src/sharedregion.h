@@ -0,0 +1,47 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace boost::interprocess {
+class mapped_region;
+}
+
+namespace asap3 {
+
+/** \brief Named shared memory region.
+ *
+ * POSIX shared memory on Linux and the native equivalent on Windows. The
+ * region is removed when its creator closes it.
+ */
+class SharedRegion {
+ public:
+  SharedRegion();
+  ~SharedRegion();
+
+  SharedRegion(const SharedRegion&) = delete;
+  SharedRegion& operator=(const SharedRegion&) = delete;
+
+  /// Creates or replaces the region. The memory is zero-filled.
+  bool Create(const std::string& name, size_t size);
+  bool Open(const std::string& name, bool read_only = true);
+  void Close();
+
+  [[nodiscard]] bool IsOpen() const { return static_cast<bool>(region_); }
+  [[nodiscard]] const std::string& Name() const { return name_; }
+  [[nodiscard]] uint8_t* Data() const;
+  [[nodiscard]] size_t Size() const;
+
+ private:
+  std::string name_;
+  bool owner_ = false;
+  std::unique_ptr<boost::interprocess::mapped_region> region_;
+};
+
+}  // namespace asap3
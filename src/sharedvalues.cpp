@@ -0,0 +1,150 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/sharedvalues.h"
+
+#include <util/timestamp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <thread>
+
+#include "sharedregion.h"
+
+namespace {
+constexpr size_t kMaxReadAttempts = 10'000;
+
+asap3::SharedValueHeader* Header(const asap3::SharedRegion& region) {
+  return reinterpret_cast<asap3::SharedValueHeader*>(region.Data());
+}
+
+uint64_t* ValueData(const asap3::SharedRegion& region) {
+  return reinterpret_cast<uint64_t*>(region.Data() +
+                                     sizeof(asap3::SharedValueHeader));
+}
+
+}  // namespace
+
+namespace asap3 {
+
+SharedValueWriter::SharedValueWriter()
+    : region_(std::make_unique<SharedRegion>()) {}
+
+SharedValueWriter::~SharedValueWriter() = default;
+
+bool SharedValueWriter::Create(const std::string& name, size_t capacity) {
+  const size_t size = sizeof(SharedValueHeader) + capacity * sizeof(uint64_t);
+  if (!region_->Create(name, size)) {
+    return false;
+  }
+  auto* header = new (region_->Data()) SharedValueHeader();
+  header->capacity = static_cast<uint32_t>(capacity);
+  std::atomic_thread_fence(std::memory_order_release);
+  return true;
+}
+
+void SharedValueWriter::Close() { region_->Close(); }
+
+bool SharedValueWriter::IsOpen() const { return region_->IsOpen(); }
+
+const std::string& SharedValueWriter::Name() const { return region_->Name(); }
+
+size_t SharedValueWriter::Capacity() const {
+  return IsOpen() ? Header(*region_)->capacity : 0;
+}
+
+bool SharedValueWriter::Write(std::span<const double> value_list) {
+  if (!IsOpen() || value_list.size() > Capacity()) {
+    return false;
+  }
+  auto* header = Header(*region_);
+  auto* data = ValueData(*region_);
+  std::atomic_ref sequence(header->sequence);
+  const auto start = sequence.load(std::memory_order_relaxed);
+  sequence.store(start + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::atomic_ref(header->nof_values)
+      .store(static_cast<uint32_t>(value_list.size()),
+             std::memory_order_relaxed);
+  std::atomic_ref(header->time)
+      .store(util::time::TimeStampToNs(), std::memory_order_relaxed);
+  for (size_t index = 0; index < value_list.size(); ++index) {
+    std::atomic_ref(data[index])
+        .store(std::bit_cast<uint64_t>(value_list[index]),
+               std::memory_order_relaxed);
+  }
+  sequence.store(start + 2, std::memory_order_release);
+  return true;
+}
+
+SharedValueReader::SharedValueReader()
+    : region_(std::make_unique<SharedRegion>()) {}
+
+SharedValueReader::~SharedValueReader() = default;
+
+bool SharedValueReader::Open(const std::string& name) {
+  if (!region_->Open(name)) {
+    return false;
+  }
+  const auto* header = Header(*region_);
+  if (region_->Size() < sizeof(SharedValueHeader) ||
+      header->magic != SharedValueHeader::kMagic ||
+      header->version != SharedValueHeader::kVersion ||
+      region_->Size() < sizeof(SharedValueHeader) +
+                            header->capacity * sizeof(uint64_t)) {
+    region_->Close();
+    return false;
+  }
+  return true;
+}
+
+void SharedValueReader::Close() { region_->Close(); }
+
+bool SharedValueReader::IsOpen() const { return region_->IsOpen(); }
+
+const std::string& SharedValueReader::Name() const { return region_->Name(); }
+
+bool SharedValueReader::Read(std::vector<double>& value_list,
+                             uint64_t* sequence) const {
+  if (!IsOpen()) {
+    return false;
+  }
+  auto* header = Header(*region_);
+  auto* data = ValueData(*region_);
+  std::atomic_ref current(header->sequence);
+  for (size_t attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    const auto start = current.load(std::memory_order_acquire);
+    if ((start & 1) != 0) {
+      std::this_thread::yield();  // Write in progress
+      continue;
+    }
+    const auto nof_values = std::min(
+        std::atomic_ref(header->nof_values).load(std::memory_order_relaxed),
+        header->capacity);
+    value_list.resize(nof_values);
+    for (size_t index = 0; index < nof_values; ++index) {
+      value_list[index] = std::bit_cast<double>(
+          std::atomic_ref(data[index]).load(std::memory_order_relaxed));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (current.load(std::memory_order_relaxed) == start) {
+      if (sequence != nullptr) {
+        *sequence = start;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t SharedValueReader::Sequence() const {
+  return IsOpen() ? std::atomic_ref(Header(*region_)->sequence)
+                        .load(std::memory_order_acquire)
+                  : 0;
+}
+
+}  // namespace asap3
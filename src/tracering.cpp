@@ -0,0 +1,165 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "asap/tracering.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+// Each record starts with a header: time (8), frame size (4), direction (1)
+// and padding. Records are aligned to 8 bytes.
+constexpr size_t AlignedSize(size_t size) { return (size + 7) & ~size_t{7}; }
+
+}  // namespace
+
+namespace asap3 {
+
+TraceRing::TraceRing(size_t capacity) { Capacity(capacity); }
+
+void TraceRing::Capacity(size_t capacity) {
+  std::scoped_lock lock(locker_);
+  capacity_ = AlignedSize(std::max(capacity, kHeaderSize * 4));
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+  head_ = 0;
+  tail_ = 0;
+  read_ = 0;
+  dropped_ = 0;
+}
+
+size_t TraceRing::Capacity() const {
+  std::scoped_lock lock(locker_);
+  return capacity_;
+}
+
+void TraceRing::Write(TraceDirection direction, uint64_t time,
+                      const std::vector<uint8_t>& frame) {
+  static const std::vector<uint8_t> kEmpty;
+  Write(direction, time, frame, kEmpty);
+}
+
+void TraceRing::Write(TraceDirection direction, uint64_t time,
+                      const std::vector<uint8_t>& first,
+                      const std::vector<uint8_t>& second) {
+  const auto frame_size = first.size() + second.size();
+  const auto record_size = kHeaderSize + AlignedSize(frame_size);
+
+  std::scoped_lock lock(locker_);
+  if (record_size > capacity_) {
+    ++dropped_;
+    return;
+  }
+  if (buffer_.empty()) {
+    buffer_.resize(capacity_, 0);
+  }
+  // Make room by removing the oldest records
+  while (head_ + record_size - tail_ > buffer_.size()) {
+    const auto size = RecordSize(tail_);
+    if (read_ <= tail_) {
+      ++dropped_;
+      read_ = tail_ + size;
+    }
+    tail_ += size;
+  }
+
+  std::array<uint8_t, kHeaderSize> header = {};
+  const auto size32 = static_cast<uint32_t>(frame_size);
+  memcpy(header.data(), &time, sizeof(time));
+  memcpy(header.data() + 8, &size32, sizeof(size32));
+  header[12] = static_cast<uint8_t>(direction);
+
+  CopyIn(head_, header.data(), header.size());
+  CopyIn(head_ + kHeaderSize, first.data(), first.size());
+  CopyIn(head_ + kHeaderSize + first.size(), second.data(), second.size());
+  head_ += record_size;
+}
+
+bool TraceRing::Read(TraceRecord& record) {
+  std::scoped_lock lock(locker_);
+  if (read_ < tail_) {
+    read_ = tail_;
+  }
+  if (read_ >= head_) {
+    return false;
+  }
+  ReadRecord(read_, record);
+  read_ += RecordSize(read_);
+  return true;
+}
+
+std::vector<TraceRecord> TraceRing::Snapshot() const {
+  std::vector<TraceRecord> list;
+  std::scoped_lock lock(locker_);
+  for (auto position = tail_; position < head_;
+       position += RecordSize(position)) {
+    TraceRecord record;
+    ReadRecord(position, record);
+    list.push_back(std::move(record));
+  }
+  return list;
+}
+
+void TraceRing::Clear() {
+  std::scoped_lock lock(locker_);
+  head_ = 0;
+  tail_ = 0;
+  read_ = 0;
+}
+
+bool TraceRing::Empty() const {
+  std::scoped_lock lock(locker_);
+  return head_ == tail_;
+}
+
+uint64_t TraceRing::Dropped() const {
+  std::scoped_lock lock(locker_);
+  return dropped_;
+}
+
+void TraceRing::CopyIn(uint64_t position, const uint8_t* data, size_t size) {
+  if (size == 0) {
+    return;
+  }
+  const auto offset = static_cast<size_t>(position % buffer_.size());
+  const auto first = std::min(size, buffer_.size() - offset);
+  memcpy(buffer_.data() + offset, data, first);
+  if (first < size) {
+    memcpy(buffer_.data(), data + first, size - first);
+  }
+}
+
+void TraceRing::CopyOut(uint64_t position, uint8_t* data, size_t size) const {
+  if (size == 0) {
+    return;
+  }
+  const auto offset = static_cast<size_t>(position % buffer_.size());
+  const auto first = std::min(size, buffer_.size() - offset);
+  memcpy(data, buffer_.data() + offset, first);
+  if (first < size) {
+    memcpy(data + first, buffer_.data(), size - first);
+  }
+}
+
+size_t TraceRing::RecordSize(uint64_t position) const {
+  uint32_t size = 0;
+  CopyOut(position + 8, reinterpret_cast<uint8_t*>(&size), sizeof(size));
+  return kHeaderSize + AlignedSize(size);
+}
+
+void TraceRing::ReadRecord(uint64_t position, TraceRecord& record) const {
+  std::array<uint8_t, kHeaderSize> header = {};
+  CopyOut(position, header.data(), header.size());
+  uint32_t size = 0;
+  memcpy(&record.time, header.data(), sizeof(record.time));
+  memcpy(&size, header.data() + 8, sizeof(size));
+  record.direction = static_cast<TraceDirection>(header[12]);
+  record.frame.resize(size);
+  CopyOut(position + kHeaderSize, record.frame.data(), size);
+}
+
+}  // namespace asap3
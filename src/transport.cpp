@@ -0,0 +1,464 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "transport.h"
+
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace {
+
+template <typename Socket>
+class SocketTransport : public asap3::Transport {
+ public:
+  explicit SocketTransport(Socket socket) : socket_(std::move(socket)) {}
+
+  void AsyncRead(mutable_buffer buffer, IoHandler handler) override {
+    async_read(socket_, buffer, std::move(handler));
+  }
+
+  void AsyncWrite(const_buffer buffer, IoHandler handler) override {
+    async_write(socket_, buffer, std::move(handler));
+  }
+
+  void Close() override {
+    error_code dummy;
+    socket_.shutdown(Socket::shutdown_both, dummy);
+    socket_.close(dummy);
+  }
+
+  [[nodiscard]] bool IsOpen() const override { return socket_.is_open(); }
+
+  bool ApplyOptions(const asap3::SocketOptions& options) override {
+    error_code error;
+    bool ok = true;
+    if (options.receive_buffer > 0) {
+      socket_.set_option(
+          socket_base::receive_buffer_size(options.receive_buffer), error);
+      ok = ok && !error;
+    }
+    if (options.send_buffer > 0) {
+      socket_.set_option(socket_base::send_buffer_size(options.send_buffer),
+                         error);
+      ok = ok && !error;
+    }
+    return ok;
+  }
+
+ protected:
+  Socket socket_;
+};
+
+#if defined(__linux__)
+bool SetNativeOption(int handle, int level, int name, int value) {
+  return ::setsockopt(handle, level, name, &value, sizeof(value)) == 0;
+}
+#endif
+
+class TcpTransport : public SocketTransport<ip::tcp::socket> {
+ public:
+  TcpTransport(io_context& context, std::string host, uint16_t port)
+      : SocketTransport(ip::tcp::socket(context)),
+        resolver_(context),
+        host_(std::move(host)),
+        port_(port) {}
+
+  explicit TcpTransport(ip::tcp::socket socket)
+      : SocketTransport(std::move(socket)), resolver_(socket_.get_executor()) {}
+
+  [[nodiscard]] asap3::TransportType Type() const override {
+    return asap3::TransportType::Tcp;
+  }
+
+  void AsyncRead(mutable_buffer buffer, IoHandler handler) override {
+#if defined(__linux__)
+    if (quick_ack_) {
+      SetNativeOption(socket_.native_handle(), IPPROTO_TCP, TCP_QUICKACK, 1);
+    }
+#endif
+    SocketTransport::AsyncRead(buffer, std::move(handler));
+  }
+
+  bool ApplyOptions(const asap3::SocketOptions& options) override {
+    bool ok = SocketTransport::ApplyOptions(options);
+    error_code error;
+    socket_.set_option(ip::tcp::no_delay(options.no_delay), error);
+    ok = ok && !error;
+    if (options.keep_alive) {
+      socket_.set_option(socket_base::keep_alive(true), error);
+      ok = ok && !error;
+    }
+#if defined(__linux__)
+    const auto handle = socket_.native_handle();
+    if (options.keep_alive && options.keep_alive_idle.count() > 0) {
+      ok = SetNativeOption(handle, IPPROTO_TCP, TCP_KEEPIDLE,
+                           static_cast<int>(options.keep_alive_idle.count())) &&
+           ok;
+    }
+    if (options.keep_alive && options.keep_alive_interval.count() > 0) {
+      ok = SetNativeOption(
+               handle, IPPROTO_TCP, TCP_KEEPINTVL,
+               static_cast<int>(options.keep_alive_interval.count())) &&
+           ok;
+    }
+    if (options.keep_alive && options.keep_alive_count > 0) {
+      ok = SetNativeOption(handle, IPPROTO_TCP, TCP_KEEPCNT,
+                           options.keep_alive_count) &&
+           ok;
+    }
+    if (options.user_timeout.count() > 0) {
+      ok = SetNativeOption(handle, IPPROTO_TCP, TCP_USER_TIMEOUT,
+                           static_cast<int>(options.user_timeout.count())) &&
+           ok;
+    }
+    if (options.busy_poll.count() > 0) {
+      ok = SetNativeOption(handle, SOL_SOCKET, SO_BUSY_POLL,
+                           static_cast<int>(options.busy_poll.count())) &&
+           ok;
+    }
+    quick_ack_ = options.quick_ack;
+#endif
+    return ok;
+  }
+
+  void AsyncConnect(ConnectHandler handler) override {
+    resolver_.async_resolve(
+        host_, std::to_string(port_),
+        [this, handler](const error_code& error,
+                        const ip::tcp::resolver::results_type& result) {
+          // The resolver is cancelled if the transport is deleted
+          if (error) {
+            handler(error);
+            return;
+          }
+          async_connect(socket_, result,
+                        [handler](const error_code& connect_error,
+                                  const ip::tcp::endpoint&) {
+                          handler(connect_error);
+                        });
+        });
+  }
+
+ private:
+  ip::tcp::resolver resolver_;
+  std::string host_;
+  uint16_t port_ = 0;
+  bool quick_ack_ = false;
+};
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+class UnixTransport : public SocketTransport<local::stream_protocol::socket> {
+ public:
+  UnixTransport(io_context& context, std::string path)
+      : SocketTransport(local::stream_protocol::socket(context)),
+        path_(std::move(path)) {}
+
+  explicit UnixTransport(local::stream_protocol::socket socket)
+      : SocketTransport(std::move(socket)) {}
+
+  [[nodiscard]] asap3::TransportType Type() const override {
+    return asap3::TransportType::UnixSocket;
+  }
+
+  void AsyncConnect(ConnectHandler handler) override {
+    socket_.async_connect(local::stream_protocol::endpoint(path_),
+                          std::move(handler));
+  }
+
+ private:
+  std::string path_;
+};
+#endif
+
+/// Bytes that a pipe buffers before a write waits for the reader.
+constexpr size_t kPipeCapacity = 64 * 1024;
+
+/// One direction of a memory pipe. Only one read and one write may be
+/// pending. The pending operations keep their executor busy, in the same way
+/// as socket operations do.
+struct PipeBuffer {
+  std::mutex locker;
+  std::vector<uint8_t> data;
+  size_t read_offset = 0;
+  bool closed = false;
+  mutable_buffer read_buffer;
+  asap3::Transport::IoHandler read_handler;
+  any_io_executor read_executor;
+  const_buffer write_buffer;
+  asap3::Transport::IoHandler write_handler;
+  any_io_executor write_executor;
+};
+
+void CompleteWrite(PipeBuffer& pipe);
+
+// Completes the pending read if there is enough data. Called with the lock
+// held. The handler is posted, so it never runs inside the lock.
+void CompleteRead(PipeBuffer& pipe) {
+  if (!pipe.read_handler) {
+    return;
+  }
+  const auto size = pipe.read_buffer.size();
+  if (pipe.data.size() - pipe.read_offset >= size) {
+    std::memcpy(pipe.read_buffer.data(), pipe.data.data() + pipe.read_offset,
+                size);
+    pipe.read_offset += size;
+    if (pipe.read_offset == pipe.data.size()) {
+      pipe.data.clear();
+      pipe.read_offset = 0;
+    }
+    post(pipe.read_executor,
+         [handler = std::move(pipe.read_handler), size] {
+           handler({}, size);
+         });
+  } else if (pipe.closed) {
+    post(pipe.read_executor, [handler = std::move(pipe.read_handler)] {
+      handler(error::eof, 0);
+    });
+  } else {
+    return;
+  }
+  pipe.read_handler = nullptr;
+  pipe.read_executor = {};
+  // The read may have made room for a waiting write
+  CompleteWrite(pipe);
+}
+
+// Completes the pending write if the data fits in the pipe. A write larger
+// than the capacity is accepted when the pipe is empty. Called with the lock
+// held.
+void CompleteWrite(PipeBuffer& pipe) {
+  if (!pipe.write_handler) {
+    return;
+  }
+  const auto size = pipe.write_buffer.size();
+  const auto queued = pipe.data.size() - pipe.read_offset;
+  if (pipe.closed) {
+    post(pipe.write_executor, [handler = std::move(pipe.write_handler)] {
+      handler(error::broken_pipe, 0);
+    });
+  } else if (queued == 0 || queued + size <= kPipeCapacity) {
+    // Drop the bytes that have been read, so the buffer stays bounded
+    const auto read_end =
+        pipe.data.begin() + static_cast<ptrdiff_t>(pipe.read_offset);
+    pipe.data.erase(pipe.data.begin(), read_end);
+    pipe.read_offset = 0;
+    const auto* data = static_cast<const uint8_t*>(pipe.write_buffer.data());
+    pipe.data.insert(pipe.data.end(), data, data + size);
+    post(pipe.write_executor,
+         [handler = std::move(pipe.write_handler), size] {
+           handler({}, size);
+         });
+  } else {
+    return;
+  }
+  pipe.write_handler = nullptr;
+  pipe.write_executor = {};
+  CompleteRead(pipe);
+}
+
+struct PipeListener {
+  any_io_executor executor;
+  asap3::MemoryPipe::AcceptHandler handler;
+};
+
+std::mutex& ListenLocker() {
+  static std::mutex locker;
+  return locker;
+}
+
+std::map<std::string, PipeListener>& ListenList() {
+  static std::map<std::string, PipeListener> listen_list;
+  return listen_list;
+}
+
+class MemoryTransport : public asap3::Transport {
+ public:
+  MemoryTransport(any_io_executor executor, std::string name)
+      : executor_(std::move(executor)), name_(std::move(name)) {}
+
+  MemoryTransport(any_io_executor executor, std::shared_ptr<PipeBuffer> input,
+                  std::shared_ptr<PipeBuffer> output)
+      : executor_(std::move(executor)),
+        input_(std::move(input)),
+        output_(std::move(output)) {}
+
+  ~MemoryTransport() override { MemoryTransport::Close(); }
+
+  [[nodiscard]] asap3::TransportType Type() const override {
+    return asap3::TransportType::MemoryPipe;
+  }
+
+  void AsyncConnect(ConnectHandler handler) override {
+    PipeListener listener;
+    {
+      std::scoped_lock lock(ListenLocker());
+      const auto itr = ListenList().find(name_);
+      if (itr == ListenList().cend()) {
+        post(executor_, [handler = std::move(handler)] {
+          handler(error::connection_refused);
+        });
+        return;
+      }
+      listener = itr->second;
+    }
+    auto input = std::make_shared<PipeBuffer>();
+    auto output = std::make_shared<PipeBuffer>();
+    {
+      std::scoped_lock lock(locker_);
+      input_ = input;
+      output_ = output;
+    }
+    // The server end reads what the client writes and vice versa
+    post(listener.executor, [listener, input = output, output = input] {
+      listener.handler(std::make_unique<MemoryTransport>(listener.executor,
+                                                         input, output));
+    });
+    post(executor_, [handler = std::move(handler)] { handler({}); });
+  }
+
+  void AsyncRead(mutable_buffer buffer, IoHandler handler) override {
+    const auto input = Pipe(input_);
+    if (!input) {
+      post(executor_, [handler = std::move(handler)] {
+        handler(error::not_connected, 0);
+      });
+      return;
+    }
+    std::scoped_lock lock(input->locker);
+    input->read_buffer = buffer;
+    input->read_handler = std::move(handler);
+    input->read_executor =
+        prefer(executor_, execution::outstanding_work.tracked);
+    CompleteRead(*input);
+  }
+
+  // Called by the message thread while the I/O thread may close the pipe
+  void AsyncWrite(const_buffer buffer, IoHandler handler) override {
+    const auto output = Pipe(output_);
+    if (!output) {
+      post(executor_, [handler = std::move(handler)] {
+        handler(error::not_connected, 0);
+      });
+      return;
+    }
+    std::scoped_lock lock(output->locker);
+    if (output->closed || output->write_handler) {
+      const error_code error = output->closed ? error::broken_pipe
+                                              : error::in_progress;
+      post(executor_, [handler = std::move(handler), error] {
+        handler(error, 0);
+      });
+      return;
+    }
+    output->write_buffer = buffer;
+    output->write_handler = std::move(handler);
+    output->write_executor =
+        prefer(executor_, execution::outstanding_work.tracked);
+    CompleteWrite(*output);
+  }
+
+  void Close() override {
+    std::shared_ptr<PipeBuffer> input;
+    std::shared_ptr<PipeBuffer> output;
+    {
+      std::scoped_lock lock(locker_);
+      input = std::move(input_);
+      output = std::move(output_);
+    }
+    // Both ends see end of file
+    for (auto& pipe : {input, output}) {
+      if (pipe) {
+        std::scoped_lock lock(pipe->locker);
+        pipe->closed = true;
+        CompleteRead(*pipe);
+        CompleteWrite(*pipe);
+      }
+    }
+  }
+
+  [[nodiscard]] bool IsOpen() const override {
+    return static_cast<bool>(Pipe(input_));
+  }
+
+ private:
+  any_io_executor executor_;
+  std::string name_;
+  mutable std::mutex locker_;  ///< Protects the pipe pointers
+  std::shared_ptr<PipeBuffer> input_;
+  std::shared_ptr<PipeBuffer> output_;
+
+  [[nodiscard]] std::shared_ptr<PipeBuffer> Pipe(
+      const std::shared_ptr<PipeBuffer>& pipe) const {
+    std::scoped_lock lock(locker_);
+    return pipe;
+  }
+};
+
+}  // namespace
+
+namespace asap3 {
+
+std::unique_ptr<Transport> Transport::Create(TransportType type,
+                                             io_context& context,
+                                             const std::string& host,
+                                             uint16_t port,
+                                             const std::string& address) {
+  switch (type) {
+    case TransportType::UnixSocket:
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+      return std::make_unique<UnixTransport>(context, address);
+#else
+      return {};
+#endif
+
+    case TransportType::MemoryPipe:
+      return std::make_unique<MemoryTransport>(context.get_executor(),
+                                               address);
+
+    case TransportType::Tcp:
+    default:
+      break;
+  }
+  return std::make_unique<TcpTransport>(context, host, port);
+}
+
+bool MemoryPipe::Listen(const std::string& name, any_io_executor executor,
+                        AcceptHandler handler) {
+  // The listener keeps the executor busy until it is removed
+  auto tracked = prefer(std::move(executor), execution::outstanding_work.tracked);
+  std::scoped_lock lock(ListenLocker());
+  return ListenList()
+      .emplace(name, PipeListener{std::move(tracked), std::move(handler)})
+      .second;
+}
+
+void MemoryPipe::Unlisten(const std::string& name) {
+  std::scoped_lock lock(ListenLocker());
+  ListenList().erase(name);
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+std::unique_ptr<Transport> CreateTransport(
+    local::stream_protocol::socket socket) {
+  return std::make_unique<UnixTransport>(std::move(socket));
+}
+#endif
+
+std::unique_ptr<Transport> CreateTransport(ip::tcp::socket socket) {
+  return std::make_unique<TcpTransport>(std::move(socket));
+}
+
+}  // namespace asap3
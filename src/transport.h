@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <boost/asio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "asap/iclient.h"
+#include "asap/socketoptions.h"
+
+namespace asap3 {
+
+/** \brief Byte stream between a client and a server.
+ *
+ * The client and the mock server only use exact reads and writes, so any
+ * stream that can deliver whole buffers can be used. TCP, Unix domain
+ * sockets and in-process memory pipes are supported. All handlers are
+ * called on the executor that the transport was created with.
+ */
+class Transport {
+ public:
+  using ConnectHandler = std::function<void(const boost::system::error_code&)>;
+  using IoHandler =
+      std::function<void(const boost::system::error_code&, size_t)>;
+
+  virtual ~Transport() = default;
+
+  /// Creates an unconnected client transport. The host and port are only
+  /// used by TCP, the address by Unix sockets (path) and memory pipes (name).
+  static std::unique_ptr<Transport> Create(TransportType type,
+                                           boost::asio::io_context& context,
+                                           const std::string& host,
+                                           uint16_t port,
+                                           const std::string& address);
+
+  [[nodiscard]] virtual TransportType Type() const = 0;
+  /// Resolves the endpoint and connects.
+  virtual void AsyncConnect(ConnectHandler handler) = 0;
+  /// Completes when the whole buffer has been read.
+  virtual void AsyncRead(boost::asio::mutable_buffer buffer,
+                         IoHandler handler) = 0;
+  /// Completes when the whole buffer has been written.
+  virtual void AsyncWrite(boost::asio::const_buffer buffer,
+                          IoHandler handler) = 0;
+  virtual void Close() = 0;
+  [[nodiscard]] virtual bool IsOpen() const = 0;
+  /// Sets the socket options on a connected transport. Options that the
+  /// transport doesn't have are ignored. Returns false if any option failed.
+  virtual bool ApplyOptions(const SocketOptions& /* options */) {
+    return true;
+  }
+};
+
+/** \brief Server side of the in-process memory pipes.
+ *
+ * A server listens on a name and gets one transport per connecting client.
+ * The names are global within the process. Each direction buffers 64 KiB.
+ * A write that doesn't fit waits until the reader has made room.
+ */
+class MemoryPipe {
+ public:
+  using AcceptHandler = std::function<void(std::unique_ptr<Transport>)>;
+
+  /// Returns false if the name is in use.
+  static bool Listen(const std::string& name,
+                     boost::asio::any_io_executor executor,
+                     AcceptHandler handler);
+  static void Unlisten(const std::string& name);
+};
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+/// Server side transport for an accepted Unix domain socket.
+std::unique_ptr<Transport> CreateTransport(
+    boost::asio::local::stream_protocol::socket socket);
+#endif
+/// Server side transport for an accepted TCP socket.
+std::unique_ptr<Transport> CreateTransport(boost::asio::ip::tcp::socket socket);
+
+}  // namespace asap3
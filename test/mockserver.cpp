@@ -0,0 +1,992 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "mockserver.h"
+
+#include <util/stringutil.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <future>
+#include <sstream>
+
+#include "asap/iresponse.h"
+#include "asap/sharedvalues.h"
+#include "asap3helper.h"
+#include "transport.h"
+
+using namespace boost::asio;
+using namespace boost::system;
+using namespace util::string;
+
+namespace {
+constexpr std::string_view kGetNofParameters = "Get Number of Parameters";
+constexpr std::string_view kGetParameterConfig = "Get Parameter Configuration";
+constexpr std::string_view kGetNofSignals = "Get Number of Signals";
+constexpr std::string_view kGetSignalConfig = "Get Signal Configuration";
+constexpr std::string_view kUseExtendedPoll = "Use Extended Poll";
+constexpr std::string_view kDisableSetValueAck = "Disable SetValue Ack";
+constexpr std::string_view kSupportInvalidOutput = "Support Invalid Output";
+constexpr std::string_view kGetConfigFile = "Get Config File";
+constexpr std::string_view kGetShareName = "Get Share Memory Name";
+constexpr size_t kSharedCapacity = 4096;
+
+std::any ToAnyValue(asap3::Mc3DataType type, double value) {
+  switch (type) {
+    case asap3::Mc3DataType::A_FLOAT64:
+      return value;
+    case asap3::Mc3DataType::MC3_STRING:
+      return std::to_string(value);
+    case asap3::Mc3DataType::A_INT16:
+      return static_cast<int16_t>(value);
+    case asap3::Mc3DataType::A_UINT16:
+      return static_cast<uint16_t>(value);
+    case asap3::Mc3DataType::A_INT32:
+      return static_cast<int32_t>(value);
+    case asap3::Mc3DataType::A_UINT32:
+      return static_cast<uint32_t>(value);
+    case asap3::Mc3DataType::A_INT64:
+      return static_cast<int64_t>(value);
+    case asap3::Mc3DataType::A_UINT64:
+      return static_cast<uint64_t>(value);
+    case asap3::Mc3DataType::A_FLOAT32:
+    default:
+      break;
+  }
+  return static_cast<float>(value);
+}
+
+void SetError(asap3::IResponse& response, asap3::DataValueList& data_list,
+              const std::string& text) {
+  response.Status(asap3::StatusCode::STATUS_ERROR);
+  data_list.clear();
+  data_list.push_back({"Error Code", asap3::Mc3DataType::A_UINT16,
+                       static_cast<uint16_t>(1)});
+  data_list.push_back({"Error Text", asap3::Mc3DataType::MC3_STRING, text});
+}
+
+// View of a block of cells. Returns an empty view if the block is invalid.
+asap3::TensorView<float> CellView(asap3::Characteristic& characteristic,
+                                  const std::vector<uint16_t>& start_list,
+                                  const std::vector<uint16_t>& count_list) {
+  const auto dimensions = characteristic.NofDimensions();
+  if (start_list.size() != dimensions || count_list.size() != dimensions) {
+    return {};
+  }
+  auto view = characteristic.Tensor();
+  for (size_t dim = 0; dim < dimensions; ++dim) {
+    if (count_list[dim] == 0 ||
+        start_list[dim] + count_list[dim] > characteristic.Dimension(dim)) {
+      return {};
+    }
+    view = view.Range(dim, start_list[dim], count_list[dim]);
+  }
+  return view;
+}
+
+constexpr uint32_t kLookupBaseAddress = 0x10000;
+constexpr uint32_t kLookupAddressStep = 0x1000;
+
+}  // namespace
+
+namespace asap3::test {
+
+class MockSession : public std::enable_shared_from_this<MockSession> {
+ public:
+  MockSession(MockServer& server, std::unique_ptr<Transport> transport)
+      : server_(server),
+        transport_(std::move(transport)),
+        delay_timer_(server.context_) {
+    short_data_.resize(2, 0);
+  }
+
+  void Start() { DoReadLength(); }
+
+  void Close() {
+    shared_values_.reset();
+    delay_timer_.cancel();
+    transport_->Close();
+  }
+
+  std::vector<size_t> subscription_list_;  ///< Index into parameter list
+  uint64_t poll_count_ = 0;
+  bool setvalue_ack_disabled_ = false;
+  std::unique_ptr<SharedValueWriter> shared_values_;
+
+ private:
+  MockServer& server_;
+  std::unique_ptr<Transport> transport_;
+  steady_timer delay_timer_;
+  std::vector<uint8_t> short_data_;
+  std::vector<uint8_t> body_data_;
+  std::vector<uint8_t> transmit_data_;
+
+  void DoReadLength() {
+    auto self = shared_from_this();
+    transport_->AsyncRead(buffer(short_data_), [self](const error_code& error,
+                                                       size_t bytes) {
+      if (error || bytes != self->short_data_.size()) {
+        self->Close();
+        return;
+      }
+      uint16_t length = 0;
+      Asap3Helper::ToMc3Value(self->short_data_, 0, length);
+      if (length < 6) {
+        self->Close();
+        return;
+      }
+      self->body_data_.clear();
+      self->body_data_.resize(length - 2, 0);
+      self->DoReadBody();
+    });
+  }
+
+  void DoReadBody() {
+    auto self = shared_from_this();
+    transport_->AsyncRead(buffer(body_data_), [self](const error_code& error,
+                                                      size_t bytes) {
+      if (error || bytes != self->body_data_.size()) {
+        self->Close();
+        return;
+      }
+      self->transmit_data_.clear();
+      self->server_.HandleRequest(*self, self->body_data_,
+                                  self->transmit_data_);
+      if (self->transmit_data_.empty()) {
+        self->DoReadLength();  // No response
+      } else {
+        self->DoDelay();
+      }
+    });
+  }
+
+  void DoDelay() {
+    const auto delay = server_.NextDelay();
+    if (delay.count() <= 0) {
+      DoWrite();
+      return;
+    }
+    auto self = shared_from_this();
+    delay_timer_.expires_after(delay);
+    delay_timer_.async_wait([self](const error_code& error) {
+      if (error) {
+        self->Close();
+      } else {
+        self->DoWrite();
+      }
+    });
+  }
+
+  void DoWrite() {
+    auto self = shared_from_this();
+    transport_->AsyncWrite(buffer(transmit_data_),
+                           [self](const error_code& error, size_t) {
+                             if (error) {
+                               self->Close();
+                             } else {
+                               self->DoReadLength();
+                             }
+                           });
+  }
+};
+
+MockServer::MockServer() {
+  AddService(std::string(kGetNofParameters), [this](const std::string&) {
+    return std::to_string(NofParameters());
+  });
+  AddService(std::string(kGetParameterConfig), [this](const std::string& in) {
+    std::scoped_lock lock(locker_);
+    return ConfigText(parameter_list_, in);
+  });
+  AddService(std::string(kGetNofSignals), [this](const std::string&) {
+    return std::to_string(NofSignals());
+  });
+  AddService(std::string(kGetSignalConfig), [this](const std::string& in) {
+    std::scoped_lock lock(locker_);
+    return ConfigText(signal_list_, in);
+  });
+  AddService(std::string(kUseExtendedPoll),
+             [](const std::string&) { return std::string("1"); });
+  AddService(std::string(kDisableSetValueAck),
+             [](const std::string&) { return std::string("1"); });
+  AddService(std::string(kSupportInvalidOutput),
+             [](const std::string&) { return std::string("1"); });
+  // The name is created per session by HandleRequest()
+  AddService(std::string(kGetShareName),
+             [](const std::string&) { return std::string(); });
+  // Like a real server, the file name stays the same when the parameters
+  // change.
+  AddService(std::string(kGetConfigFile),
+             [this](const std::string&) { return Name() + ".cfg"; });
+}
+
+MockServer::~MockServer() { MockServer::Stop(); }
+
+void MockServer::AddParameter(const A3Parameter& parameter) {
+  std::scoped_lock lock(locker_);
+  parameter_list_.push_back(parameter);
+}
+
+void MockServer::CreateParameters(size_t nof_parameters) {
+  std::scoped_lock lock(locker_);
+  for (size_t index = 0; index < nof_parameters; ++index) {
+    std::ostringstream name;
+    name << "Par" << parameter_list_.size() + 1;
+    A3Parameter parameter;
+    parameter.Name(name.str());
+    parameter.DisplayName(name.str());
+    parameter.Unit("rpm");
+    parameter.Description("Mock parameter");
+    parameter.Device("Mock");
+    parameter.Signal(name.str());
+    parameter.Identity(std::to_string(parameter_list_.size()));
+    parameter.Min(0);
+    parameter.Max(10'000);
+    parameter.CycleTime(10);
+    parameter_list_.push_back(parameter);
+  }
+}
+
+size_t MockServer::NofParameters() const {
+  std::scoped_lock lock(locker_);
+  return parameter_list_.size();
+}
+
+void MockServer::CreateSignals(size_t nof_signals) {
+  std::scoped_lock lock(locker_);
+  for (size_t index = 0; index < nof_signals; ++index) {
+    const auto name = "Sig" + std::to_string(signal_list_.size() + 1);
+    A3Parameter signal;
+    signal.Name(name);
+    signal.DisplayName(name);
+    signal.Unit("V");
+    signal.Description("Mock signal");
+    signal.Device("Mock");
+    signal.Signal(name);
+    signal.Identity(std::to_string(signal_list_.size()));
+    signal.Min(-10);
+    signal.Max(10);
+    signal_list_.push_back(signal);
+  }
+}
+
+size_t MockServer::NofSignals() const {
+  std::scoped_lock lock(locker_);
+  return signal_list_.size();
+}
+
+void MockServer::AddService(const std::string& service,
+                            ServiceFunction function) {
+  std::scoped_lock lock(locker_);
+  service_list_[service] = std::move(function);
+}
+
+void MockServer::AddCharacteristic(const Characteristic& characteristic,
+                                   float min, float max) {
+  std::scoped_lock lock(locker_);
+  if (!characteristic_list_.contains(characteristic.Name())) {
+    lookup_address_list_.push_back(characteristic.Name());
+  }
+  characteristic_list_[characteristic.Name()] = {characteristic, min, max};
+}
+
+Characteristic MockServer::GetCharacteristic(const std::string& name) const {
+  std::scoped_lock lock(locker_);
+  const auto itr = characteristic_list_.find(name);
+  return itr != characteristic_list_.cend() ? itr->second.characteristic
+                                            : Characteristic();
+}
+
+float MockServer::SetPointValue(const std::string& name) const {
+  std::scoped_lock lock(locker_);
+  const auto itr = setpoint_list_.find(name);
+  return itr != setpoint_list_.cend() ? itr->second
+                                      : Asap3Helper::InvalidFloat();
+}
+
+ServiceList MockServer::AvailableServices() const {
+  std::scoped_lock lock(locker_);
+  ServiceList list;
+  for (const auto& [name, function] : service_list_) {
+    list.push_back({name, std::string()});
+  }
+  return list;
+}
+
+bool MockServer::Start() {
+  if (started_) {
+    return true;
+  }
+  try {
+    context_.restart();
+    switch (transport_type_) {
+      case TransportType::UnixSocket:
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        std::remove(address_.c_str());  // Remove any stale socket file
+        local_acceptor_ = std::make_unique<local::stream_protocol::acceptor>(
+            context_, local::stream_protocol::endpoint(address_));
+        DoAcceptLocal();
+        break;
+#else
+        return false;
+#endif
+
+      case TransportType::MemoryPipe:
+        pipe_listening_ = MemoryPipe::Listen(
+            address_, context_.get_executor(),
+            [&](std::unique_ptr<asap3::Transport> transport) {
+              AddSession(std::move(transport));
+            });
+        if (!pipe_listening_) {
+          return false;
+        }
+        break;
+
+      case TransportType::Tcp:
+      default:
+        acceptor_ = std::make_unique<ip::tcp::acceptor>(
+            context_, ip::tcp::endpoint(ip::address_v4::loopback(), port_));
+        port_ = acceptor_->local_endpoint().port();
+        DoAccept();
+        break;
+    }
+  } catch (const std::exception&) {
+    acceptor_.reset();
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    local_acceptor_.reset();
+#endif
+    return false;
+  }
+  started_ = true;
+  worker_thread_ = std::thread(&MockServer::WorkerThread, this);
+  return true;
+}
+
+void MockServer::Stop() {
+  if (!started_) {
+    return;
+  }
+  // Close the acceptor and all sessions inside the worker thread. The
+  // context then runs out of work and the worker thread ends by itself.
+  post(context_, [&] {
+    error_code dummy;
+    if (acceptor_) {
+      acceptor_->close(dummy);
+    }
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (local_acceptor_) {
+      local_acceptor_->close(dummy);
+    }
+#endif
+    if (pipe_listening_) {
+      MemoryPipe::Unlisten(address_);
+      pipe_listening_ = false;
+    }
+    for (auto& weak : session_list_) {
+      if (auto session = weak.lock(); session) {
+        session->Close();
+      }
+    }
+    session_list_.clear();
+  });
+  if (worker_thread_.joinable()) {
+    worker_thread_.join();
+  }
+  acceptor_.reset();
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  if (local_acceptor_) {
+    local_acceptor_.reset();
+    std::remove(address_.c_str());
+  }
+#endif
+  started_ = false;
+}
+
+void MockServer::WorkerThread() {
+  try {
+    context_.run();
+  } catch (const std::exception&) {
+  }
+}
+
+void MockServer::DoAccept() {
+  acceptor_->async_accept([&](const error_code& error, ip::tcp::socket socket) {
+    if (error) {
+      return;
+    }
+    ip::tcp::no_delay no_delay(true);
+    error_code dummy;
+    socket.set_option(no_delay, dummy);
+
+    AddSession(CreateTransport(std::move(socket)));
+    DoAccept();
+  });
+}
+
+void MockServer::DoAcceptLocal() {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  local_acceptor_->async_accept(
+      [&](const error_code& error, local::stream_protocol::socket socket) {
+        if (error) {
+          return;
+        }
+        AddSession(CreateTransport(std::move(socket)));
+        DoAcceptLocal();
+      });
+#endif
+}
+
+void MockServer::AddSession(std::unique_ptr<asap3::Transport> transport) {
+  auto session = std::make_shared<MockSession>(*this, std::move(transport));
+  std::erase_if(session_list_, [](const auto& weak) { return weak.expired(); });
+  session_list_.push_back(session);
+  session->Start();
+}
+
+std::chrono::microseconds MockServer::NextDelay() {
+  if (jitter_.count() <= 0) {
+    return latency_;
+  }
+  std::scoped_lock lock(locker_);
+  std::uniform_int_distribution<int64_t> distribution(0, jitter_.count());
+  return latency_ + std::chrono::microseconds(distribution(random_));
+}
+
+bool MockServer::Inject(double rate) {
+  if (rate <= 0.0) {
+    return false;
+  }
+  std::scoped_lock lock(locker_);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  return distribution(random_) < rate;
+}
+
+void MockServer::HandleRequest(MockSession& session,
+                               const std::vector<uint8_t>& body,
+                               std::vector<uint8_t>& response_body) {
+  ++nof_requests_;
+  uint16_t cmd = 0;
+  size_t offset = Asap3Helper::ToMc3Value(body, 0, cmd);
+
+  IResponse response;
+  response.Cmd(static_cast<CommandCode>(cmd));
+  response.Status(StatusCode::STATUS_OK);
+  DataValueList data_list;
+
+  const auto command = static_cast<CommandCode>(cmd);
+  const bool can_inject = command != CommandCode::EXIT;
+
+  if (can_inject && Inject(not_processed_rate_)) {
+    ++nof_injected_errors_;
+    response.Status(StatusCode::STATUS_NOT_PROCESSED);
+  } else if (can_inject && Inject(repeat_cmd_rate_)) {
+    ++nof_injected_errors_;
+    response.Status(StatusCode::STATUS_REPEAT_CMD);
+  } else if (can_inject && measuring_data_changed_.exchange(false)) {
+    response.Status(StatusCode::STATUS_MEASURING_DATA_CHANGED);
+  } else {
+    switch (command) {
+      case CommandCode::INIT:
+      case CommandCode::EXIT:
+      case CommandCode::EMERGENCY:
+      case CommandCode::SWITCHING_OFFLINE_ONLINE:
+        break;
+
+      case CommandCode::IDENTIFY:
+        data_list.push_back({"Version", Mc3DataType::A_UINT16, version_});
+        data_list.push_back({"Name", Mc3DataType::MC3_STRING, name_});
+        break;
+
+      case CommandCode::QUERY_AVAILABLE_SERVICE: {
+        const auto service_list = AvailableServices();
+        data_list.push_back({"Services", Mc3DataType::A_UINT16,
+                             static_cast<uint16_t>(service_list.size())});
+        for (const auto& service : service_list) {
+          data_list.push_back({"Service", Mc3DataType::MC3_STRING,
+                               service.name});
+        }
+        break;
+      }
+
+      case CommandCode::GET_SERVICE_INFORMATION: {
+        std::string service;
+        Asap3Helper::ToMc3Value(body, offset, service);
+        data_list.push_back({"Service Info", Mc3DataType::MC3_STRING,
+                             service + " (Mock)"});
+        break;
+      }
+
+      case CommandCode::EXECUTE_SERVICE: {
+        std::string service;
+        std::string input;
+        offset += Asap3Helper::ToMc3Value(body, offset, service);
+        Asap3Helper::ToMc3Value(body, offset, input);
+        auto output = ExecuteService(service, input);
+        if (IEquals(service, std::string(kDisableSetValueAck))) {
+          session.setvalue_ack_disabled_ = input == "1";
+        } else if (IEquals(service, std::string(kGetShareName))) {
+          output = OpenSharedValues(session);
+        }
+        data_list.push_back({"Output", Mc3DataType::MC3_STRING, output});
+        break;
+      }
+
+      case CommandCode::PARAMETER_FOR_VALUE_ACQUISITION:
+      case CommandCode::PARAMETER_FOR_VALUE_ACQUISITION_EV2: {
+        uint16_t lun = 0;
+        uint16_t sample_rate = 0;
+        uint16_t nof_meas = 0;
+        offset += Asap3Helper::ToMc3Value(body, offset, lun);
+        offset += Asap3Helper::ToMc3Value(body, offset, sample_rate);
+        offset += Asap3Helper::ToMc3Value(body, offset, nof_meas);
+        if (nof_meas == 0) {
+          session.subscription_list_.clear();
+        }
+        {
+          std::scoped_lock lock(locker_);
+          for (uint16_t meas = 0; meas < nof_meas; ++meas) {
+            std::string name;
+            offset += Asap3Helper::ToMc3Value(body, offset, name);
+            const auto itr = std::ranges::find_if(
+                parameter_list_,
+                [&](const auto& par) { return IEquals(par.Name(), name); });
+            if (itr == parameter_list_.end()) {
+              SetError(response, data_list, "Unknown parameter: " + name);
+              break;
+            }
+            session.subscription_list_.push_back(
+                static_cast<size_t>(itr - parameter_list_.begin()));
+          }
+        }
+        PublishSharedValues(session);
+        break;
+      }
+
+      case CommandCode::GET_ONLINE_VALUE:
+      case CommandCode::GET_ONLINE_VALUE_EV2:
+        ++nof_online_requests_;
+        OnlineValues(session, data_list);
+        break;
+
+      case CommandCode::GET_CALPAGE_INFO: {
+        data_list.push_back(
+            {"Pages", Mc3DataType::A_UINT16, static_cast<uint16_t>(2)});
+        const std::array<std::string, 2> page_list = {"Working", "Reference"};
+        for (uint16_t page = 0; page < page_list.size(); ++page) {
+          data_list.push_back({"Index", Mc3DataType::A_UINT16, page});
+          data_list.push_back(
+              {"Name", Mc3DataType::MC3_STRING, page_list[page]});
+          data_list.push_back({"Properties", Mc3DataType::A_UINT16,
+                               static_cast<uint16_t>(page == 0 ? 1 : 0)});
+        }
+        break;
+      }
+
+      case CommandCode::GET_CURRENT_CALPAGE:
+        data_list.push_back(
+            {"Page", Mc3DataType::A_UINT16, current_page_.load()});
+        break;
+
+      case CommandCode::GET_CHARACTERISTIC_INFO:
+      case CommandCode::READ_CHARACTERISTIC:
+      case CommandCode::WRITE_CHARACTERISTIC:
+      case CommandCode::READ_CELL_VALUES:
+      case CommandCode::WRITE_CELL_VALUES:
+        HandleCharacteristic(command, body, offset, response, data_list);
+        break;
+
+      case CommandCode::SET_PARAMETER:
+      case CommandCode::SET_PARAMETER_EV2:
+        HandleSetParameter(command, body, offset, response, data_list);
+        break;
+
+      case CommandCode::SELECT_LOOKUP_TABLE_EV2:
+      case CommandCode::GET_LOOKUP_TABLE_EV2:
+      case CommandCode::PUT_LOOKUP_TABLE_EV2:
+      case CommandCode::INCREASE_LOOKUP_TABLE_EV2:
+        HandleLookupTable(command, body, offset, response, data_list);
+        break;
+
+      default:
+        response.Status(StatusCode::STATUS_CMD_NOT_AVAILABLE);
+        break;
+    }
+  }
+
+  // Set values are only answered on errors when the ack is disabled
+  if (session.setvalue_ack_disabled_ &&
+      response.Status() == StatusCode::STATUS_OK &&
+      (command == CommandCode::SET_PARAMETER ||
+       command == CommandCode::SET_PARAMETER_EV2)) {
+    return;
+  }
+  response.DataList(data_list);
+  response.CreateBody(response_body);
+  if (Inject(checksum_error_rate_) && response_body.size() >= 2) {
+    ++nof_injected_errors_;
+    response_body.back() ^= 0xFF;
+  }
+}
+
+void MockServer::HandleCharacteristic(CommandCode command,
+                                      const std::vector<uint8_t>& body,
+                                      size_t offset, IResponse& response,
+                                      DataValueList& data_list) {
+  uint16_t lun = 0;
+  std::string name;
+  offset += Asap3Helper::ToMc3Value(body, offset, lun);
+  offset += Asap3Helper::ToMc3Value(body, offset, name);
+
+  std::scoped_lock lock(locker_);
+  auto itr = characteristic_list_.find(name);
+  if (itr == characteristic_list_.end()) {
+    SetError(response, data_list, "Unknown characteristic: " + name);
+    return;
+  }
+  auto& mock = itr->second;
+  auto& characteristic = mock.characteristic;
+  const auto& dimension_list = characteristic.DimensionList();
+  std::vector<uint8_t> payload;
+
+  switch (command) {
+    case CommandCode::GET_CHARACTERISTIC_INFO:
+      data_list.push_back({"Type", Mc3DataType::A_UINT16,
+                           static_cast<uint16_t>(characteristic.Type())});
+      data_list.push_back({"Min", Mc3DataType::A_FLOAT32, mock.min});
+      data_list.push_back({"Max", Mc3DataType::A_FLOAT32, mock.max});
+      data_list.push_back({"Increment", Mc3DataType::A_FLOAT32, 0.01F});
+      data_list.push_back({"Dimensions", Mc3DataType::A_UINT16,
+                           static_cast<uint16_t>(dimension_list.size())});
+      for (const auto dimension : dimension_list) {
+        data_list.push_back({"Dimension", Mc3DataType::A_UINT16, dimension});
+      }
+      break;
+
+    case CommandCode::READ_CHARACTERISTIC: {
+      data_list.push_back({"Type", Mc3DataType::A_UINT16,
+                           static_cast<uint16_t>(characteristic.Type())});
+      data_list.push_back({"Dimensions", Mc3DataType::A_UINT16,
+                           static_cast<uint16_t>(dimension_list.size())});
+      auto index = Asap3Helper::FromMc3Array(
+          payload, 0, std::span<const uint16_t>(dimension_list));
+      for (size_t axis = 0; axis < characteristic.NofAxes(); ++axis) {
+        index += Asap3Helper::FromMc3Array(
+            payload, index,
+            std::as_const(characteristic).Axis(axis));
+      }
+      Asap3Helper::FromMc3Array(payload, index,
+                                std::as_const(characteristic).Values());
+      break;
+    }
+
+    case CommandCode::WRITE_CHARACTERISTIC: {
+      uint16_t type = 0;
+      uint16_t dimensions = 0;
+      offset += Asap3Helper::ToMc3Value(body, offset, type);
+      offset += Asap3Helper::ToMc3Value(body, offset, dimensions);
+      std::vector<uint16_t> write_list(dimensions, 0);
+      offset += Asap3Helper::ToMc3Array(body, offset,
+                                        std::span<uint16_t>(write_list));
+      if (static_cast<Mc3CharType>(type) != characteristic.Type() ||
+          write_list != dimension_list ||
+          offset + characteristic.NofValues() * sizeof(float) + 2 >
+              body.size()) {
+        SetError(response, data_list, "Invalid characteristic: " + name);
+        break;
+      }
+      Asap3Helper::ToMc3Array(body, offset, characteristic.Values());
+      ++nof_characteristic_writes_;
+      break;
+    }
+
+    case CommandCode::READ_CELL_VALUES:
+    case CommandCode::WRITE_CELL_VALUES: {
+      uint16_t dimensions = 0;
+      offset += Asap3Helper::ToMc3Value(body, offset, dimensions);
+      std::vector<uint16_t> start_list(dimensions, 0);
+      std::vector<uint16_t> count_list(dimensions, 0);
+      offset += Asap3Helper::ToMc3Array(body, offset,
+                                        std::span<uint16_t>(start_list));
+      offset += Asap3Helper::ToMc3Array(body, offset,
+                                        std::span<uint16_t>(count_list));
+      const auto view = CellView(characteristic, start_list, count_list);
+      if (view.Empty()) {
+        SetError(response, data_list, "Invalid cell range: " + name);
+        break;
+      }
+      std::vector<float> value_list(view.Size(), 0.0F);
+      if (command == CommandCode::READ_CELL_VALUES) {
+        view.CopyTo(value_list);
+        data_list.push_back({"Values", Mc3DataType::A_UINT16,
+                             static_cast<uint16_t>(value_list.size())});
+        Asap3Helper::FromMc3Array(payload, 0,
+                                  std::span<const float>(value_list));
+        break;
+      }
+      if (offset + value_list.size() * sizeof(float) + 2 > body.size()) {
+        SetError(response, data_list, "Missing cell values: " + name);
+        break;
+      }
+      Asap3Helper::ToMc3Array(body, offset, std::span<float>(value_list));
+      view.CopyFrom(value_list);
+      ++nof_cell_writes_;
+      break;
+    }
+
+    default:
+      break;
+  }
+  response.Payload(std::move(payload));
+}
+
+void MockServer::HandleSetParameter(CommandCode command,
+                                    const std::vector<uint8_t>& body,
+                                    size_t offset, IResponse& response,
+                                    DataValueList& data_list) {
+  ++nof_setpoint_requests_;
+  uint16_t lun = 0;
+  uint16_t nof_values = 1;
+  offset += Asap3Helper::ToMc3Value(body, offset, lun);
+  if (command == CommandCode::SET_PARAMETER_EV2) {
+    offset += Asap3Helper::ToMc3Value(body, offset, nof_values);
+  }
+  std::scoped_lock lock(locker_);
+  for (uint16_t index = 0; index < nof_values; ++index) {
+    std::string name;
+    float value = 0.0F;
+    offset += Asap3Helper::ToMc3Value(body, offset, name);
+    offset += Asap3Helper::ToMc3Value(body, offset, value);
+    const auto itr = std::ranges::find_if(
+        parameter_list_,
+        [&](const auto& par) { return IEquals(par.Name(), name); });
+    if (itr == parameter_list_.end()) {
+      SetError(response, data_list, "Unknown parameter: " + name);
+      return;
+    }
+    setpoint_list_[itr->Name()] = value;
+    ++nof_setpoint_values_;
+  }
+}
+
+void MockServer::HandleLookupTable(CommandCode command,
+                                   const std::vector<uint8_t>& body,
+                                   size_t offset, IResponse& response,
+                                   DataValueList& data_list) {
+  ++nof_lookup_requests_;
+  uint16_t lun = 0;
+  offset += Asap3Helper::ToMc3Value(body, offset, lun);
+
+  std::scoped_lock lock(locker_);
+  std::string name;
+  uint32_t address = 0;
+  if (command == CommandCode::SELECT_LOOKUP_TABLE_EV2) {
+    Asap3Helper::ToMc3Value(body, offset, name);
+    const auto itr = std::ranges::find(lookup_address_list_, name);
+    address = kLookupBaseAddress +
+              kLookupAddressStep *
+                  static_cast<uint32_t>(itr - lookup_address_list_.begin());
+  } else {
+    offset += Asap3Helper::ToMc3Value(body, offset, address);
+    const auto index = (address - kLookupBaseAddress) / kLookupAddressStep;
+    if (address >= kLookupBaseAddress && index < lookup_address_list_.size()) {
+      name = lookup_address_list_[index];
+    }
+  }
+  auto itr = characteristic_list_.find(name);
+  if (itr == characteristic_list_.end() ||
+      itr->second.characteristic.NofDimensions() > 2) {
+    SetError(response, data_list, "Unknown lookup table: " + name);
+    return;
+  }
+  auto& characteristic = itr->second.characteristic;
+  const auto x_dim = static_cast<uint16_t>(characteristic.Dimension(0));
+  const auto y_dim = static_cast<uint16_t>(characteristic.Dimension(1));
+  std::vector<uint8_t> payload;
+
+  switch (command) {
+    case CommandCode::SELECT_LOOKUP_TABLE_EV2:
+      data_list.push_back({"Address", Mc3DataType::A_UINT32, address});
+      data_list.push_back({"X Dim", Mc3DataType::A_UINT16, x_dim});
+      data_list.push_back({"Y Dim", Mc3DataType::A_UINT16, y_dim});
+      break;
+
+    case CommandCode::GET_LOOKUP_TABLE_EV2:
+      data_list.push_back({"X Dim", Mc3DataType::A_UINT16, x_dim});
+      data_list.push_back({"Y Dim", Mc3DataType::A_UINT16, y_dim});
+      Asap3Helper::FromMc3Array(payload, 0,
+                                std::as_const(characteristic).Values());
+      break;
+
+    case CommandCode::PUT_LOOKUP_TABLE_EV2: {
+      uint16_t put_x = 0;
+      uint16_t put_y = 0;
+      offset += Asap3Helper::ToMc3Value(body, offset, put_x);
+      offset += Asap3Helper::ToMc3Value(body, offset, put_y);
+      if (put_x != x_dim || put_y != y_dim ||
+          offset + characteristic.NofValues() * sizeof(float) + 2 >
+              body.size()) {
+        SetError(response, data_list, "Invalid lookup table: " + name);
+        break;
+      }
+      Asap3Helper::ToMc3Array(body, offset, characteristic.Values());
+      ++nof_characteristic_writes_;
+      break;
+    }
+
+    case CommandCode::INCREASE_LOOKUP_TABLE_EV2: {
+      uint16_t mode = 0;
+      std::vector<uint16_t> start_list(2, 0);
+      std::vector<uint16_t> count_list(2, 0);
+      float value = 0.0F;
+      offset += Asap3Helper::ToMc3Value(body, offset, mode);
+      offset += Asap3Helper::ToMc3Value(body, offset, start_list[0]);
+      offset += Asap3Helper::ToMc3Value(body, offset, start_list[1]);
+      offset += Asap3Helper::ToMc3Value(body, offset, count_list[0]);
+      offset += Asap3Helper::ToMc3Value(body, offset, count_list[1]);
+      Asap3Helper::ToMc3Value(body, offset, value);
+      // A curve is a table with one row
+      start_list.resize(characteristic.NofDimensions());
+      count_list.resize(characteristic.NofDimensions());
+      const auto view = CellView(characteristic, start_list, count_list);
+      if (view.Empty()) {
+        SetError(response, data_list, "Invalid cell range: " + name);
+        break;
+      }
+      view.ForEach([&](float& cell) {
+        switch (static_cast<Mc3ValueType>(mode)) {
+          case Mc3ValueType::OFFSET:
+            cell += value;
+            break;
+          case Mc3ValueType::FACTOR:
+            cell *= value;
+            break;
+          default:
+            cell = value;
+            break;
+        }
+      });
+      ++nof_cell_writes_;
+      break;
+    }
+
+    default:
+      break;
+  }
+  response.Payload(std::move(payload));
+}
+
+std::string MockServer::ExecuteService(const std::string& service,
+                                       const std::string& input) const {
+  ServiceFunction function;
+  {
+    std::scoped_lock lock(locker_);
+    const auto itr = std::ranges::find_if(service_list_, [&](const auto& p) {
+      return IEquals(p.first, service);
+    });
+    if (itr == service_list_.cend()) {
+      return {};
+    }
+    function = itr->second;
+  }
+  return function ? function(input) : std::string();
+}
+
+std::string MockServer::ConfigText(const A3ParameterList& list,
+                                   const std::string& input) {
+  // Input is "min,max" where the indexes are zero-based and inclusive.
+  size_t min_index = 0;
+  size_t max_index = 0;
+  const auto* first = input.data();
+  const auto* last = input.data() + input.size();
+  auto [next, error] = std::from_chars(first, last, min_index);
+  if (error == std::errc() && next < last && *next == ',') {
+    std::from_chars(next + 1, last, max_index);
+  } else {
+    max_index = min_index;
+  }
+
+  std::ostringstream config;
+  for (size_t index = min_index; index <= max_index && index < list.size();
+       ++index) {
+    const auto& par = list[index];
+    config << "Name=" << par.Name() << "\n"
+           << "Unit=" << par.Unit() << "\n"
+           << "Type=" << static_cast<int>(par.Type()) << "\n"
+           << "Max=" << par.Max() << "\n"
+           << "Min=" << par.Min() << "\n"
+           << "Descr=" << par.Description() << "\n"
+           << "Device=" << par.Device() << "\n"
+           << "Id=" << par.Identity() << "\n"
+           << "Signal=" << par.Signal() << "\n"
+           << "SetPoint=" << (par.SetPoint() ? 1 : 0) << "\n"
+           << "Dpname=" << par.DisplayName() << "\n"
+           << "Cycle=" << par.CycleTime() << "\n"
+           << "NofDec=" << static_cast<int>(par.NofDecimals()) << "\n"
+           << "Lun=" << par.LunNo() << "\n";
+  }
+  return config.str();
+}
+
+void MockServer::PublishSharedValues() {
+  if (!started_) {
+    return;
+  }
+  std::promise<void> done;
+  post(context_, [&] {
+    for (auto& weak : session_list_) {
+      if (auto session = weak.lock(); session && session->shared_values_) {
+        ++session->poll_count_;
+        PublishSharedValues(*session);
+      }
+    }
+    done.set_value();
+  });
+  done.get_future().wait();
+}
+
+std::string MockServer::OpenSharedValues(MockSession& session) {
+  const auto name = "asap3_" + std::to_string(port_) + "_" +
+                    std::to_string(++nof_shared_regions_);
+  auto writer = std::make_unique<SharedValueWriter>();
+  if (!writer->Create(name, kSharedCapacity)) {
+    return {};
+  }
+  session.shared_values_ = std::move(writer);
+  return name;
+}
+
+void MockServer::PublishSharedValues(MockSession& session) const {
+  if (!session.shared_values_) {
+    return;
+  }
+  // Same values as the poll
+  std::vector<double> value_list;
+  value_list.reserve(session.subscription_list_.size());
+  {
+    std::scoped_lock lock(locker_);
+    for (const auto index : session.subscription_list_) {
+      value_list.push_back(static_cast<double>(index + session.poll_count_));
+    }
+  }
+  session.shared_values_->Write(value_list);
+}
+
+void MockServer::OnlineValues(MockSession& session,
+                              DataValueList& value_list) const {
+  // Each value is its parameter index plus the number of polls. This gives
+  // changing but predictable values.
+  ++session.poll_count_;
+  std::scoped_lock lock(locker_);
+  value_list.reserve(session.subscription_list_.size());
+  for (const auto index : session.subscription_list_) {
+    const auto& par = parameter_list_[index];
+    const auto value = static_cast<double>(index + session.poll_count_);
+    value_list.push_back({par.Name(), par.Type(), ToAnyValue(par.Type(), value)});
+  }
+}
+
+}  // namespace asap3::test
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asap/a3parameter.h"
+#include "asap/asap3def.h"
+#include "asap/characteristic.h"
+#include "asap/iclient.h"
+#include "asap/iresponse.h"
+
+namespace asap3 {
+class Transport;
+}
+
+namespace asap3::test {
+
+class MockSession;
+
+/** \brief Local ASAP3 server used by the unit tests and benchmarks.
+ *
+ * The server answers the basic ASAP3 commands and the ComTest services that
+ * the clients in this library use. Latency, jitter and error injection can
+ * be configured before the server is started. The server runs its own
+ * worker thread and accepts any number of client connections.
+ */
+class MockServer {
+ public:
+  using ServiceFunction = std::function<std::string(const std::string&)>;
+
+  MockServer();
+  virtual ~MockServer();
+
+  MockServer(const MockServer&) = delete;
+  MockServer& operator=(const MockServer&) = delete;
+
+  void Name(const std::string& name) { name_ = name; }
+  [[nodiscard]] const std::string& Name() const { return name_; }
+
+  /// Port 0 selects a free port. The actual port is available after start.
+  void Port(uint16_t port) { port_ = port; }
+  [[nodiscard]] uint16_t Port() const { return port_; }
+
+  /// TCP uses the port, Unix sockets the path and memory pipes the name in
+  /// Address().
+  void Transport(TransportType type) { transport_type_ = type; }
+  [[nodiscard]] TransportType Transport() const { return transport_type_; }
+  void Address(const std::string& address) { address_ = address; }
+  [[nodiscard]] const std::string& Address() const { return address_; }
+
+  void Version(uint16_t version) { version_ = version; }
+  [[nodiscard]] uint16_t Version() const { return version_; }
+
+  void Latency(std::chrono::microseconds latency) { latency_ = latency; }
+  [[nodiscard]] std::chrono::microseconds Latency() const { return latency_; }
+
+  void Jitter(std::chrono::microseconds jitter) { jitter_ = jitter; }
+  [[nodiscard]] std::chrono::microseconds Jitter() const { return jitter_; }
+
+  /// Probability (0..1) that a request is answered with STATUS_REPEAT_CMD.
+  void RepeatCmdRate(double rate) { repeat_cmd_rate_ = rate; }
+  [[nodiscard]] double RepeatCmdRate() const { return repeat_cmd_rate_; }
+
+  /// Probability (0..1) that a request is answered with STATUS_NOT_PROCESSED.
+  void NotProcessedRate(double rate) { not_processed_rate_ = rate; }
+  [[nodiscard]] double NotProcessedRate() const { return not_processed_rate_; }
+
+  /// Probability (0..1) that a response is sent with an invalid checksum.
+  void ChecksumErrorRate(double rate) { checksum_error_rate_ = rate; }
+  [[nodiscard]] double ChecksumErrorRate() const {
+    return checksum_error_rate_;
+  }
+
+  void Seed(uint32_t seed) { random_.seed(seed); }
+
+  void AddParameter(const A3Parameter& parameter);
+  void CreateParameters(size_t nof_parameters);
+  [[nodiscard]] size_t NofParameters() const;
+
+  void CreateSignals(size_t nof_signals);
+  [[nodiscard]] size_t NofSignals() const;
+
+  /// Adds or replaces a characteristic. The limits are reported by
+  /// GET_CHARACTERISTIC_INFO. Curves and maps can also be used as EV2
+  /// lookup tables.
+  void AddCharacteristic(const Characteristic& characteristic,
+                         float min = -1000.0F, float max = 1000.0F);
+  [[nodiscard]] Characteristic GetCharacteristic(
+      const std::string& name) const;
+
+  /// Latest value written by SET_PARAMETER(_EV2). NaN if never written.
+  [[nodiscard]] float SetPointValue(const std::string& name) const;
+
+  /// Publishes the subscribed values of all sessions that use shared
+  /// memory. Each publish steps the values like a poll does.
+  void PublishSharedValues();
+
+  /// Page 0 is the working page and page 1 the reference page.
+  void CurrentPage(uint16_t page) { current_page_ = page; }
+  [[nodiscard]] uint16_t CurrentPage() const { return current_page_; }
+  /// The next response gets STATUS_MEASURING_DATA_CHANGED.
+  void MeasuringDataChanged() { measuring_data_changed_ = true; }
+
+  /// Adds or replaces a service that EXECUTE_SERVICE may call.
+  void AddService(const std::string& service, ServiceFunction function);
+  [[nodiscard]] ServiceList AvailableServices() const;
+
+  bool Start();
+  void Stop();
+  [[nodiscard]] bool IsStarted() const { return started_; }
+
+  [[nodiscard]] uint64_t NofRequests() const { return nof_requests_; }
+  [[nodiscard]] uint64_t NofOnlineRequests() const {
+    return nof_online_requests_;
+  }
+  [[nodiscard]] uint64_t NofInjectedErrors() const {
+    return nof_injected_errors_;
+  }
+  [[nodiscard]] uint64_t NofCharacteristicWrites() const {
+    return nof_characteristic_writes_;
+  }
+  [[nodiscard]] uint64_t NofCellWrites() const { return nof_cell_writes_; }
+  [[nodiscard]] uint64_t NofLookupRequests() const {
+    return nof_lookup_requests_;
+  }
+  [[nodiscard]] uint64_t NofSetPointRequests() const {
+    return nof_setpoint_requests_;
+  }
+  [[nodiscard]] uint64_t NofSetPointValues() const {
+    return nof_setpoint_values_;
+  }
+
+ private:
+  friend class MockSession;
+
+  std::string name_ = "MockServer";
+  uint16_t port_ = 0;
+  TransportType transport_type_ = TransportType::Tcp;
+  std::string address_;
+  uint16_t version_ = 3 * 256 + 0;
+
+  std::chrono::microseconds latency_ = std::chrono::microseconds(0);
+  std::chrono::microseconds jitter_ = std::chrono::microseconds(0);
+  double repeat_cmd_rate_ = 0.0;
+  double not_processed_rate_ = 0.0;
+  double checksum_error_rate_ = 0.0;
+
+  mutable std::mutex locker_;
+  std::mt19937 random_;
+  A3ParameterList parameter_list_;
+  A3ParameterList signal_list_;
+  std::map<std::string, ServiceFunction> service_list_;
+  struct MockCharacteristic {
+    Characteristic characteristic;
+    float min = 0.0F;
+    float max = 0.0F;
+  };
+  std::map<std::string, MockCharacteristic> characteristic_list_;
+  std::vector<std::string> lookup_address_list_;  ///< Name by lookup address
+  std::map<std::string, float> setpoint_list_;
+  std::atomic<uint16_t> current_page_ = 0;
+  std::atomic<bool> measuring_data_changed_ = false;
+
+  boost::asio::io_context context_;
+  std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  std::unique_ptr<boost::asio::local::stream_protocol::acceptor>
+      local_acceptor_;
+#endif
+  bool pipe_listening_ = false;
+  std::vector<std::weak_ptr<MockSession>> session_list_;
+  std::thread worker_thread_;
+  std::atomic<bool> started_ = false;
+
+  std::atomic<uint64_t> nof_requests_ = 0;
+  std::atomic<uint64_t> nof_online_requests_ = 0;
+  std::atomic<uint64_t> nof_injected_errors_ = 0;
+  std::atomic<uint64_t> nof_characteristic_writes_ = 0;
+  std::atomic<uint64_t> nof_cell_writes_ = 0;
+  std::atomic<uint64_t> nof_lookup_requests_ = 0;
+  std::atomic<uint64_t> nof_setpoint_requests_ = 0;
+  std::atomic<uint64_t> nof_setpoint_values_ = 0;
+  std::atomic<uint64_t> nof_shared_regions_ = 0;
+
+  void DoAccept();
+  void DoAcceptLocal();
+  void AddSession(std::unique_ptr<asap3::Transport> transport);
+  void WorkerThread();
+
+  [[nodiscard]] std::chrono::microseconds NextDelay();
+  [[nodiscard]] bool Inject(double rate);
+
+  void HandleRequest(MockSession& session, const std::vector<uint8_t>& body,
+                     std::vector<uint8_t>& response_body);
+  [[nodiscard]] std::string ExecuteService(const std::string& service,
+                                           const std::string& input) const;
+  [[nodiscard]] static std::string ConfigText(const A3ParameterList& list,
+                                              const std::string& input);
+  void OnlineValues(MockSession& session, DataValueList& value_list) const;
+  [[nodiscard]] std::string OpenSharedValues(MockSession& session);
+  void PublishSharedValues(MockSession& session) const;
+  void HandleCharacteristic(CommandCode command,
+                            const std::vector<uint8_t>& body, size_t offset,
+                            IResponse& response, DataValueList& data_list);
+  void HandleSetParameter(CommandCode command,
+                          const std::vector<uint8_t>& body, size_t offset,
+                          IResponse& response, DataValueList& data_list);
+  void HandleLookupTable(CommandCode command, const std::vector<uint8_t>& body,
+                         size_t offset, IResponse& response,
+                         DataValueList& data_list);
+};
+
+}  // namespace asap3::test
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 Ingemar Hedvall
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+
+#include "mockserver.h"
+
+using namespace boost::program_options;
+using namespace asap3::test;
+
+int main(int nof_arg, char* arg_list[]) {
+  options_description desc("Local ASAP3 mock server");
+  desc.add_options()("help,h", "Produce help message")(
+      "port,p", value<uint16_t>()->default_value(6003), "TCP/IP port")(
+      "name,n", value<std::string>()->default_value("MockServer"),
+      "Server name reported by IDENTIFY")(
+      "parameters", value<size_t>()->default_value(100),
+      "Number of parameters")(
+      "latency", value<int64_t>()->default_value(0), "Response latency (us)")(
+      "jitter", value<int64_t>()->default_value(0), "Max added jitter (us)")(
+      "repeat-rate", value<double>()->default_value(0.0),
+      "Probability of STATUS_REPEAT_CMD")(
+      "not-processed-rate", value<double>()->default_value(0.0),
+      "Probability of STATUS_NOT_PROCESSED")(
+      "checksum-error-rate", value<double>()->default_value(0.0),
+      "Probability of an invalid checksum")(
+      "seed", value<uint32_t>()->default_value(0), "Random seed");
+
+  variables_map vm;
+  try {
+    store(parse_command_line(nof_arg, arg_list, desc), vm);
+    notify(vm);
+  } catch (const std::exception& err) {
+    std::cerr << err.what() << std::endl << desc << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << desc << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  MockServer server;
+  server.Port(vm["port"].as<uint16_t>());
+  server.Name(vm["name"].as<std::string>());
+  server.CreateParameters(vm["parameters"].as<size_t>());
+  server.Latency(std::chrono::microseconds(vm["latency"].as<int64_t>()));
+  server.Jitter(std::chrono::microseconds(vm["jitter"].as<int64_t>()));
+  server.RepeatCmdRate(vm["repeat-rate"].as<double>());
+  server.NotProcessedRate(vm["not-processed-rate"].as<double>());
+  server.ChecksumErrorRate(vm["checksum-error-rate"].as<double>());
+  server.Seed(vm["seed"].as<uint32_t>());
+
+  if (!server.Start()) {
+    std::cerr << "Failed to start the mock server. Port: " << server.Port()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Mock server listening on port " << server.Port()
+            << ". Press Ctrl-C to stop." << std::endl;
+
+  boost::asio::io_context context;
+  boost::asio::signal_set signals(context, SIGINT, SIGTERM);
+  signals.async_wait([&](const auto&, int) { context.stop(); });
+  context.run();
+
+  server.Stop();
+  std::cout << "Requests: " << server.NofRequests()
+            << ", Injected Errors: " << server.NofInjectedErrors() << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -10,10 +10,27 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/any.hpp>
 #include <chrono>
+#include <filesystem>
 #include <thread>
 #include <variant>
 
 #include "asap/asap3factory.h"
+#include "asap/calibrationshadow.h"
+#include "asap/characteristic.h"
+#include "asap/latencyhistogram.h"
+#include "asap/lookuptable.h"
+#include "asap/metadatacache.h"
+#include "asap/nameindex.h"
+#include "asap/onlinetable.h"
+#include "asap/parametercatalog.h"
+#include "asap/searchindex.h"
+#include "asap/sharedvalues.h"
+#include "asap/tensorview.h"
+#include "asap/tracering.h"
+#include "asap3helper.h"
+#include "asap3proxy.h"
+#include "mockserver.h"
+#include "transport.h"
 
 using namespace std::chrono_literals;
 using namespace util::log;
@@ -81,10 +98,14 @@ TEST(Asap3Client, TestConnect)  // NOLINT
   listen_console->Start();
   listen_console->SetActive(true);
 
+  MockServer server;
+  server.CreateParameters(120);
+  ASSERT_TRUE(server.Start());
+
   auto query =
       Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
   query->Host("127.0.0.1");
-  query->Port(6003);
+  query->Port(server.Port());
   query->Name("CTPAR");
   EXPECT_TRUE(query->Start());
   EXPECT_TRUE(query->Stop());
@@ -94,7 +115,7 @@ TEST(Asap3Client, TestConnect)  // NOLINT
   ASSERT_TRUE(client);
 
   client->Host("127.0.0.1");
-  client->Port(6003);
+  client->Port(server.Port());
   client->Name("OLLE");
 
   const auto start = client->Start();
@@ -103,6 +124,8 @@ TEST(Asap3Client, TestConnect)  // NOLINT
       {"Event", Mc3DataType::A_UINT16, static_cast<uint16_t>(666)}};
 
   client->WaitOnIdle();
+  client->SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, {});
+  client->WaitOnIdle();
 
   const auto service_list = client->AvailableServices();
   EXPECT_FALSE(service_list.empty());
@@ -123,9 +146,1915 @@ TEST(Asap3Client, TestConnect)  // NOLINT
 
   client.reset();
   query.reset();
+  server.Stop();
 
   listen_console->Stop();
   listen_console.reset();
 }
 
-}  // namespace asap3::test
\ No newline at end of file
+TEST(Asap3Client, TestRepeatCommand)  // NOLINT
+{
+  MockServer server;
+  server.Seed(1);
+  server.RepeatCmdRate(0.3);
+  server.Jitter(200us);
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->Name("REPEAT");
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  size_t nof_success = 0;
+  for (size_t count = 0; count < 20; ++count) {
+    client->SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, {},
+                         [&](bool success, const ITelegram&) {
+                           if (success) {
+                             ++nof_success;
+                           }
+                         });
+  }
+  EXPECT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(nof_success, 20);
+  EXPECT_GT(server.NofInjectedErrors(), 0);
+  EXPECT_EQ(client->RemoteName(), server.Name());
+  EXPECT_FALSE(client->AvailableServices().empty());
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestOnlineValues)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(60);
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  for (size_t index = 0; index < 60; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index + 1));
+    parameter_list.push_back(parameter);
+  }
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->ParameterList(parameter_list);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->StartSubscription(0));
+  client->SendTelegram(CommandCode::GET_ONLINE_VALUE, {});
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  const auto value_list = client->OnlineValues();
+  ASSERT_EQ(value_list.size(), 60);
+  for (size_t index = 0; index < value_list.size(); ++index) {
+    const auto value = std::any_cast<float>(value_list[index].value);
+    EXPECT_FLOAT_EQ(value, static_cast<float>(index + 1));
+  }
+  EXPECT_EQ(server.NofOnlineRequests(), 1);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(LatencyHistogram, TestBuckets)  // NOLINT
+{
+  for (uint64_t value : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 1000ULL, 123456ULL,
+                         10'000'000'000ULL}) {
+    const auto index = LatencyHistogram::BucketIndex(value);
+    EXPECT_LE(LatencyHistogram::BucketLowValue(index), value);
+    EXPECT_GE(LatencyHistogram::BucketHighValue(index), value);
+  }
+
+  LatencyHistogram histogram;
+  for (int64_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value * 1000);
+  }
+  const auto snapshot = histogram.Snapshot();
+  EXPECT_EQ(snapshot.Count(), 1000);
+  EXPECT_EQ(snapshot.Min(), 1000);
+  EXPECT_EQ(snapshot.Max(), 1'000'000);
+  EXPECT_NEAR(static_cast<double>(snapshot.Percentile(50)), 500'000,
+              500'000 * 0.07);
+  EXPECT_NEAR(static_cast<double>(snapshot.Percentile(99)), 990'000,
+              990'000 * 0.07);
+  EXPECT_EQ(snapshot.Percentile(100), 1'000'000);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Snapshot().Count(), 0);
+}
+
+TEST(Asap3Client, TestLatencySnapshot)  // NOLINT
+{
+  MockServer server;
+  server.Latency(1ms);
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  for (size_t count = 0; count < 10; ++count) {
+    client->SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, {});
+  }
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  const auto latency_list = client->LatencySnapshot();
+  const auto itr = std::ranges::find_if(latency_list, [](const auto& latency) {
+    return latency.cmd == CommandCode::QUERY_AVAILABLE_SERVICE;
+  });
+  ASSERT_TRUE(itr != latency_list.cend());
+  const auto& server_time =
+      itr->stage_list[static_cast<size_t>(LatencyStage::ServerTime)];
+  EXPECT_EQ(server_time.Count(), 10);
+  EXPECT_GE(server_time.Min(), 1'000'000);
+  EXPECT_EQ(
+      itr->stage_list[static_cast<size_t>(LatencyStage::QueueTime)].Count(),
+      10);
+  // Only telegrams with a callback have a callback time
+  EXPECT_EQ(
+      itr->stage_list[static_cast<size_t>(LatencyStage::CallbackTime)].Count(),
+      0);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestMetrics)  // NOLINT
+{
+  MockServer server;
+  server.Seed(2);
+  server.RepeatCmdRate(0.2);
+  server.ChecksumErrorRate(0.2);
+  ASSERT_TRUE(server.Start());
+
+  const auto metrics_file =
+      std::filesystem::temp_directory_path() / "asap3_metrics.prom";
+  std::filesystem::remove(metrics_file);
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Name("METRICS");
+  client->Port(server.Port());
+  client->MetricsFile(metrics_file.string());
+  client->MetricsPeriod(50ms);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  for (size_t count = 0; count < 50; ++count) {
+    client->SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, {});
+  }
+  ASSERT_TRUE(client->WaitOnIdle());
+  std::this_thread::sleep_for(200ms);
+
+  const auto metrics = client->Metrics();
+  EXPECT_EQ(metrics.connects, 1);
+  EXPECT_EQ(metrics.frames_out, metrics.frames_in);
+  EXPECT_EQ(metrics.frames_out, 52 + metrics.repeats);
+  EXPECT_GT(metrics.repeats, 0);
+  EXPECT_GT(metrics.checksum_failures, 0);
+  EXPECT_GT(metrics.bytes_in, metrics.frames_in * 8);
+  EXPECT_GE(metrics.queue_high_water, 1);
+  EXPECT_EQ(metrics.queue_depth, 0);
+
+  EXPECT_TRUE(std::filesystem::exists(metrics_file));
+  const auto text = metrics.ToPrometheus("METRICS");
+  EXPECT_NE(text.find("asap3_repeats_total{client=\"METRICS\"}"),
+            std::string::npos);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+  std::filesystem::remove(metrics_file);
+}
+
+TEST(TraceRing, TestWrap)  // NOLINT
+{
+  TraceRing ring(256);
+  std::vector<uint8_t> frame(40, 0);
+  for (uint8_t count = 0; count < 20; ++count) {
+    frame[0] = count;
+    ring.Write(count % 2 == 0 ? TraceDirection::Transmit
+                              : TraceDirection::Receive,
+               count, frame);
+  }
+  // Each record is 16 + 40 bytes so only 4 fit into the ring.
+  const auto list = ring.Snapshot();
+  ASSERT_EQ(list.size(), 4);
+  for (size_t index = 0; index < list.size(); ++index) {
+    EXPECT_EQ(list[index].time, 16 + index);
+    EXPECT_EQ(list[index].frame.size(), 40);
+    EXPECT_EQ(list[index].frame[0], 16 + index);
+  }
+
+  TraceRecord record;
+  size_t nof_read = 0;
+  while (ring.Read(record)) {
+    ++nof_read;
+  }
+  EXPECT_EQ(nof_read, 4);
+  EXPECT_EQ(ring.Dropped(), 16);
+  EXPECT_EQ(ring.Snapshot().size(), 4);  // Read doesn't remove frames
+}
+
+TEST(Asap3Client, TestTrace)  // NOLINT
+{
+  MockServer server;
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->Trace(true);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  const auto list = client->TraceSnapshot();
+  ASSERT_EQ(list.size(), 4);  // INIT and IDENTIFY
+  EXPECT_EQ(list[0].direction, TraceDirection::Transmit);
+  EXPECT_EQ(list[1].direction, TraceDirection::Receive);
+  for (const auto& record : list) {
+    ASSERT_GE(record.frame.size(), 6);
+    const uint16_t length = (record.frame[0] << 8) | record.frame[1];
+    EXPECT_EQ(length, record.frame.size());
+  }
+
+  // The trace thread ends when tracing is off and restarts when turned on
+  client->Trace(false);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  client->SendTelegram(CommandCode::IDENTIFY, {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(client->TraceSnapshot().size(), 4);
+  client->Trace(true);
+  client->SendTelegram(CommandCode::IDENTIFY, {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(client->TraceSnapshot().size(), 6);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Helper, TestPlainText)  // NOLINT
+{
+  EXPECT_EQ(Asap3Helper::CommandCodeToText(CommandCode::GET_ONLINE_VALUE_EV2),
+            "GET ONLINE VALUE EV2");
+  EXPECT_EQ(Asap3Helper::CommandCodeToText(CommandCode::EXECUTE_SERVICE),
+            "EXECUTE SERVICE");
+  EXPECT_TRUE(
+      Asap3Helper::CommandCodeToText(static_cast<CommandCode>(0x1FF)).empty());
+  EXPECT_EQ(Asap3Helper::StatusCodeToText(StatusCode::STATUS_REPEAT_CMD),
+            "REPEAT CMD");
+
+  const DataValueList list = {
+      {"Float", Mc3DataType::A_FLOAT32, 1.5F},
+      {"Double", Mc3DataType::A_FLOAT64, 1.0 / 3.0},
+      {"Small", Mc3DataType::A_FLOAT64, 1e-7},
+      {"Int", Mc3DataType::A_INT16, int16_t{-12}},
+      {"UInt", Mc3DataType::A_UINT64, uint64_t{18'446'744'073'709'551'615U}},
+      {"Text", Mc3DataType::MC3_STRING, std::string("abc")},
+      {"Bad", Mc3DataType::A_INT32, std::string("wrong type")},
+  };
+  EXPECT_EQ(Asap3Helper::DataListToText(list),
+            "Float: 1.5, Double: 0.333333, Small: 1e-07, Int: -12, "
+            "UInt: 18446744073709551615, Text: abc, Bad: ");
+
+  IResponse response;
+  response.Cmd(CommandCode::IDENTIFY);
+  response.Status(StatusCode::STATUS_OK);
+  response.DataList({{"Version", Mc3DataType::A_INT16, int16_t{2}}});
+  EXPECT_EQ(Asap3Helper::ResponseToPlainText(response),
+            "R:IDENTIFY S:OK Version: 2");
+
+  // A large list is rendered in linear time into a reused buffer
+  DataValueList large(3'000, {"Par", Mc3DataType::A_FLOAT32, 12.25F});
+  std::string text;
+  Asap3Helper::DataListToText(large, text);
+  const auto capacity = text.capacity();
+  EXPECT_EQ(text.size(), 3'000 * 12 - 2);  // "Par: 12.25, "
+  text.clear();
+  Asap3Helper::DataListToText(large, text);
+  EXPECT_EQ(text.capacity(), capacity);
+}
+
+TEST(Asap3Client, TestQueryParameters)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(1'234);
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  client->Port(server.Port());
+  client->DiscoveryChunkSize(100);
+  client->BlockingStart(false);
+
+  std::mutex locker;
+  std::vector<size_t> progress_list;
+  size_t nof_chunk = 0;
+  client->OnParameters([&](const A3ParameterList& chunk, size_t nof_received,
+                           size_t nof_parameters) {
+    std::scoped_lock lock(locker);
+    EXPECT_EQ(nof_parameters, 1'234);
+    nof_chunk += chunk.size();
+    progress_list.push_back(nof_received);
+  });
+  ASSERT_TRUE(client->Start());
+  for (size_t wait = 0; wait < 500 && !client->IsDiscovered(); ++wait) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_TRUE(client->IsDiscovered());
+  {
+    std::scoped_lock lock(locker);
+    ASSERT_EQ(progress_list.size(), 13);  // 12 * 100 + 34
+    EXPECT_EQ(progress_list.front(), 100);
+    EXPECT_EQ(progress_list.back(), 1'234);
+    EXPECT_EQ(nof_chunk, 1'234);
+  }
+  const auto& list = client->ParameterList();
+  ASSERT_EQ(list.size(), 1'234);
+  const auto catalog = client->Catalog();
+  ASSERT_TRUE(catalog);
+  EXPECT_EQ(catalog->Size(), 1'234);
+  for (size_t index = 0; index < list.size(); ++index) {
+    EXPECT_EQ(list[index].Name(), "Par" + std::to_string(index + 1));
+  }
+
+  // A subscription doesn't replace the discovered catalog
+  const A3ParameterList subscription = {list[10]};
+  client->ParameterList(subscription);
+  EXPECT_EQ(client->ParameterList().size(), 1);
+  EXPECT_EQ(client->Catalog()->Size(), 1'234);
+  EXPECT_EQ(client->Catalog()->FindName("par500"), 499);
+  EXPECT_TRUE(client->Stop());
+
+  // The blocking start waits until all parameters are received.
+  auto blocking =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  blocking->Port(server.Port());
+  ASSERT_TRUE(blocking->Start());
+  EXPECT_TRUE(blocking->IsDiscovered());
+  EXPECT_EQ(blocking->ParameterList().size(), 1'234);
+  EXPECT_TRUE(blocking->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestMetadataCache)  // NOLINT
+{
+  const auto filename =
+      (std::filesystem::temp_directory_path() / "asap_test_cache.a3mc")
+          .string();
+  std::filesystem::remove(filename);
+
+  MockServer server;
+  server.CreateParameters(321);
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  client->Port(server.Port());
+  client->MetadataCacheFile(filename);
+  ASSERT_TRUE(client->Start());
+  EXPECT_FALSE(client->IsMetadataCached());
+  EXPECT_EQ(client->ParameterList().size(), 321);
+  EXPECT_TRUE(client->Stop());
+  ASSERT_TRUE(std::filesystem::exists(filename));
+
+  ServerMetadata metadata;
+  ASSERT_TRUE(MetadataCache::Load(filename, metadata));
+  EXPECT_EQ(metadata.remote_name, server.Name());
+  EXPECT_EQ(metadata.parameter_list.size(), 321);
+  EXPECT_EQ(metadata.parameter_list[10].Name(), "Par11");
+  EXPECT_EQ(metadata.parameter_list[10].Unit(), "rpm");
+  EXPECT_FALSE(metadata.service_list.empty());
+
+  // Warm start skips the discovery
+  const auto nof_requests = server.NofRequests();
+  auto warm =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  warm->Port(server.Port());
+  warm->MetadataCacheFile(filename);
+  ASSERT_TRUE(warm->Start());
+  EXPECT_TRUE(warm->IsMetadataCached());
+  EXPECT_EQ(warm->ParameterList().size(), 321);
+  EXPECT_TRUE(warm->HasService("Get Parameter Configuration"));
+  EXPECT_TRUE(warm->Stop());
+  EXPECT_LE(server.NofRequests() - nof_requests, 5);  // INIT, IDENTIFY...
+
+  // A changed configuration invalidates the cache, even if the server
+  // reports the same config file name.
+  server.CreateParameters(1);
+  auto changed =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  changed->Port(server.Port());
+  changed->MetadataCacheFile(filename);
+  ASSERT_TRUE(changed->Start());
+  EXPECT_FALSE(changed->IsMetadataCached());
+  EXPECT_EQ(changed->ParameterList().size(), 322);
+  EXPECT_TRUE(changed->Stop());
+
+  server.Stop();
+  std::filesystem::remove(filename);
+}
+
+TEST(Asap3Helper, TestParseParameterConfig)  // NOLINT
+{
+  const std::string config =
+      "Ignored=1\n"
+      "Name=Speed\r\n"
+      "unit= rpm \r\n"
+      "Type=1\n"
+      "Max=+6000.5\n"
+      "Min=abc\n"
+      "SetPoint=1\n"
+      "NofDec=3\n"
+      "Cycle=\n"
+      "Lun=7\n"
+      "Unknown=x\n"
+      "Name=Torque\n"
+      "Descr=Engine torque\n"
+      "Dpname=Trq";  // No end of line
+
+  A3ParameterList list;
+  Asap3Helper::ParseCtParameterConfigString(config, list);
+  ASSERT_EQ(list.size(), 2);
+
+  const auto& speed = list[0];
+  EXPECT_EQ(speed.Name(), "Speed");
+  EXPECT_EQ(speed.Unit(), "rpm");
+  EXPECT_EQ(speed.Type(), Mc3DataType::A_FLOAT64);
+  EXPECT_DOUBLE_EQ(speed.Max(), 6000.5);
+  EXPECT_DOUBLE_EQ(speed.Min(), 0.0);  // Invalid number
+  EXPECT_TRUE(speed.SetPoint());
+  EXPECT_EQ(speed.NofDecimals(), 3);
+  EXPECT_EQ(speed.CycleTime(), 0);
+  EXPECT_EQ(speed.LunNo(), 7);
+
+  const auto& torque = list[1];
+  EXPECT_EQ(torque.Name(), "Torque");
+  EXPECT_EQ(torque.Description(), "Engine torque");
+  EXPECT_EQ(torque.DisplayName(), "Trq");
+}
+
+TEST(ParameterCatalog, TestIntern)  // NOLINT
+{
+  A3ParameterList list;
+  for (size_t index = 0; index < 10'000; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index));
+    parameter.Unit(index % 2 == 0 ? "rpm" : "Nm");
+    parameter.Device("Device");
+    parameter.Description("Description");
+    parameter.Type(Mc3DataType::A_INT32);
+    parameter.Max(static_cast<double>(index));
+    parameter.SetPoint(index % 10 == 0);
+    parameter.LunNo(static_cast<uint16_t>(index % 7));
+    list.push_back(parameter);
+  }
+  const auto catalog = ParameterCatalog::Create(list);
+  ASSERT_EQ(catalog->Size(), 10'000);
+  // Empty, names, 2 units, device and description
+  EXPECT_EQ(catalog->NofStrings(), 1 + 10'000 + 4);
+
+  const auto view = (*catalog)[1'235];
+  EXPECT_EQ(view.Name(), "Par1235");
+  EXPECT_EQ(view.Unit(), "Nm");
+  EXPECT_EQ(view.Device(), "Device");
+  EXPECT_TRUE(view.Signal().empty());
+  EXPECT_EQ(view.Type(), Mc3DataType::A_INT32);
+  EXPECT_DOUBLE_EQ(view.Max(), 1235.0);
+  EXPECT_FALSE(view.SetPoint());
+  EXPECT_EQ(view.LunNo(), 1'235 % 7);
+
+  size_t nof_set_points = 0;
+  for (const auto parameter : *catalog) {
+    if (parameter.SetPoint()) {
+      ++nof_set_points;
+    }
+  }
+  EXPECT_EQ(nof_set_points, 1'000);
+
+  EXPECT_EQ(catalog->FindName("PAR42"), 42);
+  EXPECT_FALSE(catalog->FindName("Par10000").has_value());
+  EXPECT_FALSE(catalog->FindIdentity("").has_value());
+
+  const auto copy = catalog->ToParameterList();
+  ASSERT_EQ(copy.size(), list.size());
+  EXPECT_EQ(copy[9'999].Name(), list[9'999].Name());
+  EXPECT_EQ(copy[9'999].Unit(), list[9'999].Unit());
+}
+
+TEST(NameIndex, TestFind)  // NOLINT
+{
+  EXPECT_TRUE(IEqualsName("Get Config File", "get CONFIG file"));
+  EXPECT_FALSE(IEqualsName("Get Config File", "Get Config Files"));
+  EXPECT_EQ(HashName("ABC"), HashName("abc"));
+
+  NameIndex index;
+  index.Add("Use Extended Poll", 0);
+  index.Add("Disable SetValue Ack", 1);
+  index.Add("use extended poll", 2);  // Duplicate, first is kept
+  EXPECT_EQ(index.Size(), 2);
+  EXPECT_EQ(index.Find("USE EXTENDED POLL"), 0);
+  EXPECT_EQ(index.Find("disable setvalue ack"), 1);
+  EXPECT_FALSE(index.Find("Disable").has_value());
+  EXPECT_TRUE(index.Contains("Disable SetValue ACK"));
+
+  DataValueList list = {{"Version", Mc3DataType::A_UINT16, uint16_t{0}},
+                        {"Name", Mc3DataType::MC3_STRING, std::string()}};
+  Asap3Helper::SetDataListProperty(list, "NAME", std::string("Test"));
+  EXPECT_EQ(std::any_cast<std::string>(list[1].value), "Test");
+}
+
+TEST(SearchIndex, TestSearch)  // NOLINT
+{
+  EXPECT_TRUE(SearchIndex::GlobMatch("eng*speed*", "EngineSpeedRaw"));
+  EXPECT_TRUE(SearchIndex::GlobMatch("*", ""));
+  EXPECT_TRUE(SearchIndex::GlobMatch("a?c", "ABC"));
+  EXPECT_FALSE(SearchIndex::GlobMatch("a?c", "abbc"));
+  EXPECT_FALSE(SearchIndex::GlobMatch("*speed", "EngineSpeedRaw"));
+
+  const std::vector<std::string_view> name_list = {
+      "EngineSpeed", "EngineTorque", "VehicleSpeed", "EngSpeedRaw", "Gear"};
+  const SearchIndex index(name_list);
+  EXPECT_EQ(index.Prefix("eng"), std::vector<size_t>({0, 1, 3}));
+  EXPECT_EQ(index.Prefix("ENGINE", 1), std::vector<size_t>({0}));
+  EXPECT_EQ(index.Substring("speed"), std::vector<size_t>({0, 2, 3}));
+  EXPECT_EQ(index.Substring("ea"), std::vector<size_t>({4}));
+  EXPECT_TRUE(index.Substring("xyz").empty());
+  EXPECT_EQ(index.Glob("Eng*Speed*"), std::vector<size_t>({0, 3}));
+  EXPECT_EQ(index.Glob("*Speed"), std::vector<size_t>({0, 2}));
+  EXPECT_EQ(index.Glob("*e?r*"), std::vector<size_t>({3, 4}));
+  EXPECT_EQ(index.Glob("*").size(), 5);
+
+  // Large catalog
+  A3ParameterList list;
+  for (size_t index = 0; index < 50'000; ++index) {
+    A3Parameter parameter;
+    parameter.Name((index % 2 == 0 ? "Engine" : "Vehicle") +
+                   std::to_string(index) + "Speed");
+    list.push_back(parameter);
+  }
+  const auto catalog = ParameterCatalog::Create(list);
+  const auto result = catalog->Search("eng*12*speed");
+  ASSERT_FALSE(result.empty());
+  for (const auto& view : result) {
+    EXPECT_TRUE(view.Name().starts_with("Engine"));
+    EXPECT_NE(view.Name().find("12"), std::string_view::npos);
+  }
+  EXPECT_EQ(catalog->Search("ine49998").size(), 1);
+  EXPECT_EQ(catalog->Search("Vehicle", 10).size(), 10);
+}
+
+TEST(Asap3Client, TestQuerySignals)  // NOLINT
+{
+  const auto filename =
+      (std::filesystem::temp_directory_path() / "asap_test_signals.a3mc")
+          .string();
+  std::filesystem::remove(filename);
+
+  MockServer server;
+  server.CreateParameters(300);
+  server.CreateSignals(170);
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  client->Port(server.Port());
+  client->DiscoverSignals(true);
+  client->MetadataCacheFile(filename);
+  size_t nof_signal_chunks = 0;
+  client->OnSignals([&](const A3ParameterList&, size_t, size_t total) {
+    EXPECT_EQ(total, 170);
+    ++nof_signal_chunks;
+  });
+  ASSERT_TRUE(client->Start());
+  EXPECT_EQ(nof_signal_chunks, 4);  // 3 * 50 + 20
+  EXPECT_EQ(client->ParameterList().size(), 300);
+  ASSERT_EQ(client->SignalList().size(), 170);
+  EXPECT_EQ(client->SignalList()[169].Name(), "Sig170");
+  EXPECT_EQ(client->SignalList()[169].Unit(), "V");
+  const auto catalog = client->SignalCatalog();
+  ASSERT_TRUE(catalog);
+  EXPECT_EQ(catalog->FindName("sig42"), 41);
+  EXPECT_TRUE(client->Stop());
+
+  // The signals are stored in the cache
+  auto warm =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::QueryCtParameters);
+  warm->Port(server.Port());
+  warm->DiscoverSignals(true);
+  warm->MetadataCacheFile(filename);
+  ASSERT_TRUE(warm->Start());
+  EXPECT_TRUE(warm->IsMetadataCached());
+  EXPECT_EQ(warm->SignalList().size(), 170);
+  EXPECT_TRUE(warm->Stop());
+
+  server.Stop();
+  std::filesystem::remove(filename);
+}
+
+TEST(Asap3Helper, TestMc3Array)  // NOLINT
+{
+  const std::vector<float> float_list = {1.5F, -2.25F, 1000.0F, 0.0F, 3.0F};
+  const std::vector<uint16_t> word_list = {1, 0x1234, 0xFFFF};
+  std::vector<uint8_t> body;
+  auto offset = Asap3Helper::FromMc3Array(
+      body, 0, std::span<const uint16_t>(word_list));
+  EXPECT_EQ(offset, 6);
+  offset += Asap3Helper::FromMc3Array(body, offset,
+                                      std::span<const float>(float_list));
+  EXPECT_EQ(body.size(), 26);
+
+  // Same encoding as the single value functions
+  uint16_t word = 0;
+  Asap3Helper::ToMc3Value(body, 2, word);
+  EXPECT_EQ(word, 0x1234);
+  EXPECT_EQ(body[2], 0x12);
+  float value = 0.0F;
+  Asap3Helper::ToMc3Value(body, 6 + 4, value);
+  EXPECT_FLOAT_EQ(value, -2.25F);
+
+  std::vector<uint16_t> word_result(word_list.size(), 0);
+  std::vector<float> float_result(float_list.size(), 0.0F);
+  offset = Asap3Helper::ToMc3Array(body, 0, std::span<uint16_t>(word_result));
+  Asap3Helper::ToMc3Array(body, offset, std::span<float>(float_result));
+  EXPECT_EQ(word_result, word_list);
+  EXPECT_EQ(float_result, float_list);
+}
+
+TEST(Asap3Client, TestCharacteristic)  // NOLINT
+{
+  Characteristic map("Map1", Mc3CharType::MAP, {32, 32});
+  for (size_t x = 0; x < 32; ++x) {
+    map.Axis(0)[x] = static_cast<float>(x * 100);
+    map.Axis(1)[x] = static_cast<float>(x);
+  }
+  EXPECT_EQ(map.NofValues(), 1024);
+  EXPECT_EQ(map.NofAxes(), 2);
+
+  MockServer server;
+  server.AddCharacteristic(map);
+  server.AddCharacteristic(Characteristic("Curve1", Mc3CharType::CURVE, {8}));
+  ASSERT_TRUE(server.Start());
+
+  auto client = Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  CharacteristicInfo info;
+  client->GetCharacteristicInfo(
+      0, "Map1", [&](bool success, const CharacteristicInfo& result) {
+        EXPECT_TRUE(success);
+        info = result;
+      });
+
+  // One frame from a contiguous array
+  std::vector<float> value_list(1024);
+  for (size_t index = 0; index < value_list.size(); ++index) {
+    value_list[index] = static_cast<float>(index) * 0.5F;
+  }
+  const std::vector<uint16_t> dimension_list = {32, 32};
+  EXPECT_TRUE(client->WriteCharacteristic(0, "Map1", Mc3CharType::MAP,
+                                          dimension_list, value_list));
+  EXPECT_FALSE(client->WriteCharacteristic(0, "Map1", Mc3CharType::MAP,
+                                           dimension_list, {}));
+
+  const std::vector<uint16_t> start_list = {2, 3};
+  const std::vector<uint16_t> count_list = {4, 2};
+  const std::vector<float> cell_list = {-1, -2, -3, -4, -5, -6, -7, -8};
+  EXPECT_TRUE(client->WriteCellValues(0, "Map1", start_list, count_list,
+                                      cell_list));
+
+  Characteristic result;
+  client->ReadCharacteristic(
+      0, "Map1", [&](bool success, const Characteristic& characteristic) {
+        EXPECT_TRUE(success);
+        result = characteristic;
+      });
+  std::vector<float> read_list;
+  EXPECT_TRUE(client->ReadCellValues(
+      0, "Map1", start_list, count_list,
+      [&](bool success, std::span<const float> values) {
+        EXPECT_TRUE(success);
+        read_list.assign(values.begin(), values.end());
+      }));
+  const std::vector<uint16_t> short_list = {0};
+  EXPECT_FALSE(client->ReadCellValues(
+      0, "Map1", start_list, short_list,
+      [](bool, std::span<const float>) { ADD_FAILURE(); }));
+  bool unknown = true;
+  client->ReadCharacteristic(
+      0, "Unknown", [&](bool success, const Characteristic&) {
+        unknown = success;
+      });
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  EXPECT_EQ(info.type, Mc3CharType::MAP);
+  EXPECT_EQ(info.dimension_list, dimension_list);
+  EXPECT_FLOAT_EQ(info.max, 1000.0F);
+
+  EXPECT_EQ(result.Name(), "Map1");
+  EXPECT_EQ(result.Type(), Mc3CharType::MAP);
+  ASSERT_EQ(result.NofValues(), 1024);
+  EXPECT_FLOAT_EQ(result.Axis(0)[31], 3100.0F);
+  EXPECT_FLOAT_EQ(result.At(0, 1), 16.0F);
+  EXPECT_FLOAT_EQ(result.At(2, 3), -1.0F);
+  EXPECT_FLOAT_EQ(result.At(5, 4), -8.0F);
+  EXPECT_EQ(read_list, cell_list);
+  EXPECT_FALSE(unknown);
+
+  const auto server_map = server.GetCharacteristic("Map1");
+  EXPECT_FLOAT_EQ(server_map.At(31, 31), 1023 * 0.5F);
+  EXPECT_FLOAT_EQ(server_map.At(3, 4), -6.0F);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(CalibrationShadow, TestDiff)  // NOLINT
+{
+  std::vector<float> previous(20, 1.0F);
+  auto current = previous;
+  EXPECT_TRUE(CalibrationShadow::Diff(previous, current, 10, 2).empty());
+
+  current[1] = 2.0F;
+  current[3] = 2.0F;  // Gap of 1 is merged
+  current[7] = 2.0F;  // Gap of 3 is not
+  current[9] = 2.0F;
+  current[10] = 2.0F;  // Next row
+  const auto run_list = CalibrationShadow::Diff(previous, current, 10, 2);
+  ASSERT_EQ(run_list.size(), 3);
+  EXPECT_EQ(run_list[0].first, 1);
+  EXPECT_EQ(run_list[0].count, 3);
+  EXPECT_EQ(run_list[1].first, 7);
+  EXPECT_EQ(run_list[1].count, 3);
+  EXPECT_EQ(run_list[2].first, 10);
+  EXPECT_EQ(run_list[2].count, 1);
+
+  CalibrationShadow shadow;
+  const std::vector<uint16_t> dimension_list = {10, 2};
+  CellRunList update_list;
+  EXPECT_FALSE(shadow.Update(0, "Map1", Mc3CharType::MAP, dimension_list,
+                             previous, 2, update_list));
+  EXPECT_TRUE(shadow.Contains(0, "Map1"));
+  EXPECT_TRUE(shadow.Update(0, "Map1", Mc3CharType::MAP, dimension_list,
+                            current, 2, update_list));
+  EXPECT_EQ(update_list.size(), 3);
+  EXPECT_TRUE(shadow.Update(0, "Map1", Mc3CharType::MAP, dimension_list,
+                            current, 2, update_list));
+  EXPECT_TRUE(update_list.empty());
+
+  // Another LUN has its own copy
+  EXPECT_FALSE(shadow.Contains(1, "Map1"));
+  EXPECT_FALSE(shadow.Update(1, "Map1", Mc3CharType::MAP, dimension_list,
+                             previous, 2, update_list));
+  EXPECT_EQ(shadow.Size(), 2);
+  shadow.Clear(1);
+  EXPECT_FALSE(shadow.Contains(1, "Map1"));
+  EXPECT_TRUE(shadow.Contains(0, "Map1"));
+
+  EXPECT_LT(CalibrationShadow::CellFrameSize("Map1", 2, 3),
+            CalibrationShadow::CharacteristicFrameSize("Map1", 2, 20));
+}
+
+TEST(Asap3Client, TestDeltaWrite)  // NOLINT
+{
+  MockServer server;
+  server.AddCharacteristic(Characteristic("Map1", Mc3CharType::MAP, {32, 32}));
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  // The read creates the shadow copy
+  Characteristic map;
+  client->ReadCharacteristic(
+      0, "Map1",
+      [&](bool, const Characteristic& characteristic) {
+        map = characteristic;
+      });
+  ASSERT_TRUE(client->WaitOnIdle());
+  ASSERT_EQ(map.NofValues(), 1024);
+  EXPECT_TRUE(client->Shadow().Contains(0, "Map1"));
+
+  // A few cells in different rows
+  map.At(1, 0) = 1.0F;
+  map.At(2, 0) = 2.0F;
+  map.At(10, 5) = 3.0F;
+  map.At(31, 31) = 4.0F;
+  size_t nof_done = 0;
+  EXPECT_TRUE(client->UpdateCharacteristic(0, map, [&](bool success) {
+    EXPECT_TRUE(success);
+    ++nof_done;
+  }));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(nof_done, 1);
+  EXPECT_EQ(server.NofCellWrites(), 3);
+  EXPECT_EQ(server.NofCharacteristicWrites(), 0);
+
+  // Nothing changed
+  EXPECT_TRUE(client->UpdateCharacteristic(0, map, [&](bool success) {
+    EXPECT_TRUE(success);
+    ++nof_done;
+  }));
+  EXPECT_EQ(nof_done, 2);
+
+  // Dense change
+  for (auto& value : map.Values()) {
+    value += 0.5F;
+  }
+  EXPECT_TRUE(client->UpdateCharacteristic(0, map));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofCellWrites(), 3);
+  EXPECT_EQ(server.NofCharacteristicWrites(), 1);
+
+  const auto server_map = server.GetCharacteristic("Map1");
+  EXPECT_FLOAT_EQ(server_map.At(10, 5), 3.5F);
+  EXPECT_FLOAT_EQ(server_map.At(31, 31), 4.5F);
+  EXPECT_FLOAT_EQ(server_map.At(0, 0), 0.5F);
+
+  // The same name on another LUN isn't compared with the LUN 0 copy
+  map.At(3, 3) = 5.0F;
+  EXPECT_TRUE(client->UpdateCharacteristic(1, map));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofCellWrites(), 3);
+  EXPECT_EQ(server.NofCharacteristicWrites(), 2);
+  EXPECT_TRUE(client->Shadow().Contains(1, "Map1"));
+  map.At(3, 3) = 6.0F;
+  EXPECT_TRUE(client->UpdateCharacteristic(0, map));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofCellWrites(), 4);
+
+  // A failed write removes the shadow
+  Characteristic unknown("Unknown", Mc3CharType::CURVE, {4});
+  bool unknown_success = true;
+  EXPECT_TRUE(client->UpdateCharacteristic(
+      0, unknown, [&](bool success) { unknown_success = success; }));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FALSE(unknown_success);
+  EXPECT_FALSE(client->Shadow().Contains(0, "Unknown"));
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestCalibrationCache)  // NOLINT
+{
+  MockServer server;
+  server.AddCharacteristic(Characteristic("Map1", Mc3CharType::MAP, {8, 8}));
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  CalPageList page_list;
+  client->GetCalPageInfo(0, [&](bool success, const CalPageList& list) {
+    EXPECT_TRUE(success);
+    page_list = list;
+  });
+  client->GetCurrentCalPage(0, [](bool success, uint16_t page) {
+    EXPECT_TRUE(success);
+    EXPECT_EQ(page, 0);
+  });
+  ASSERT_TRUE(client->WaitOnIdle());
+  ASSERT_EQ(page_list.size(), 2);
+  EXPECT_EQ(page_list[1].name, "Reference");
+  EXPECT_EQ(page_list[0].properties, 1);
+
+  size_t nof_reads = 0;
+  auto read = [&]() {
+    client->ReadCharacteristic(0, "Map1",
+                               [&](bool success, const Characteristic&) {
+                                 EXPECT_TRUE(success);
+                                 ++nof_reads;
+                               });
+    client->GetCharacteristicInfo(0, "Map1",
+                                  [](bool success, const CharacteristicInfo&) {
+                                    EXPECT_TRUE(success);
+                                  });
+    EXPECT_TRUE(client->WaitOnIdle());
+  };
+
+  // The second read is served from the cache
+  read();
+  const auto nof_requests = server.NofRequests();
+  read();
+  EXPECT_EQ(server.NofRequests(), nof_requests);
+  EXPECT_EQ(nof_reads, 2);
+  EXPECT_GE(client->CalCache().Hits(), 2);
+
+  // The same name on another LUN is not served from the LUN 0 cache
+  client->ReadCharacteristic(1, "Map1", [](bool success, const Characteristic&) {
+    EXPECT_TRUE(success);
+  });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofRequests(), nof_requests + 1);
+  EXPECT_TRUE(client->CalCache().Value(1, "Map1"));
+
+  // A write invalidates the values but not the info
+  std::vector<float> value_list(64, 1.0F);
+  const std::vector<uint16_t> dimension_list = {8, 8};
+  EXPECT_TRUE(client->WriteCharacteristic(0, "Map1", Mc3CharType::MAP,
+                                          dimension_list, value_list));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FALSE(client->CalCache().Value(0, "Map1"));
+  Characteristic result;
+  client->ReadCharacteristic(
+      0, "Map1", [&](bool, const Characteristic& map) { result = map; });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FLOAT_EQ(result.At(7, 7), 1.0F);
+  EXPECT_TRUE(client->CalCache().Value(0, "Map1"));
+
+  // A page switch
+  server.CurrentPage(1);
+  client->GetCurrentCalPage(0, [](bool, uint16_t page) { EXPECT_EQ(page, 1); });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FALSE(client->CalCache().Value(0, "Map1"));
+  EXPECT_FALSE(client->Shadow().Contains(0, "Map1"));
+
+  // The server reports changed measurement data
+  read();
+  EXPECT_TRUE(client->CalCache().Value(0, "Map1"));
+  server.MeasuringDataChanged();
+  client->GetCurrentCalPage(0, [](bool success, uint16_t) {
+    EXPECT_FALSE(success);
+  });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FALSE(client->CalCache().Value(0, "Map1"));
+  CharacteristicInfo info;
+  EXPECT_FALSE(client->CalCache().FindInfo(0, "Map1", info));
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(TensorView, TestSlice)  // NOLINT
+{
+  Characteristic cube("Cube1", Mc3CharType::CUBE3D, {4, 3, 2});
+  EXPECT_EQ(cube.NofAxes(), 3);
+  EXPECT_EQ(cube.NofValues(), 24);
+  auto tensor = cube.Tensor();
+  for (size_t index = 0; index < cube.NofValues(); ++index) {
+    cube.Values()[index] = static_cast<float>(index);
+  }
+  EXPECT_EQ(tensor.Rank(), 3);
+  EXPECT_FLOAT_EQ(tensor(1, 2, 1), 1 + 2 * 4 + 1 * 12);
+
+  // A plane is contiguous, a column isn't
+  const auto plane = tensor.Slice(2, 1);
+  EXPECT_EQ(plane.Size(), 12);
+  EXPECT_TRUE(plane.IsContiguous());
+  EXPECT_EQ(plane.Contiguous().data(), cube.Values().data() + 12);
+
+  const auto column = tensor.Slice(0, 3).Slice(2, 0);
+  EXPECT_EQ(column.Size(), 3);
+  EXPECT_FALSE(column.IsContiguous());
+  std::vector<float> value_list(column.Size());
+  column.CopyTo(value_list);
+  EXPECT_EQ(value_list, std::vector<float>({3, 7, 11}));
+
+  std::vector<uint16_t> start_list;
+  std::vector<uint16_t> count_list;
+  column.CellRange(start_list, count_list);
+  EXPECT_EQ(start_list, std::vector<uint16_t>({3, 0, 0}));
+  EXPECT_EQ(count_list, std::vector<uint16_t>({1, 3, 1}));
+
+  const std::vector<float> new_list = {-1, -2, -3};
+  column.CopyFrom(new_list);
+  EXPECT_FLOAT_EQ(cube.Values()[7], -2.0F);
+
+  const TensorView<const float> const_view = tensor.Range(1, 1, 5);
+  EXPECT_EQ(const_view.Shape(1), 2);  // Clipped
+  EXPECT_EQ(const_view.Origin(1), 1);
+  EXPECT_TRUE(tensor.Range(1, 3, 1).Empty());
+
+  Characteristic block("Block1", Mc3CharType::VALBLK_2D, {5, 5});
+  EXPECT_EQ(block.NofAxes(), 0);
+  EXPECT_EQ(block.Tensor().Size(), 25);
+}
+
+TEST(Asap3Client, TestCubeCells)  // NOLINT
+{
+  Characteristic cube("Cube1", Mc3CharType::CUBE3D, {8, 4, 3});
+  MockServer server;
+  server.AddCharacteristic(cube);
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  // Write one plane and one (strided) column
+  auto tensor = cube.Tensor();
+  const auto plane = tensor.Slice(2, 1);
+  plane.ForEach([](float& value) { value = 5.0F; });
+  EXPECT_TRUE(client->WriteCellValues(0, "Cube1", plane));
+  const auto column = tensor.Slice(0, 7).Slice(2, 2);
+  column.ForEach([](float& value) { value = -1.0F; });
+  EXPECT_TRUE(client->WriteCellValues(0, "Cube1", column));
+
+  // Read back into another cube
+  Characteristic result("Cube1", Mc3CharType::CUBE3D, {8, 4, 3});
+  bool read = false;
+  client->ReadCellValues(0, "Cube1", result.Tensor().Slice(2, 1),
+                         [&](bool success) { read = success; });
+  bool column_read = false;
+  client->ReadCellValues(0, "Cube1", result.Tensor().Slice(0, 7).Slice(2, 2),
+                         [&](bool success) { column_read = success; });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(read);
+  EXPECT_TRUE(column_read);
+  EXPECT_EQ(result.Values()[32], 5.0F);
+  EXPECT_EQ(result.Tensor()(7, 3, 2), -1.0F);
+  EXPECT_EQ(result.Tensor()(6, 3, 2), 0.0F);
+
+  const auto server_cube = server.GetCharacteristic("Cube1");
+  EXPECT_EQ(server_cube.Tensor()(3, 2, 1), 5.0F);
+  EXPECT_EQ(server_cube.Tensor()(7, 0, 2), -1.0F);
+  EXPECT_EQ(server_cube.Tensor()(7, 0, 0), 0.0F);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestLookupTables)  // NOLINT
+{
+  constexpr size_t kNofTables = 20;
+  MockServer server;
+  std::vector<std::string> name_list;
+  for (size_t table = 0; table < kNofTables; ++table) {
+    const auto name = "Map" + std::to_string(table);
+    server.AddCharacteristic(Characteristic(name, Mc3CharType::MAP, {6, 4}));
+    name_list.push_back(name);
+  }
+  server.AddCharacteristic(Characteristic("Curve1", Mc3CharType::CURVE, {5}));
+  ASSERT_TRUE(server.Start());
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  // Unknown tables are selected before the values are sent
+  LookupTableList put_list;
+  for (size_t table = 0; table < kNofTables; ++table) {
+    LookupTable lookup{
+        .name = name_list[table], .x_dim = 6, .y_dim = 4, .value_list = {}};
+    lookup.value_list.assign(24, static_cast<float>(table));
+    put_list.push_back(std::move(lookup));
+  }
+  bool put = false;
+  client->PutLookupTables(0, put_list, [&](bool success, const auto& list) {
+    put = success && list.size() == kNofTables;
+  });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(put);
+  EXPECT_EQ(server.NofLookupRequests(), 2 * kNofTables);
+  EXPECT_EQ(server.GetCharacteristic("Map7").At(5, 3), 7.0F);
+
+  const LookupTableIncreaseList increase_list = {
+      {.name = "Map3", .x_start = 1, .y_start = 2, .x_count = 2,
+       .value = 0.5F},
+      {.name = "Map4", .mode = Mc3ValueType::FACTOR, .y_count = 4,
+       .value = 3.0F},
+      {.name = "Curve1", .mode = Mc3ValueType::VALUE, .x_start = 4,
+       .value = -2.0F},
+  };
+  bool increased = false;
+  client->IncreaseLookupTables(
+      0, increase_list, [&](bool success, const auto&) { increased = success; });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(increased);
+
+  LookupTableList get_list;
+  name_list.push_back("Curve1");
+  client->GetLookupTables(0, name_list, [&](bool success, const auto& list) {
+    if (success) {
+      get_list = list;
+    }
+  });
+  ASSERT_TRUE(client->WaitOnIdle());
+  ASSERT_EQ(get_list.size(), kNofTables + 1);
+  // The selected addresses are reused
+  EXPECT_EQ(server.NofLookupRequests(), 3 * kNofTables + 5);
+
+  const auto& map3 = get_list[3];
+  EXPECT_EQ(map3.x_dim, 6);
+  EXPECT_EQ(map3.y_dim, 4);
+  EXPECT_EQ(map3.value_list[1 + 2 * 6], 3.5F);
+  EXPECT_EQ(map3.value_list[3 + 2 * 6], 3.0F);
+  EXPECT_EQ(get_list[4].value_list[0], 12.0F);
+  EXPECT_EQ(get_list[4].value_list[1], 4.0F);
+  EXPECT_EQ(get_list[9].value_list[23], 9.0F);
+  EXPECT_EQ(get_list.back().y_dim, 1);
+  EXPECT_EQ(get_list.back().value_list[4], -2.0F);
+
+  // A page switch forgets the selected addresses
+  client->GetCurrentCalPage(0, [](bool, uint16_t) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  server.CurrentPage(1);
+  client->GetCurrentCalPage(0, [](bool, uint16_t) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  const auto nof_lookup = server.NofLookupRequests();
+  client->GetLookupTables(0, {"Map1"}, [](bool, const auto&) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofLookupRequests(), nof_lookup + 2);
+
+  // The addresses are selected per LUN
+  client->GetLookupTables(1, {"Map1"}, [](bool, const auto&) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofLookupRequests(), nof_lookup + 4);
+  client->GetLookupTables(0, {"Map1"}, [](bool, const auto&) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofLookupRequests(), nof_lookup + 5);
+
+  // A page switch on LUN 1 keeps the LUN 0 addresses
+  client->GetCurrentCalPage(1, [](bool, uint16_t) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  server.CurrentPage(0);
+  client->GetCurrentCalPage(1, [](bool, uint16_t) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  client->GetLookupTables(0, {"Map1"}, [](bool, const auto&) {});
+  client->GetLookupTables(1, {"Map1"}, [](bool, const auto&) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofLookupRequests(), nof_lookup + 8);
+
+  bool unknown = true;
+  client->GetLookupTables(0, {"Unknown"}, [&](bool success, const auto& list) {
+    unknown = success || list.front().valid;
+  });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FALSE(unknown);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestSetPoints)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(20);
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  for (size_t index = 0; index < 20; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index + 1));
+    parameter.SetPoint(index < 5);
+    parameter.LunNo(index == 2 ? 1 : 0);
+    parameter_list.push_back(parameter);
+  }
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->ParameterList(parameter_list);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->StartSubscription(0));
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_FALSE(client->SetPointValue("Par10", 1.0F));
+
+  // Last write wins and all values go in one frame
+  for (int value = 0; value < 1000; ++value) {
+    EXPECT_TRUE(client->SetPointValue("Par1", static_cast<float>(value)));
+  }
+  EXPECT_TRUE(client->SetPointValue("par2", 2.5F));
+  EXPECT_EQ(client->FlushSetPoints(), 2);
+  EXPECT_EQ(client->FlushSetPoints(), 0);
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofSetPointRequests(), 1);
+  EXPECT_EQ(server.SetPointValue("Par1"), 999.0F);
+  EXPECT_EQ(server.SetPointValue("Par2"), 2.5F);
+  EXPECT_EQ(client->Metrics().setpoints_coalesced, 999);
+  EXPECT_EQ(std::any_cast<float>(client->OutputValues()[0].value), 999.0F);
+
+  client->BatchSetPoints(false);
+  EXPECT_TRUE(client->SetPointValue(3, 3.0F));
+  EXPECT_TRUE(client->SetPointValue(4, 4.0F));
+  EXPECT_EQ(client->FlushSetPoints(), 2);
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofSetPointRequests(), 3);
+  EXPECT_EQ(server.SetPointValue("Par5"), 4.0F);
+
+  // One frame per LUN
+  client->BatchSetPoints(true);
+  EXPECT_TRUE(client->SetPointValue("Par2", 5.0F));
+  EXPECT_TRUE(client->SetPointValue("Par3", 6.0F));
+  EXPECT_EQ(client->FlushSetPoints(), 2);
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofSetPointRequests(), 5);
+  EXPECT_EQ(server.SetPointValue("Par3"), 6.0F);
+
+  // A failed frame is sent again by the next flush
+  server.MeasuringDataChanged();
+  EXPECT_TRUE(client->SetPointValue("Par4", 7.0F));
+  EXPECT_EQ(client->FlushSetPoints(), 1);
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofSetPointRequests(), 5);
+  EXPECT_EQ(client->FlushSetPoints(), 1);
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.SetPointValue("Par4"), 7.0F);
+  EXPECT_TRUE(client->Stop());
+
+  // Periodic flush from a 1 kHz control loop
+  auto periodic =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  periodic->Port(server.Port());
+  periodic->ParameterList(parameter_list);
+  periodic->SetPointPeriod(std::chrono::milliseconds(1));
+  ASSERT_TRUE(periodic->Start());
+  ASSERT_TRUE(periodic->WaitOnIdle());
+  EXPECT_TRUE(periodic->StartSubscription(0));
+  ASSERT_TRUE(periodic->WaitOnIdle());
+  const auto requests = server.NofSetPointRequests();
+  for (int value = 1; value <= 200; ++value) {
+    for (size_t index = 0; index < 5; ++index) {
+      periodic->SetPointValue(index, static_cast<float>(value));
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_TRUE(periodic->WaitOnIdle());
+  EXPECT_EQ(server.SetPointValue("Par4"), 200.0F);
+  EXPECT_LT(server.NofSetPointRequests() - requests, 200);
+  EXPECT_LE(periodic->Metrics().queue_high_water, 3);
+
+  EXPECT_TRUE(periodic->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestUnacknowledgedSetPoints)  // NOLINT
+{
+  constexpr auto kLatency = std::chrono::milliseconds(5);
+  MockServer server;
+  server.CreateParameters(10);
+  server.AddCharacteristic(Characteristic("Map1", Mc3CharType::MAP, {6, 4}));
+  server.Latency(kLatency);
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  for (const auto* name : {"Par1", "Par2", "Missing"}) {
+    A3Parameter parameter;
+    parameter.Name(name);
+    parameter.SetPoint(true);
+    parameter_list.push_back(parameter);
+  }
+
+  auto client = Asap3Factory::CreateAsap3Client(Asap3ClientType::CtAsap3Client);
+  client->Port(server.Port());
+  client->ParameterList(parameter_list);
+  std::atomic<int> nof_errors = 0;
+  client->OnAsyncError([&](CommandCode cmd, uint16_t, const std::string&) {
+    if (cmd == CommandCode::SET_PARAMETER) {
+      ++nof_errors;
+    }
+  });
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->Unacknowledged(CommandCode::SET_PARAMETER));
+  EXPECT_FALSE(client->Unacknowledged(CommandCode::GET_ONLINE_VALUE));
+  EXPECT_TRUE(client->StartSubscription(0));
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  // Each set-point is sent without waiting on the round-trip
+  client->BatchSetPoints(false);
+  const auto values = server.NofSetPointValues();
+  const auto start = std::chrono::steady_clock::now();
+  for (int value = 1; value <= 100; ++value) {
+    EXPECT_TRUE(client->SetPointValue("Par1", static_cast<float>(value)));
+    while (client->FlushSetPoints() == 0) {
+      std::this_thread::yield();
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, 100 * kLatency / 2);
+  for (int wait = 0; wait < 100 && server.NofSetPointValues() < values + 100;
+       ++wait) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(server.NofSetPointValues(), values + 100);
+  EXPECT_EQ(server.SetPointValue("Par1"), 100.0F);
+
+  // Errors are still reported
+  EXPECT_TRUE(client->SetPointValue("Missing", 1.0F));
+  while (client->FlushSetPoints() == 0) {
+    std::this_thread::yield();
+  }
+  for (int wait = 0; wait < 100 && nof_errors == 0; ++wait) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(nof_errors, 1);
+  EXPECT_EQ(client->Metrics().async_errors, 1);
+
+  // Acknowledged commands are still matched with their responses
+  bool identified = false;
+  client->SendTelegram(CommandCode::IDENTIFY,
+                       {{"Version", Mc3DataType::A_UINT16,
+                         static_cast<uint16_t>(768)},
+                        {"Name", Mc3DataType::MC3_STRING, std::string("CT")}},
+                       [&](bool success, const ITelegram&) {
+                         identified = success;
+                       });
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(identified);
+
+  // An unacknowledged set-point also reports changed measuring data
+  client->GetLookupTables(0, {"Map1"}, [](bool, const auto&) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  const auto nof_lookup = server.NofLookupRequests();
+  server.MeasuringDataChanged();
+  EXPECT_TRUE(client->SetPointValue("Par2", 1.0F));
+  while (client->FlushSetPoints() == 0) {
+    std::this_thread::yield();
+  }
+  client->GetCurrentCalPage(0, [](bool, uint16_t) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  client->GetLookupTables(0, {"Map1"}, [](bool, const auto&) {});
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(server.NofLookupRequests(), nof_lookup + 2);
+  EXPECT_EQ(nof_errors, 1);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Client, TestSetPointReconnect)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(2);
+  server.Latency(std::chrono::milliseconds(200));
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  A3Parameter parameter;
+  parameter.Name("Par1");
+  parameter.SetPoint(true);
+  parameter_list.push_back(parameter);
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->ParameterList(parameter_list);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->StartSubscription(0));
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  // The frame is dropped with the connection and sent again after it
+  EXPECT_TRUE(client->SetPointValue("Par1", 42.0F));
+  EXPECT_EQ(client->FlushSetPoints(), 1);
+  server.Stop();
+  for (int wait = 0; wait < 100 && client->IsConnected(); ++wait) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_FALSE(client->IsConnected());
+
+  MockServer restarted;
+  restarted.CreateParameters(2);
+  restarted.Port(server.Port());
+  ASSERT_TRUE(restarted.Start());
+  for (int wait = 0; wait < 1500 && !client->IsConnected(); ++wait) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(client->IsConnected());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(client->FlushSetPoints(), 1);
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(restarted.SetPointValue("Par1"), 42.0F);
+
+  EXPECT_TRUE(client->Stop());
+  restarted.Stop();
+}
+
+TEST(SharedValues, TestSeqlock)  // NOLINT
+{
+  constexpr size_t kNofValues = 256;
+  constexpr int kNofWrites = 20'000;
+  SharedValueWriter writer;
+  ASSERT_TRUE(writer.Create("asap3_test_seqlock", kNofValues));
+  SharedValueReader reader;
+  ASSERT_TRUE(reader.Open("asap3_test_seqlock"));
+  EXPECT_FALSE(reader.Open("asap3_test_missing"));
+  ASSERT_TRUE(reader.Open("asap3_test_seqlock"));
+
+  // All values in a snapshot must come from the same write
+  std::thread thread([&] {
+    std::vector<double> value_list(kNofValues, 0.0);
+    for (int write = 1; write <= kNofWrites; ++write) {
+      std::ranges::fill(value_list, static_cast<double>(write));
+      writer.Write(value_list);
+    }
+  });
+  std::vector<double> value_list;
+  double last = 0.0;
+  size_t torn = 0;
+  while (last < kNofWrites) {
+    if (!reader.Read(value_list) || value_list.empty()) {
+      continue;
+    }
+    if (std::ranges::any_of(value_list, [&](double value) {
+          return value != value_list.front();
+        })) {
+      ++torn;
+    }
+    EXPECT_GE(value_list.front(), last);
+    last = value_list.front();
+  }
+  thread.join();
+  EXPECT_EQ(torn, 0);
+  EXPECT_EQ(reader.Sequence(), 2 * kNofWrites);
+  EXPECT_FALSE(writer.Write(std::vector<double>(kNofValues + 1, 0.0)));
+}
+
+TEST(Asap3Client, TestSharedMemory)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(20);
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  for (size_t index = 0; index < 20; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index + 1));
+    parameter_list.push_back(parameter);
+  }
+
+  auto client = Asap3Factory::CreateAsap3Client(Asap3ClientType::CtAsap3Client);
+  client->Port(server.Port());
+  client->ParameterList(parameter_list);
+  client->UseSharedMemory(true);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->IsSharedMemory());
+  EXPECT_TRUE(client->StartSubscription(0));
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  // The subscription itself publishes the first values
+  EXPECT_TRUE(client->ReadSharedValues());
+  server.PublishSharedValues();
+  EXPECT_TRUE(client->ReadSharedValues());
+  const auto value_list = client->OnlineValues();
+  ASSERT_EQ(value_list.size(), 20);
+  for (size_t index = 0; index < value_list.size(); ++index) {
+    EXPECT_FLOAT_EQ(std::any_cast<float>(value_list[index].value),
+                    static_cast<float>(index + 1));
+  }
+  EXPECT_EQ(server.NofOnlineRequests(), 0);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(OnlineTable, TestDoubleBuffer)  // NOLINT
+{
+  OnlineTableWriter writer;
+  ASSERT_TRUE(writer.Create("asap3_test_online", 8));
+  OnlineTableReader reader;
+  EXPECT_FALSE(reader.Open("asap3_test_missing"));
+  ASSERT_TRUE(reader.Open("asap3_test_online"));
+
+  std::vector<SharedParameter> parameter_list(3);
+  for (size_t index = 0; index < parameter_list.size(); ++index) {
+    const auto name = "Par" + std::to_string(index + 1);
+    name.copy(parameter_list[index].name, sizeof(SharedParameter::name) - 1);
+    parameter_list[index].index = static_cast<uint32_t>(index);
+  }
+  EXPECT_FALSE(writer.WriteParameters(std::vector<SharedParameter>(9)));
+  ASSERT_TRUE(writer.WriteParameters(parameter_list));
+  const auto generation = reader.Generation();
+  EXPECT_EQ(generation, writer.Generation());
+
+  std::vector<SharedParameter> read_list;
+  uint64_t read_generation = 0;
+  ASSERT_TRUE(reader.ReadParameters(read_list, &read_generation));
+  ASSERT_EQ(read_list.size(), 3);
+  EXPECT_STREQ(read_list[2].name, "Par3");
+  EXPECT_EQ(read_generation, generation);
+
+  EXPECT_FALSE(writer.WriteValues(std::vector<double>(2, 0.0)));
+  ASSERT_TRUE(writer.WriteValues(std::vector<double>{1.0, 2.0, 3.0}));
+  const auto view = reader.Latest();
+  ASSERT_EQ(view.value_list.size(), 3);
+  EXPECT_DOUBLE_EQ(view.value_list[1], 2.0);
+  EXPECT_TRUE(reader.IsValid(view));
+
+  // The writer fills the other buffer first, so the view is valid until
+  // the write after next begins.
+  ASSERT_TRUE(writer.WriteValues(std::vector<double>{4.0, 5.0, 6.0}));
+  EXPECT_TRUE(reader.IsValid(view));
+  EXPECT_DOUBLE_EQ(view.value_list[1], 2.0);
+  ASSERT_TRUE(writer.WriteValues(std::vector<double>{7.0, 8.0, 9.0}));
+  EXPECT_FALSE(reader.IsValid(view));
+
+  std::vector<double> value_list;
+  ASSERT_TRUE(reader.Read(value_list));
+  EXPECT_EQ(value_list, (std::vector<double>{7.0, 8.0, 9.0}));
+
+  // New parameters invalidate all views
+  const auto last = reader.Latest();
+  ASSERT_TRUE(writer.WriteParameters(parameter_list));
+  EXPECT_FALSE(reader.IsValid(last));
+  EXPECT_EQ(reader.Generation(), generation + 1);
+}
+
+TEST(Asap3Client, TestExportOnlineValues)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(10);
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  for (size_t index = 0; index < 10; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index + 1));
+    parameter.SetPoint(index == 9);
+    parameter_list.push_back(parameter);
+  }
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->ParameterList(parameter_list);
+  client->ExportName("asap3_test_export");
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->StartSubscription(0));
+  client->SendTelegram(CommandCode::GET_ONLINE_VALUE, {});
+  ASSERT_TRUE(client->WaitOnIdle());
+
+  OnlineTableReader reader;
+  ASSERT_TRUE(reader.Open("asap3_test_export"));
+  std::vector<SharedParameter> shared_list;
+  ASSERT_TRUE(reader.ReadParameters(shared_list));
+  ASSERT_EQ(shared_list.size(), 9);
+  EXPECT_STREQ(shared_list[8].name, "Par9");
+
+  std::vector<double> value_list;
+  ASSERT_TRUE(reader.Read(value_list));
+  const auto online_list = client->OnlineValues();
+  ASSERT_EQ(value_list.size(), online_list.size());
+  for (const auto& shared : shared_list) {
+    EXPECT_DOUBLE_EQ(value_list[shared.index],
+                     std::any_cast<float>(online_list[shared.index].value));
+  }
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(Asap3Proxy, TestFanOut)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(20);
+  Characteristic curve("Curve1", Mc3CharType::CURVE, {8});
+  for (size_t index = 0; index < curve.NofValues(); ++index) {
+    curve.Values()[index] = static_cast<float>(index) * 2.0F;
+  }
+  server.AddCharacteristic(curve);
+  ASSERT_TRUE(server.Start());
+
+  Asap3Proxy proxy;
+  proxy.UpstreamPort(server.Port());
+  proxy.PollPeriod(std::chrono::milliseconds(1));
+  ASSERT_TRUE(proxy.Start());
+
+  // Two clients with overlapping subscriptions
+  std::vector<std::unique_ptr<IClient>> client_list;
+  for (size_t first : {0, 5}) {
+    A3ParameterList parameter_list;
+    for (size_t index = first; index < first + 10; ++index) {
+      A3Parameter parameter;
+      parameter.Name("Par" + std::to_string(index + 1));
+      parameter_list.push_back(parameter);
+    }
+    auto client =
+        Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+    client->Port(proxy.Port());
+    client->ParameterList(parameter_list);
+    ASSERT_TRUE(client->Start());
+    ASSERT_TRUE(client->WaitOnIdle());
+    EXPECT_EQ(client->RemoteName(), server.Name());
+    EXPECT_TRUE(client->StartSubscription(0));
+    ASSERT_TRUE(client->WaitOnIdle());
+    client_list.push_back(std::move(client));
+  }
+  EXPECT_EQ(proxy.Subscription().size(), 15);
+
+  // Poll until the merged acquisition has been read from the server. Each
+  // mock value is its parameter index plus the number of server polls.
+  for (auto& client : client_list) {
+    bool valid = false;
+    for (size_t poll = 0; poll < 500 && !valid; ++poll) {
+      client->SendTelegram(CommandCode::GET_ONLINE_VALUE, {});
+      ASSERT_TRUE(client->WaitOnIdle());
+      const auto value_list = client->OnlineValues();
+      valid = std::ranges::all_of(value_list, [](const DataValue& data) {
+        return std::any_cast<float>(data.value) >= 1.0F;
+      });
+    }
+    ASSERT_TRUE(valid);
+    const auto& parameter_list = client->ParameterList();
+    const auto value_list = client->OnlineValues();
+    ASSERT_EQ(value_list.size(), 10);
+    const auto first = std::stoi(parameter_list[0].Name().substr(3)) - 1;
+    const auto polls = std::any_cast<float>(value_list[0].value) -
+                       static_cast<float>(first);
+    for (size_t index = 0; index < value_list.size(); ++index) {
+      EXPECT_FLOAT_EQ(std::any_cast<float>(value_list[index].value),
+                      static_cast<float>(first + index) + polls);
+    }
+  }
+  // The downstream polls are served from the cache
+  EXPECT_LE(server.NofOnlineRequests(), proxy.NofUpstreamPolls());
+  EXPECT_GE(proxy.NofCacheHits(), 2);
+
+  // Everything else is forwarded
+  auto& client = *client_list.front();
+  Characteristic result;
+  client.ReadCharacteristic(
+      0, "Curve1", [&](bool success, const Characteristic& characteristic) {
+        EXPECT_TRUE(success);
+        result = characteristic;
+      });
+  ASSERT_TRUE(client.WaitOnIdle());
+  ASSERT_EQ(result.NofValues(), 8);
+  EXPECT_FLOAT_EQ(result.Values()[7], 14.0F);
+
+  // Service queries are cached and per-connection services are hidden
+  client.SendTelegram(CommandCode::QUERY_AVAILABLE_SERVICE, {});
+  ASSERT_TRUE(client.WaitOnIdle());
+  EXPECT_TRUE(client.HasService("Get Number of Parameters"));
+  EXPECT_FALSE(client.HasService("Disable SetValue Ack"));
+  const DataValueList service_list = {
+      {"Service", Mc3DataType::MC3_STRING,
+       std::string("Get Number of Parameters")},
+      {"Input", Mc3DataType::MC3_STRING, std::string()},
+  };
+  std::vector<std::string> output_list;
+  for (size_t call = 0; call < 2; ++call) {
+    client.SendTelegram(CommandCode::EXECUTE_SERVICE, service_list,
+                        [&](bool success, const ITelegram& telegram) {
+                          EXPECT_TRUE(success);
+                          output_list.push_back(
+                              telegram.Response()->GetData<std::string>(0));
+                        });
+    ASSERT_TRUE(client.WaitOnIdle());
+  }
+  const auto forwarded = proxy.NofForwarded();
+  client.SendTelegram(CommandCode::EXECUTE_SERVICE, service_list);
+  ASSERT_TRUE(client.WaitOnIdle());
+  EXPECT_EQ(proxy.NofForwarded(), forwarded);
+  EXPECT_EQ(output_list, std::vector<std::string>(2, "20"));
+
+  for (auto& downstream : client_list) {
+    EXPECT_TRUE(downstream->Stop());
+  }
+  proxy.Stop();
+  server.Stop();
+}
+
+TEST(Asap3Proxy, TestInvalidUntilPolled)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(5);
+  ASSERT_TRUE(server.Start());
+
+  // The proxy doesn't poll during the test
+  Asap3Proxy proxy;
+  proxy.UpstreamPort(server.Port());
+  proxy.PollPeriod(std::chrono::hours(1));
+  ASSERT_TRUE(proxy.Start());
+
+  A3ParameterList parameter_list;
+  for (size_t index = 0; index < 5; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index + 1));
+    parameter_list.push_back(parameter);
+  }
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(proxy.Port());
+  client->ParameterList(parameter_list);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->StartSubscription(0));
+  for (const auto command :
+       {CommandCode::GET_ONLINE_VALUE, CommandCode::GET_ONLINE_VALUE_EV2}) {
+    client->SendTelegram(command, {});
+    ASSERT_TRUE(client->WaitOnIdle());
+    const auto value_list = client->OnlineValues();
+    ASSERT_EQ(value_list.size(), 5);
+    for (const auto& value : value_list) {
+      EXPECT_EQ(std::any_cast<float>(value.value),
+                Asap3Helper::InvalidFloat());
+    }
+  }
+  EXPECT_EQ(server.NofOnlineRequests(), 0);
+
+  EXPECT_TRUE(client->Stop());
+  proxy.Stop();
+  server.Stop();
+}
+
+TEST(Asap3Client, TestTransports)  // NOLINT
+{
+  const auto socket_path =
+      (std::filesystem::temp_directory_path() / "asap3_test.sock").string();
+  std::vector<std::pair<TransportType, std::string>> transport_list = {
+      {TransportType::MemoryPipe, "asap3_test_pipe"}};
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  transport_list.emplace_back(TransportType::UnixSocket, socket_path);
+#endif
+
+  for (const auto& [type, address] : transport_list) {
+    MockServer server;
+    server.CreateParameters(20);
+    server.Transport(type);
+    server.Address(address);
+    ASSERT_TRUE(server.Start());
+
+    A3ParameterList parameter_list;
+    for (size_t index = 0; index < 20; ++index) {
+      A3Parameter parameter;
+      parameter.Name("Par" + std::to_string(index + 1));
+      parameter_list.push_back(parameter);
+    }
+
+    auto client =
+        Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+    client->Transport(type);
+    client->Address(address);
+    client->ParameterList(parameter_list);
+    ASSERT_TRUE(client->Start());
+    ASSERT_TRUE(client->WaitOnIdle());
+    EXPECT_TRUE(client->StartSubscription(0));
+    for (size_t poll = 0; poll < 10; ++poll) {
+      client->SendTelegram(CommandCode::GET_ONLINE_VALUE, {});
+    }
+    ASSERT_TRUE(client->WaitOnIdle());
+
+    const auto value_list = client->OnlineValues();
+    ASSERT_EQ(value_list.size(), 20);
+    EXPECT_EQ(server.NofOnlineRequests(), 10);
+
+    EXPECT_TRUE(client->Stop());
+    server.Stop();
+  }
+}
+
+TEST(MemoryPipe, TestBackpressure)  // NOLINT
+{
+  boost::asio::io_context context;
+  std::unique_ptr<Transport> server_end;
+  ASSERT_TRUE(MemoryPipe::Listen(
+      "asap3_test_backpressure", context.get_executor(),
+      [&](std::unique_ptr<Transport> transport) {
+        server_end = std::move(transport);
+      }));
+  auto client_end = Transport::Create(TransportType::MemoryPipe, context, "",
+                                      0, "asap3_test_backpressure");
+  client_end->AsyncConnect([](const boost::system::error_code& error) {
+    EXPECT_FALSE(error);
+  });
+  // The listener keeps the context busy, so run() doesn't return
+  context.poll();
+  ASSERT_TRUE(server_end);
+
+  // The second write waits until the reader has made room
+  const std::vector<uint8_t> block(48 * 1024, 0xA5);
+  size_t nof_written = 0;
+  boost::system::error_code write_error;
+  auto on_write = [&](const boost::system::error_code& error, size_t) {
+    write_error = error;
+    if (!error) {
+      ++nof_written;
+    }
+  };
+  client_end->AsyncWrite(boost::asio::buffer(block), on_write);
+  context.poll();
+  client_end->AsyncWrite(boost::asio::buffer(block), on_write);
+  context.poll();
+  EXPECT_EQ(nof_written, 1);
+
+  std::vector<uint8_t> input(block.size());
+  server_end->AsyncRead(boost::asio::buffer(input),
+                        [](const boost::system::error_code& error, size_t) {
+                          EXPECT_FALSE(error);
+                        });
+  context.poll();
+  EXPECT_EQ(nof_written, 2);
+  EXPECT_EQ(input, block);
+
+  // A waiting write fails when the reader closes
+  client_end->AsyncWrite(boost::asio::buffer(block), on_write);
+  context.poll();
+  EXPECT_EQ(nof_written, 2);
+  server_end->Close();
+  context.poll();
+  EXPECT_EQ(nof_written, 2);
+  EXPECT_EQ(write_error, boost::asio::error::broken_pipe);
+
+  MemoryPipe::Unlisten("asap3_test_backpressure");
+}
+
+TEST(Asap3Client, TestSocketOptions)  // NOLINT
+{
+  MockServer server;
+  server.CreateParameters(10);
+  ASSERT_TRUE(server.Start());
+
+  A3ParameterList parameter_list;
+  for (size_t index = 0; index < 10; ++index) {
+    A3Parameter parameter;
+    parameter.Name("Par" + std::to_string(index + 1));
+    parameter_list.push_back(parameter);
+  }
+
+  SocketOptions options;
+  EXPECT_TRUE(options.no_delay);
+  options.receive_buffer = 256 * 1024;
+  options.send_buffer = 256 * 1024;
+  options.keep_alive = true;
+  options.keep_alive_idle = std::chrono::seconds(5);
+  options.keep_alive_interval = std::chrono::seconds(1);
+  options.keep_alive_count = 3;
+  options.user_timeout = std::chrono::milliseconds(5000);
+  options.quick_ack = true;
+
+  auto client =
+      Asap3Factory::CreateAsap3Client(Asap3ClientType::BasicAsap3Client);
+  client->Port(server.Port());
+  client->TcpOptions(options);
+  EXPECT_TRUE(client->TcpOptions().quick_ack);
+  client->ParameterList(parameter_list);
+  ASSERT_TRUE(client->Start());
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_TRUE(client->StartSubscription(0));
+  for (size_t poll = 0; poll < 10; ++poll) {
+    client->SendTelegram(CommandCode::GET_ONLINE_VALUE, {});
+  }
+  ASSERT_TRUE(client->WaitOnIdle());
+  EXPECT_EQ(client->OnlineValues().size(), 10);
+  EXPECT_EQ(server.NofOnlineRequests(), 10);
+
+  EXPECT_TRUE(client->Stop());
+  server.Stop();
+}
+
+TEST(CalibrationCache, TestLuns)  // NOLINT
+{
+  CalibrationCache cache;
+  CharacteristicInfo info0;
+  info0.max = 10.0F;
+  CharacteristicInfo info1;
+  info1.max = 20.0F;
+  cache.Info(0, "Map1", info0);
+  cache.Info(1, "Map1", info1);
+  CharacteristicInfo info;
+  ASSERT_TRUE(cache.FindInfo(1, "Map1", info));
+  EXPECT_FLOAT_EQ(info.max, 20.0F);
+  ASSERT_TRUE(cache.FindInfo(0, "Map1", info));
+  EXPECT_FLOAT_EQ(info.max, 10.0F);
+  EXPECT_FALSE(cache.FindInfo(2, "Map1", info));
+
+  EXPECT_FALSE(cache.CurrentPage(0, 0));
+  EXPECT_FALSE(cache.CurrentPage(1, 0));
+  auto map0 = std::make_shared<Characteristic>("Map1", Mc3CharType::MAP,
+                                               std::vector<uint16_t>{2, 2});
+  map0->Values()[0] = 1.0F;
+  auto map1 = std::make_shared<Characteristic>("Map1", Mc3CharType::MAP,
+                                               std::vector<uint16_t>{2, 2});
+  map1->Values()[0] = 2.0F;
+  cache.Value(0, map0, cache.Generation());
+  cache.Value(1, map1, cache.Generation());
+  ASSERT_TRUE(cache.Value(0, "Map1"));
+  ASSERT_TRUE(cache.Value(1, "Map1"));
+  EXPECT_FLOAT_EQ(cache.Value(0, "Map1")->Values()[0], 1.0F);
+  EXPECT_FLOAT_EQ(cache.Value(1, "Map1")->Values()[0], 2.0F);
+
+  // A page switch on one LUN keeps the values of the other
+  EXPECT_TRUE(cache.CurrentPage(1, 1));
+  EXPECT_EQ(cache.CurrentPage(0), 0);
+  EXPECT_EQ(cache.CurrentPage(1), 1);
+  EXPECT_TRUE(cache.Value(0, "Map1"));
+  EXPECT_FALSE(cache.Value(1, "Map1"));
+
+  cache.Invalidate(0, "Map1");
+  EXPECT_FALSE(cache.Value(0, "Map1"));
+}
+
+}  // namespace asap3::test